@@ -59,8 +59,8 @@
 #   See './mkChangelog -h' for help.
 #
 SET(LIBZYPP_MAJOR "12")
-SET(LIBZYPP_COMPATMINOR "0")
-SET(LIBZYPP_MINOR "11")
+SET(LIBZYPP_COMPATMINOR "12")
+SET(LIBZYPP_MINOR "12")
 SET(LIBZYPP_PATCH "0")
 #
 # LAST RELEASED: 12.11.0 (0)
@@ -0,0 +1,133 @@
+#ifndef INCLUDE_BENCHMARK
+#define INCLUDE_BENCHMARK
+#include <time.h>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+
+#include "zypp/base/Function.h"
+#include "zypp/base/String.h"
+#include "zypp/base/Logger.h"
+
+/** Simple benchmark driver producing machine-readable results.
+ *
+ * Each benchmark runs an untimed \c setup action followed by the timed
+ * \c body action, once for warmup and then \c iterations times. The
+ * \c body returns the number of items it processed (solvables loaded,
+ * matches found, ...), or \c 0 if there is no reasonable count.
+ *
+ * Results are written as one JSON object per line to \c stdout or the
+ * file given by \c --output (appending), so they can be collected and
+ * compared across releases:
+ * \code
+ * {"version":"14.1.0","suite":"Pool","name":"PoolQuery/substring","iterations":10,
+ *  "items":1234,"min_ms":1.234,"median_ms":1.301,"mean_ms":1.320,"max_ms":1.512}
+ * \endcode
+ *
+ * Options:
+ * \li \c --iterations N: override the default number of iterations
+ * \li \c --filter STR: run only benchmarks whose name contains STR
+ * \li \c --output FILE: append results to FILE
+ *
+ * \code
+ * int main( int argc, char * argv[] )
+ * {
+ *   Benchmark bench( "Edition", argc, argv );
+ *   bench.run( "compare", 20, &compareEditions );
+ *   return 0;
+ * }
+ * \endcode
+ */
+class Benchmark
+{
+  public:
+    typedef zypp::function<unsigned()> Body;
+    typedef zypp::function<void()>     Setup;
+
+  public:
+    Benchmark( const std::string & suite_r, int argc, char * argv[] )
+    : _suite( suite_r )
+    , _iterations( 0 )
+    , _out( &std::cout )
+    {
+      for ( int i = 1; i < argc; ++i )
+      {
+        std::string arg( argv[i] );
+        if ( i+1 < argc && arg == "--iterations" )
+          _iterations = zypp::str::strtonum<unsigned>( argv[++i] );
+        else if ( i+1 < argc && arg == "--filter" )
+          _filter = argv[++i];
+        else if ( i+1 < argc && arg == "--output" )
+        {
+          _file.open( argv[++i], std::ios_base::out|std::ios_base::app );
+          if ( _file.is_open() )
+            _out = &_file;
+        }
+        else
+          std::cerr << "Usage: " << argv[0] << " [--iterations N] [--filter STR] [--output FILE]" << std::endl;
+      }
+    }
+
+  public:
+    /** Whether benchmark \a name_r is enabled by \c --filter. */
+    bool enabled( const std::string & name_r ) const
+    { return _filter.empty() || name_r.find( _filter ) != std::string::npos; }
+
+    /** Run benchmark \a name_r. */
+    void run( const std::string & name_r, unsigned iterations_r, const Body & body_r, const Setup & setup_r = Setup() )
+    {
+      if ( ! enabled( name_r ) )
+        return;
+      if ( _iterations )
+        iterations_r = _iterations;
+      if ( ! iterations_r )
+        iterations_r = 1;
+
+      unsigned items = 0;
+      std::vector<double> times;
+      times.reserve( iterations_r );
+      for ( unsigned i = 0; i <= iterations_r; ++i )	// i==0 is warmup
+      {
+        if ( setup_r )
+          setup_r();
+        double start = now();
+        items = body_r();
+        double stop = now();
+        if ( i )
+          times.push_back( (stop - start) * 1000.0 );
+      }
+
+      std::sort( times.begin(), times.end() );
+      double sum = 0.0;
+      for ( unsigned i = 0; i < times.size(); ++i )
+        sum += times[i];
+
+      *_out << "{\"version\":\"" << VERSION << "\""
+            << ",\"suite\":\"" << _suite << "\""
+            << ",\"name\":\"" << name_r << "\""
+            << ",\"iterations\":" << times.size()
+            << ",\"items\":" << items
+            << zypp::str::form( ",\"min_ms\":%.3f,\"median_ms\":%.3f,\"mean_ms\":%.3f,\"max_ms\":%.3f",
+                                times.front(), times[times.size()/2], sum/times.size(), times.back() )
+            << "}" << std::endl;
+      MIL << _suite << " " << name_r << " " << items << " items, median " << times[times.size()/2] << "ms" << std::endl;
+    }
+
+  private:
+    static double now()
+    {
+      struct timespec ts;
+      ::clock_gettime( CLOCK_MONOTONIC, &ts );
+      return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+    }
+
+  private:
+    std::string _suite;
+    std::string _filter;
+    unsigned _iterations;
+    std::ofstream _file;
+    std::ostream * _out;
+};
+
+#endif // INCLUDE_BENCHMARK
@@ -0,0 +1,37 @@
+#include <string>
+#include "Benchmark.h"
+
+#include "zypp/base/GzStream.h"
+#include "zypp/base/Exception.h"
+
+using namespace zypp;
+
+///////////////////////////////////////////////////////////////////
+//
+// Reading compressed metadata line by line, as the parsers do, with
+// the old 512 byte buffer and the current default buffer size.
+//
+///////////////////////////////////////////////////////////////////
+
+static const char * metadata = TESTS_SRC_DIR "/data/11.0-update/repodata/primary.xml.gz";
+
+/** Number of lines read from \ref metadata. */
+unsigned readLines( unsigned bufferSize_r )
+{
+  ifgzstream in( metadata, bufferSize_r );
+  if ( ! in.is_open() )
+    ZYPP_THROW( Exception( std::string( "Can't open " ) + metadata ) );
+  unsigned ret = 0;
+  for( std::string line; std::getline( in, line ); )
+    ++ret;
+  return ret;
+}
+
+int main( int argc, char * argv[] )
+{
+  Benchmark bench( "GzStream", argc, argv );
+
+  bench.run( "getline.512", 10, bind( &readLines, 512 ) );
+  bench.run( "getline.default", 10, bind( &readLines, gzstream_detail::fgzstreambuf::defaultBufferSize ) );
+  return 0;
+}
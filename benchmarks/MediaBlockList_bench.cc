@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include "Benchmark.h"
+
+#include "zypp/base/Easy.h"
+#include "zypp/base/Exception.h"
+#include "zypp/Digest.h"
+#include "zypp/TmpPath.h"
+#include "zypp/media/MediaBlockList.h"
+
+using namespace zypp;
+using zypp::media::MediaBlockList;
+
+///////////////////////////////////////////////////////////////////
+//
+// MediaBlockList::reuseBlocks scanning an old file for blocks of
+// a new one (as done by MediaMultiCurl for metalink downloads).
+//
+///////////////////////////////////////////////////////////////////
+
+static const size_t blksize  = 128*1024;
+static const size_t nblocks  = 256;	// 32 MiB
+
+/** Deterministic pseudo random content. */
+void fillBlock( std::vector<unsigned char> & buf_r, unsigned seed_r )
+{
+  unsigned val = seed_r * 2654435761U + 1;
+  for_( it, buf_r.begin(), buf_r.end() )
+  {
+    val = val * 1103515245U + 12345U;
+    *it = val >> 16;
+  }
+}
+
+/** Blocklist describing the new file: blocks seeded 0..nblocks-1. */
+MediaBlockList newBlockList()
+{
+  MediaBlockList bl( blksize * nblocks );
+  std::vector<unsigned char> buf( blksize );
+  for ( size_t blkno = 0; blkno < nblocks; ++blkno )
+  {
+    fillBlock( buf, blkno );
+    bl.addBlock( blkno * blksize, blksize );
+
+    Digest dig;
+    dig.create( Digest::sha1() );
+    dig.update( (const char *)&buf[0], buf.size() );
+    std::vector<unsigned char> sum( dig.digestVector() );
+    bl.setChecksum( blkno, "SHA1", sum.size(), &sum[0] );
+    bl.setRsum( blkno, 4, bl.updateRsum( 0, (const char *)&buf[0], buf.size() ) );
+  }
+  return bl;
+}
+
+/** The old file: every 2nd block is unchanged, the others differ; shifted by 17 bytes. */
+void writeOldFile( const Pathname & file_r )
+{
+  FILE * fp = ::fopen( file_r.c_str(), "w" );
+  if ( ! fp )
+    ZYPP_THROW( Exception( "Can't create " + file_r.asString() ) );
+  std::vector<unsigned char> buf( blksize );
+  ::fwrite( "0123456789abcdef\n", 17, 1, fp );
+  for ( size_t blkno = 0; blkno < nblocks; ++blkno )
+  {
+    fillBlock( buf, blkno % 2 ? blkno : nblocks + blkno );
+    ::fwrite( &buf[0], buf.size(), 1, fp );
+  }
+  ::fclose( fp );
+}
+
+unsigned reuseBlocks( const Pathname & oldFile_r, const Pathname & newFile_r )
+{
+  MediaBlockList bl( newBlockList() );
+  FILE * fp = ::fopen( newFile_r.c_str(), "w" );
+  if ( ! fp )
+    return 0;
+  bl.reuseBlocks( fp, oldFile_r.asString() );
+  ::fclose( fp );
+  return nblocks;
+}
+
+int main( int argc, char * argv[] )
+{
+  Benchmark bench( "MediaBlockList", argc, argv );
+
+  filesystem::TmpDir tmp;
+  Pathname oldFile( tmp.path()/"old" );
+  Pathname newFile( tmp.path()/"new" );
+  writeOldFile( oldFile );
+
+  bench.run( "reuseBlocks", 5, bind( &reuseBlocks, oldFile, newFile ) );
+  return 0;
+}
@@ -0,0 +1,202 @@
+#define INCLUDE_TESTSETUP_WITHOUT_BOOST
+#include "TestSetup.h"
+#include "Benchmark.h"
+
+#include "zypp/PoolQuery.h"
+#include "zypp/DiskUsageCounter.h"
+#include "zypp/sat/Pool.h"
+#include "zypp/sat/SolvableColumns.h"
+
+///////////////////////////////////////////////////////////////////
+//
+// sat::Pool, ResPool and ResPoolProxy setup and queries on the
+// openSUSE-11.1 fixture (plus OBS_zypp_svn-11.1 and a faked @System
+// from obs_virtualbox_11_1).
+//
+///////////////////////////////////////////////////////////////////
+
+static TestSetup test( Arch_x86_64 );
+
+/** The solv files built from the fixtures: alias => solv file */
+typedef std::vector<std::pair<std::string,Pathname> > SolvFiles;
+static SolvFiles solvFiles;
+
+/** Build the fixtures solv files once. */
+void buildSolvFiles()
+{
+  test.loadTargetRepo( TESTS_SRC_DIR "/data/obs_virtualbox_11_1" );
+  test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "opensuse" );
+  test.loadRepo( TESTS_SRC_DIR "/data/OBS_zypp_svn-11.1", "zyppsvn" );
+
+  Pathname solvCachePath( RepoManagerOptions::makeTestSetup( test.root() ).repoSolvCachePath );
+  solvFiles.push_back( std::make_pair( sat::Pool::systemRepoAlias(), solvCachePath/sat::Pool::systemRepoAlias()/"solv" ) );
+  solvFiles.push_back( std::make_pair( std::string("opensuse"), solvCachePath/"opensuse"/"solv" ) );
+  solvFiles.push_back( std::make_pair( std::string("zyppsvn"), solvCachePath/"zyppsvn"/"solv" ) );
+}
+
+/** Remove all repos from the pool. */
+void clearPool()
+{
+  sat::Pool satpool( test.satpool() );
+  while ( ! satpool.reposEmpty() )
+    satpool.reposBegin()->eraseFromPool();
+}
+
+/** Load all solv files into an empty pool. */
+unsigned loadSolvFiles()
+{
+  sat::Pool satpool( test.satpool() );
+  for_( it, solvFiles.begin(), solvFiles.end() )
+  {
+    RepoInfo nrepo;
+    nrepo.setAlias( it->first );
+    satpool.addRepoSolv( it->second, nrepo );
+  }
+  return satpool.solvablesSize();
+}
+
+/** Fresh pool, but housekeeping data not yet built. */
+void reloadPool()
+{
+  clearPool();
+  loadSolvFiles();
+}
+
+unsigned buildStore()
+{
+  ResPool pool( test.pool() );
+  return std::distance( pool.begin(), pool.end() );
+}
+
+unsigned buildProxy()
+{
+  return test.poolProxy().size();
+}
+
+unsigned poolQuery( PoolQuery query_r )
+{
+  return std::distance( query_r.begin(), query_r.end() );
+}
+
+unsigned sortEditions( bool ranked_r )
+{
+  std::vector<Edition> editions;
+  for_( it, test.satpool().solvablesBegin(), test.satpool().solvablesEnd() )
+    editions.push_back( it->edition() );
+
+  if ( ranked_r )
+  {
+    sat::Pool satpool( test.satpool() );
+    std::sort( editions.begin(), editions.end(),
+               [&satpool]( const Edition & lhs, const Edition & rhs ) { return satpool.compareEdition( lhs, rhs ) < 0; } );
+  }
+  else
+    std::sort( editions.begin(), editions.end() );	// Edition::compare
+  return editions.size();
+}
+
+unsigned diskUsage()
+{
+  DiskUsageCounter ducounter( DiskUsageCounter::justRootPartition() );
+  unsigned count = 0;
+  for_( it, test.satpool().solvablesBegin(), test.satpool().solvablesEnd() )
+  {
+    ducounter.disk_usage( *it );
+    ++count;
+  }
+  return count;
+}
+
+/** The package table columns of a typical frontend. */
+std::vector<sat::SolvAttr> tableAttrs()
+{
+  std::vector<sat::SolvAttr> attrs;
+  attrs.push_back( sat::SolvAttr::summary );
+  attrs.push_back( sat::SolvAttr::vendor );
+  attrs.push_back( sat::SolvAttr::downloadsize );
+  attrs.push_back( sat::SolvAttr::installsize );
+  attrs.push_back( sat::SolvAttr::buildtime );
+  return attrs;
+}
+
+unsigned tableLookup()
+{
+  std::vector<sat::SolvAttr> attrs( tableAttrs() );
+  unsigned count = 0;
+  for_( it, test.satpool().solvablesBegin(), test.satpool().solvablesEnd() )
+  {
+    it->lookupStrAttribute( attrs[0] );
+    it->lookupStrAttribute( attrs[1] );
+    it->lookupNumAttribute( attrs[2] );
+    it->lookupNumAttribute( attrs[3] );
+    it->lookupNumAttribute( attrs[4] );
+    ++count;
+  }
+  return count;
+}
+
+unsigned tableColumns()
+{
+  sat::SolvableColumns table( test.satpool().solvablesBegin(), test.satpool().solvablesEnd(), tableAttrs() );
+  return table.size();
+}
+
+int main( int argc, char * argv[] )
+{
+  Benchmark bench( "Pool", argc, argv );
+  buildSolvFiles();
+
+  bench.run( "addRepoSolv", 10, &loadSolvFiles, &clearPool );
+  bench.run( "ResPool/store", 10, &buildStore, &reloadPool );
+  bench.run( "ResPoolProxy", 10, &buildProxy, []() { reloadPool(); buildStore(); } );
+
+  // queries on a prepared pool
+  reloadPool();
+  buildProxy();
+  {
+    PoolQuery q;
+    q.addAttribute( sat::SolvAttr::name, "kde" );
+    q.setMatchSubstring();
+    bench.run( "PoolQuery/substring", 20, bind( &poolQuery, q ) );
+  }
+  {
+    PoolQuery q;
+    q.addAttribute( sat::SolvAttr::name, "kde*" );
+    q.setMatchGlob();
+    bench.run( "PoolQuery/glob", 20, bind( &poolQuery, q ) );
+  }
+  {
+    PoolQuery q;
+    q.addAttribute( sat::SolvAttr::name, "^kde.*-devel$" );
+    q.setMatchRegex();
+    bench.run( "PoolQuery/regex", 20, bind( &poolQuery, q ) );
+  }
+  {
+    PoolQuery q;
+    q.addAttribute( sat::SolvAttr::name, "zypper" );
+    q.setMatchExact();
+    bench.run( "PoolQuery/exact", 20, bind( &poolQuery, q ) );
+  }
+  {
+    PoolQuery q;
+    q.addString( "editor" );
+    q.addAttribute( sat::SolvAttr::summary );
+    q.addAttribute( sat::SolvAttr::description );
+    q.setMatchWord();
+    bench.run( "PoolQuery/word", 10, bind( &poolQuery, q ) );
+  }
+  {
+    PoolQuery q;
+    q.addAttribute( sat::SolvAttr::filelist, "/usr/bin/zypper" );
+    q.setMatchExact();
+    q.setFilesMatchFullPath();
+    bench.run( "PoolQuery/filelist", 10, bind( &poolQuery, q ) );
+  }
+
+  bench.run( "Edition/sort", 10, bind( &sortEditions, false ) );
+  bench.run( "Edition/sortRanked", 10, bind( &sortEditions, true ) );
+  bench.run( "DiskUsageCounter", 5, &diskUsage );
+  bench.run( "Table/lookup", 10, &tableLookup );
+  bench.run( "Table/columns", 10, &tableColumns );
+  return 0;
+}
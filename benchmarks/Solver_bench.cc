@@ -0,0 +1,113 @@
+#define INCLUDE_TESTSETUP_WITHOUT_BOOST
+#include "TestSetup.h"
+#include "Benchmark.h"
+
+#include "zypp/ResPool.h"
+#include "zypp/Package.h"
+#include "zypp/sat/Transaction.h"
+
+///////////////////////////////////////////////////////////////////
+//
+// SATResolver solving and sat::Transaction ordering.
+//
+// Usage: Solver_bench [TESTCASE_DIR] [options]
+//
+// Without a testcase dir, an install of some packages from the
+// openSUSE-11.1 fixture on top of a faked @System (obs_virtualbox_11_1)
+// is solved. With a (helix) solver testcase dir (e.g. tests/data/TCdup),
+// a dist upgrade of the testcase is solved.
+//
+///////////////////////////////////////////////////////////////////
+
+static TestSetup test( Arch_x86_64 );
+
+/** Items to install (if not using a testcase). */
+static std::vector<PoolItem> toInstall;
+
+void resetPool()
+{
+  for_( it, test.pool().begin(), test.pool().end() )
+    it->statusReset();
+}
+
+void setupInstall()
+{
+  resetPool();
+  for_( it, toInstall.begin(), toInstall.end() )
+    it->status().setToBeInstalled( ResStatus::USER );
+}
+
+unsigned countTransacting()
+{
+  unsigned count = 0;
+  for_( it, test.pool().begin(), test.pool().end() )
+  {
+    if ( it->status().transacts() )
+      ++count;
+  }
+  return count;
+}
+
+unsigned solveInstall()
+{
+  if ( ! test.resolver().resolvePool() )
+    WAR << "Install has problems" << endl;
+  return countTransacting();
+}
+
+unsigned solveUpgrade()
+{
+  if ( ! test.resolver().doUpgrade() )
+    WAR << "Upgrade has problems" << endl;
+  return countTransacting();
+}
+
+unsigned orderTransaction()
+{
+  sat::Transaction trans( sat::Transaction::Default() );
+  trans.order();
+  return trans.size();
+}
+
+int main( int argc, char * argv[] )
+{
+  Pathname testcase;
+  if ( argc > 1 && *argv[1] != '-' )
+  {
+    testcase = argv[1];
+    // drop the testcase arg, but keep the program name for Benchmarks usage message
+    char * progname = argv[0];
+    --argc;
+    ++argv;
+    argv[0] = progname;
+  }
+  Benchmark bench( "Solver", argc, argv );
+
+  if ( ! testcase.empty() )
+  {
+    test.loadTestcaseRepos( testcase );
+    std::string name( testcase.basename() );
+
+    bench.run( "upgrade/"+name, 5, &solveUpgrade, &resetPool );
+    bench.run( "Transaction/order/"+name, 5, &orderTransaction );
+    return 0;
+  }
+
+  test.loadTargetRepo( TESTS_SRC_DIR "/data/obs_virtualbox_11_1" );
+  test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "opensuse" );
+
+  // pick a deterministic set of packages not yet installed
+  for_( it, test.pool().byKindBegin<Package>(), test.pool().byKindEnd<Package>() )
+  {
+    if ( it->status().isInstalled() )
+      continue;
+    if ( it->satSolvable().ident().asString().find( "kde" ) != std::string::npos )
+      toInstall.push_back( *it );
+    if ( toInstall.size() == 50 )
+      break;
+  }
+
+  bench.run( "install/opensuse", 5, &solveInstall, &setupInstall );
+  bench.run( "Transaction/order/opensuse", 5, &orderTransaction );
+  return 0;
+}
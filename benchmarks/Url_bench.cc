@@ -0,0 +1,92 @@
+#include <fstream>
+#include "Benchmark.h"
+
+#include "zypp/base/Easy.h"
+#include "zypp/base/Regex.h"
+#include "zypp/base/Exception.h"
+#include "zypp/Url.h"
+
+using namespace zypp;
+
+///////////////////////////////////////////////////////////////////
+//
+// Url parsing and validation on the urls used in tests/zypp/Url_test.cc,
+// compared to the regex matching formerly done for each url.
+//
+///////////////////////////////////////////////////////////////////
+
+static const unsigned rounds = 200;	// passes over the corpus per iteration
+
+typedef std::vector<std::string> Corpus;
+
+/** The quoted "scheme:..." strings in Url_test.cc. */
+Corpus readCorpus()
+{
+  Corpus ret;
+  str::regex rx( "\"([a-zA-Z][a-zA-Z0-9.+-]*:[^\"]*)\"" );
+  std::ifstream infile( TESTS_SRC_DIR "/zypp/Url_test.cc" );
+  for( std::string line; std::getline( infile, line ); )
+  {
+    str::smatch what;
+    if ( str::regex_match( line, what, rx ) )	// not anchored: first match per line
+      ret.push_back( what[1] );
+  }
+  if ( ret.empty() )
+    ZYPP_THROW( Exception( "No urls found in " TESTS_SRC_DIR "/zypp/Url_test.cc" ) );
+  return ret;
+}
+
+/** Parse (and validate) each url. */
+unsigned parseUrls( const Corpus & corpus_r )
+{
+  unsigned ret = 0;
+  for ( unsigned i = 0; i < rounds; ++i )
+    for_( it, corpus_r.begin(), corpus_r.end() )
+    {
+      try
+      {
+        Url url( *it );
+        if ( url.isValid() )
+          ++ret;
+      }
+      catch ( const Exception & )
+      {}
+    }
+  return ret;
+}
+
+/** What Url used to do for each url: compile and match the split regex,
+ * and compile and match a component regex for scheme, host and path.
+ */
+unsigned regexUrls( const Corpus & corpus_r )
+{
+  unsigned ret = 0;
+  for ( unsigned i = 0; i < rounds; ++i )
+    for_( it, corpus_r.begin(), corpus_r.end() )
+    {
+      str::smatch out;
+      str::regex split( "^([^:/?#]+:|)(//[^/?#]*|)([^?#]*)([?][^#]*|)(#.*|)" );
+      if ( ! str::regex_match( *it, out, split ) )
+        continue;
+      str::regex scheme( "^[a-zA-Z][a-zA-Z0-9\\.+-]*$" );
+      str::regex host( "^[[:alnum:]]+([\\.-][[:alnum:]]+)*$" );
+      str::regex path( "^([a-zA-Z0-9!$&'\\(\\)*+=,:@/~\\._-]|%[a-fA-F0-9]{2})+$" );
+      std::string s( out[1] );
+      std::string a( out[2] );
+      if ( str::regex_match( s.substr( 0, s.size()-1 ), scheme )
+           && ( a.size() <= 2 || str::regex_match( a.substr( 2 ), host ) )
+           && str::regex_match( std::string( out[3] ), path ) )
+        ++ret;
+    }
+  return ret;
+}
+
+int main( int argc, char * argv[] )
+{
+  Benchmark bench( "Url", argc, argv );
+
+  Corpus corpus( readCorpus() );
+  bench.run( "parse", 10, bind( &parseUrls, corpus ) );
+  bench.run( "parse.regex", 10, bind( &regexUrls, corpus ) );
+  return 0;
+}
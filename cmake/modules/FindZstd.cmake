@@ -0,0 +1,18 @@
+
+SET( ZSTD_LIBRARY )
+SET( ZSTD_INCLUDE_DIR )
+
+FIND_PATH( ZSTD_INCLUDE_DIR zstd.h
+	/usr/include
+	/usr/local/include
+)
+
+FIND_LIBRARY( ZSTD_LIBRARY NAMES zstd
+	PATHS
+	/usr/lib
+	/usr/local/lib
+)
+
+INCLUDE( FindPackageHandleStandardArgs )
+FIND_PACKAGE_HANDLE_STANDARD_ARGS( Zstd DEFAULT_MSG ZSTD_LIBRARY ZSTD_INCLUDE_DIR )
+MARK_AS_ADVANCED( ZSTD_LIBRARY ZSTD_INCLUDE_DIR )
@@ -40,7 +40,7 @@ Provides:       libzypp(plugin:urlresolver) = 0
 
 %if 0%{?suse_version}
 Recommends:     logrotate
-# lsof is used for 'zypper ps':
+# lsof is used for 'zypper ps' if /proc is not available:
 Recommends:     lsof
 %endif
 BuildRequires:  cmake
@@ -62,6 +62,8 @@ BuildRequires:  gcc-c++ >= 4.6
 BuildRequires:  gettext-devel
 BuildRequires:  graphviz
 BuildRequires:  libxml2-devel
+BuildRequires:  xz-devel
+BuildRequires:  libzstd-devel
 %if 0%{?suse_version} != 1110
 # No libproxy on SLES
 BuildRequires:  libproxy-devel
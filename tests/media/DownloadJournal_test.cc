@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <boost/test/auto_unit_test.hpp>
+
+#include "zypp/base/Easy.h"
+#include "zypp/base/String.h"
+#include "zypp/Digest.h"
+#include "zypp/PathInfo.h"
+#include "zypp/TmpPath.h"
+#include "zypp/media/DownloadJournal.h"
+#include "zypp/media/MediaManager.h"
+
+#include "WebServer.h"
+
+using std::cout;
+using std::endl;
+using namespace zypp;
+using namespace zypp::media;
+
+BOOST_AUTO_TEST_CASE(journal)
+{
+  filesystem::TmpDir tmp;
+  std::string key( "http://download.example.com/repo/file.rpm" );
+  Pathname dir( tmp.path() / "partial" );
+  Pathname tmpfile( tmp.path() / "file.rpm.new" );
+  {
+    std::ofstream out( tmpfile.c_str() );
+    out << "partial" << endl;
+  }
+
+  DownloadJournal journal( key, dir );
+  BOOST_CHECK_EQUAL( journal.partFile(), dir / ( Digest::digest( Digest::sha1(), key ) + ".part.zypp" ) );
+  BOOST_CHECK( ! journal.load() );
+
+  BOOST_REQUIRE( journal.start( tmpfile ) );
+  BOOST_CHECK( PathInfo( journal.partFile() ).isFile() );
+  journal.setUrl( key );
+  journal.setValidator( "Tue, 15 Nov 1994 12:45:26 GMT" );
+  journal.addBlock( MediaBlock( 0, 4096 ) );
+  BOOST_CHECK( journal.save() );
+
+  DownloadJournal loaded( key, dir );
+  BOOST_REQUIRE( loaded.load() );
+  BOOST_CHECK_EQUAL( loaded.url(), journal.url() );
+  BOOST_CHECK_EQUAL( loaded.validator(), journal.validator() );
+  BOOST_REQUIRE_EQUAL( loaded.blocks().size(), 1 );
+  BOOST_CHECK_EQUAL( loaded.blocks()[0].size, 4096 );
+
+  // the data are gone
+  filesystem::unlink( loaded.partFile() );
+  BOOST_CHECK( ! DownloadJournal( key, dir ).load() );
+
+  loaded.remove();
+  BOOST_CHECK( ! PathInfo( loaded.journalFile() ).isExist() );
+  BOOST_CHECK( PathInfo( tmpfile ).isFile() );
+}
+
+BOOST_AUTO_TEST_CASE(reuse_journaled_blocks)
+{
+  static const size_t blksize = 4096;
+  filesystem::TmpDir tmp;
+  Pathname partial( tmp.path() / "partial" );
+  Pathname newfile( tmp.path() / "new" );
+
+  // block 0 and 2 downloaded, block 1 not yet
+  std::vector<char> data( 3 * blksize );
+  for ( size_t i = 0; i < data.size(); ++i )
+    data[i] = char( i * 7 + i / blksize );
+  MediaBlockList bl( data.size() );
+  for ( size_t blkno = 0; blkno < 3; ++blkno )
+  {
+    bl.addBlock( blkno * blksize, blksize );
+    Digest dig;
+    dig.create( Digest::sha1() );
+    dig.update( &data[blkno * blksize], blksize );
+    std::vector<unsigned char> sum( dig.digestVector() );
+    bl.setChecksum( blkno, "SHA1", sum.size(), &sum[0] );
+  }
+  {
+    std::vector<char> part( data );
+    std::fill( part.begin() + blksize, part.begin() + 2 * blksize, 0 );
+    FILE * fp = ::fopen( partial.c_str(), "w" );
+    ::fwrite( &part[0], part.size(), 1, fp );
+    ::fclose( fp );
+  }
+
+  std::vector<MediaBlock> verified;
+  verified.push_back( MediaBlock( 2 * blksize, blksize ) );
+  verified.push_back( MediaBlock( 0, blksize ) );
+  verified.push_back( MediaBlock( blksize, blksize ) );	// bad journal entry
+
+  FILE * fp = ::fopen( newfile.c_str(), "w+" );
+  bl.reuseBlocks( fp, partial.asString(), verified );
+  ::fclose( fp );
+
+  // only block 1 is left to download
+  BOOST_REQUIRE_EQUAL( bl.numBlocks(), 1 );
+  BOOST_CHECK_EQUAL( bl.getBlock( 0 ).off, off_t(blksize) );
+}
+
+BOOST_AUTO_TEST_CASE(resume_from_second_handler)
+{
+  // the journal lives in the repo cache, not in the handlers attach point
+  filesystem::TmpDir tmp;
+  Pathname zyppconf( tmp.path() / "zypp.conf" );
+  {
+    std::ofstream out( zyppconf.c_str() );
+    out << "[main]" << endl;
+    out << "cachedir = " << tmp.path() / "cache" << endl;
+  }
+  ::setenv( "ZYPP_CONF", zyppconf.c_str(), 1 );
+  BOOST_REQUIRE_EQUAL( DownloadJournal::defaultDir(), tmp.path() / "cache" / "partial" );
+
+  Pathname docroot( tmp.path() / "docroot" );
+  filesystem::assert_dir( docroot );
+  std::string data;
+  for ( unsigned i = 0; i < 100000; ++i )
+    data += char( 'a' + i % 26 );
+  {
+    std::ofstream out( (docroot / "file.dat").c_str() );
+    out << data;
+  }
+  PathInfo served( docroot / "file.dat" );
+
+  WebServer web( docroot, 10003 );
+  web.start();
+  Url url( web.url() );
+  url.setPathName( "/file.dat" );
+
+  // What an interrupted handler left: the first half, validated by the
+  // (strong) ETag the server sends. The prefix is altered, so we can
+  // tell it was reused.
+  std::string prefix( data.size() / 2, 'X' );
+  {
+    DownloadJournal journal( url.asString() );
+    Pathname tmpfile( tmp.path() / "interrupted" );
+    {
+      std::ofstream out( tmpfile.c_str() );
+      out << prefix;
+    }
+    BOOST_REQUIRE( journal.start( tmpfile ) );
+    journal.setUrl( url.asString() );
+    journal.setValidator( str::form( "\"%lx.%lx\"", (unsigned long)served.mtime(), (unsigned long)served.size() ) );
+    BOOST_REQUIRE( journal.keep() );
+    filesystem::unlink( tmpfile );
+  }
+
+  media::MediaManager mm;
+  media::MediaAccessId id = mm.open( web.url() );
+  mm.attach( id );
+  mm.provideFile( id, "/file.dat" );
+  std::string got;
+  {
+    std::ifstream in( mm.localPath( id, "/file.dat" ).c_str() );
+    got.assign( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() );
+  }
+  mm.close( id );
+  web.stop();
+
+  BOOST_CHECK_EQUAL( got.size(), data.size() );
+  BOOST_CHECK( got == prefix + data.substr( prefix.size() ) );
+  BOOST_CHECK( ! DownloadJournal( url.asString() ).load() );
+}
@@ -0,0 +1,102 @@
+#include <iostream>
+#include <fstream>
+#include <boost/test/auto_unit_test.hpp>
+
+#include "zypp/base/Easy.h"
+#include "zypp/TmpPath.h"
+#include "zypp/media/MirrorScoreboard.h"
+
+using std::cout;
+using std::endl;
+using namespace zypp;
+using namespace zypp::media;
+
+static std::vector<Url> mirrors()
+{
+  std::vector<Url> urls;
+  urls.push_back( Url( "http://unknown.org/repo/file" ) );
+  urls.push_back( Url( "http://slow.org/repo/file" ) );
+  urls.push_back( Url( "http://broken.org/repo/file" ) );
+  urls.push_back( Url( "http://fast.org/repo/file" ) );
+  return urls;
+}
+
+BOOST_AUTO_TEST_CASE(order)
+{
+  MirrorScoreboard board;
+  board.success( "slow.org", 10000, 0.2 );
+  board.success( "fast.org", 1000000, 0.1 );
+  board.failure( "broken.org" );
+  board.failure( "broken.org" );
+
+  std::vector<Url> urls( mirrors() );
+  board.order( urls, 131072, 2 );
+  BOOST_REQUIRE_EQUAL( urls.size(), 3 );
+  BOOST_CHECK_EQUAL( urls[0].getHost(), "fast.org" );
+  BOOST_CHECK_EQUAL( urls[1].getHost(), "slow.org" );
+  BOOST_CHECK_EQUAL( urls[2].getHost(), "unknown.org" );
+
+  // not enough alternatives: failing hosts are kept at the end
+  urls = mirrors();
+  board.order( urls, 131072, 4 );
+  BOOST_REQUIRE_EQUAL( urls.size(), 4 );
+  BOOST_CHECK_EQUAL( urls[3].getHost(), "broken.org" );
+
+  urls = mirrors();
+  board.order( urls, 131072, 1, 1 );
+  BOOST_REQUIRE_EQUAL( urls.size(), 1 );
+  BOOST_CHECK_EQUAL( urls[0].getHost(), "fast.org" );
+}
+
+BOOST_AUTO_TEST_CASE(recovery)
+{
+  MirrorScoreboard board;
+  board.failure( "flaky.org" );
+  board.failure( "flaky.org" );
+  BOOST_CHECK( board.score( "flaky.org" ).failures >= MirrorScoreboard::failureLimit );
+
+  // a successful download lets the host back in
+  board.success( "flaky.org", 100000, 0.1 );
+  BOOST_CHECK( board.score( "flaky.org" ).failures < MirrorScoreboard::failureLimit );
+
+  std::vector<Url> urls( mirrors() );
+  urls.push_back( Url( "http://flaky.org/repo/file" ) );
+  board.order( urls, 131072, 1 );
+  BOOST_REQUIRE_EQUAL( urls.size(), 5 );
+  BOOST_CHECK_EQUAL( urls[0].getHost(), "flaky.org" );
+}
+
+BOOST_AUTO_TEST_CASE(persistence)
+{
+  filesystem::TmpDir tmp;
+  Pathname file( tmp.path() / "MirrorScoreboard" );
+  time_t now = ::time( 0 );
+  {
+    std::ofstream out( file.c_str() );
+    out << "# host speed latency failures stamp" << endl;
+    out << "old.org 5000 0.1 0 " << now - MirrorScoreboard::maxAge - 10 << endl;
+    out << "decayed.org 5000 0.1 4 " << now - 2 * MirrorScoreboard::halfLife << endl;
+    out << "malformed.org 5000" << endl;
+  }
+  {
+    MirrorScoreboard board( file );
+    BOOST_CHECK_EQUAL( board.size(), 1 );
+    BOOST_CHECK_CLOSE( board.score( "decayed.org" ).failures, 1.0, 1.0 );
+    board.success( "fast.org", 1000000, 0.1 );
+
+    // written by another process meanwhile
+    std::ofstream out( file.c_str(), std::ios_base::app );
+    out << "other.org 2000 0.5 0 " << now << endl;
+    out.close();
+
+    BOOST_CHECK( board.save() );
+    BOOST_CHECK( ! board.save() );	// nothing changed
+  }
+  {
+    MirrorScoreboard board( file );
+    BOOST_CHECK_EQUAL( board.size(), 3 );
+    BOOST_CHECK_EQUAL( board.speed( "fast.org" ), 1000000 );
+    BOOST_CHECK_EQUAL( board.speed( "other.org" ), 2000 );
+    BOOST_CHECK_EQUAL( board.speed( "old.org" ), 0 );
+  }
+}
@@ -0,0 +1,107 @@
+#include <utime.h>
+#include <iostream>
+#include <fstream>
+#include <boost/test/auto_unit_test.hpp>
+
+#include "zypp/PathInfo.h"
+#include "zypp/TmpPath.h"
+#include "zypp/repo/SharedPackageCache.h"
+
+using std::cout;
+using std::endl;
+using namespace zypp;
+using namespace zypp::repo;
+
+/** Write a 1000 byte file filled with \a c_r and return its checksum. */
+CheckSum writePackage( const Pathname & file_r, char c_r )
+{
+  filesystem::assert_dir( file_r.dirname() );
+  {
+    std::ofstream out( file_r.c_str() );
+    out << std::string( 1000, c_r );
+  }
+  std::ifstream in( file_r.c_str() );
+  return CheckSum( CheckSum::sha1Type(), in );
+}
+
+/** Pretend \a path_r was last used \a secs_r seconds ago. */
+void age( const Pathname & path_r, time_t secs_r )
+{
+  struct utimbuf times;
+  times.actime = times.modtime = ::time( 0 ) - secs_r;
+  ::utime( path_r.c_str(), &times );
+}
+
+BOOST_AUTO_TEST_CASE(provide_and_insert)
+{
+  filesystem::TmpDir tmp;
+  SharedPackageCache cache( tmp.path() / "store", 0 );
+  CheckSum sum( writePackage( tmp.path() / "repo1" / "a.rpm", 'a' ) );
+  Pathname dest( tmp.path() / "repo2" / "a.rpm" );
+
+  BOOST_CHECK( ! cache.provide( sum, dest ) );
+  BOOST_CHECK( cache.insert( sum, tmp.path() / "repo1" / "a.rpm" ) );
+  BOOST_CHECK( PathInfo( cache.entryPath( sum ) ).isFile() );
+  BOOST_CHECK_EQUAL( cache.size(), 1000 );
+  BOOST_CHECK( cache.insert( sum, tmp.path() / "repo1" / "a.rpm" ) );	// already there
+  BOOST_CHECK_EQUAL( cache.size(), 1000 );
+
+  // hit is a hardlink replacing an existing file
+  writePackage( dest, 'x' );
+  BOOST_CHECK( cache.provide( sum, dest ) );
+  BOOST_CHECK_EQUAL( PathInfo( dest ).ino(), PathInfo( cache.entryPath( sum ) ).ino() );
+  std::ifstream in( dest.c_str() );
+  BOOST_CHECK( CheckSum( CheckSum::sha1Type(), in ) == sum );
+
+  // checksums are used as path names
+  BOOST_CHECK( cache.entryPath( CheckSum( "foo", "../../etc" ) ).empty() );
+  BOOST_CHECK( ! cache.insert( CheckSum( "foo", "../../etc" ), dest ) );
+
+  // an other process sees the entry
+  SharedPackageCache other( tmp.path() / "store", 0 );
+  BOOST_CHECK_EQUAL( other.size(), 1000 );
+}
+
+BOOST_AUTO_TEST_CASE(evict_lru)
+{
+  filesystem::TmpDir tmp;
+  SharedPackageCache cache( tmp.path() / "store", 2500 );
+  CheckSum a( writePackage( tmp.path() / "repo" / "a.rpm", 'a' ) );
+  CheckSum b( writePackage( tmp.path() / "repo" / "b.rpm", 'b' ) );
+  CheckSum c( writePackage( tmp.path() / "repo" / "c.rpm", 'c' ) );
+
+  BOOST_CHECK( cache.insert( a, tmp.path() / "repo" / "a.rpm" ) );
+  BOOST_CHECK( cache.insert( b, tmp.path() / "repo" / "b.rpm" ) );
+  age( cache.entryPath( a ), 120 );
+  age( cache.entryPath( b ), 60 );
+  // using 'a' makes 'b' the least recently used one
+  BOOST_CHECK( cache.provide( a, tmp.path() / "chroot" / "a.rpm" ) );
+
+  BOOST_CHECK( cache.insert( c, tmp.path() / "repo" / "c.rpm" ) );
+  BOOST_CHECK_EQUAL( cache.size(), 2000 );
+  BOOST_CHECK( PathInfo( cache.entryPath( a ) ).isFile() );
+  BOOST_CHECK( ! PathInfo( cache.entryPath( b ) ).isExist() );
+  BOOST_CHECK( PathInfo( cache.entryPath( c ) ).isFile() );
+  // the per repo file is not affected
+  BOOST_CHECK( PathInfo( tmp.path() / "repo" / "b.rpm" ).isFile() );
+}
+
+BOOST_AUTO_TEST_CASE(insert_existing_is_used)
+{
+  filesystem::TmpDir tmp;
+  SharedPackageCache cache( tmp.path() / "store", 2500 );
+  CheckSum a( writePackage( tmp.path() / "repo" / "a.rpm", 'a' ) );
+  CheckSum b( writePackage( tmp.path() / "repo" / "b.rpm", 'b' ) );
+  CheckSum c( writePackage( tmp.path() / "repo" / "c.rpm", 'c' ) );
+
+  BOOST_CHECK( cache.insert( a, tmp.path() / "repo" / "a.rpm" ) );
+  BOOST_CHECK( cache.insert( b, tmp.path() / "repo" / "b.rpm" ) );
+  age( cache.entryPath( a ), 120 );
+  age( cache.entryPath( b ), 60 );
+  // a repo downloading 'a' again makes 'b' the least recently used one
+  BOOST_CHECK( cache.insert( a, tmp.path() / "repo" / "a.rpm" ) );
+
+  BOOST_CHECK( cache.insert( c, tmp.path() / "repo" / "c.rpm" ) );
+  BOOST_CHECK( PathInfo( cache.entryPath( a ) ).isFile() );
+  BOOST_CHECK( ! PathInfo( cache.entryPath( b ) ).isExist() );
+}
@@ -0,0 +1,59 @@
+#include "TestSetup.h"
+#include "zypp/Package.h"
+#include "zypp/repo/yum/SolvBuilder.h"
+
+using repo::yum::SolvBuilder;
+
+unsigned countKind( const Repository & repo_r, const ResKind & kind_r )
+{
+  unsigned ret = 0;
+  for_( it, repo_r.solvablesBegin(), repo_r.solvablesEnd() )
+    if ( it->isKind( kind_r ) )
+      ++ret;
+  return ret;
+}
+
+BOOST_AUTO_TEST_CASE(primary_updateinfo_deltainfo)
+{
+  filesystem::TmpDir tmp;
+  SolvBuilder builder( TESTS_SRC_DIR "/data/11.0-update" );
+  BOOST_REQUIRE( builder.supported() );
+  builder.build( tmp.path() / "solv" );
+
+  TestSetup test( Arch_x86_64 );
+  test.loadRepo( tmp.path() / "solv", "update" );
+  Repository repo( test.satpool().reposFind( "update" ) );
+  BOOST_REQUIRE( repo );
+  BOOST_CHECK( countKind( repo, ResKind::package ) );
+  BOOST_CHECK_EQUAL( countKind( repo, ResKind::patch ), 164 );
+}
+
+BOOST_AUTO_TEST_CASE(susedata_suseinfo)
+{
+  filesystem::TmpDir tmp;
+  SolvBuilder builder( TESTS_SRC_DIR "/repo/yum/data/extensions" );
+  BOOST_REQUIRE( builder.supported() );	// filelists and other are not used
+  builder.build( tmp.path() / "solv" );
+
+  TestSetup test( Arch_x86_64 );
+  test.loadRepo( tmp.path() / "solv", "updates" );
+  Repository repo( test.satpool().reposFind( "updates" ) );
+  BOOST_REQUIRE( repo );
+  BOOST_CHECK_EQUAL( repo.generatedTimestamp(), Date(1227279057) );
+  BOOST_CHECK_EQUAL( repo.suggestedExpirationTimestamp(), Date(1227279057 + 3600) );
+  BOOST_CHECK( repo.providesUpdatesFor( "cpe://o:sle" ) );
+
+  BOOST_CHECK_EQUAL( countKind( repo, ResKind::package ), 3 );
+  for_( it, repo.solvablesBegin(), repo.solvablesEnd() )
+  {
+    if ( it->ident() == "foofoo" )
+      BOOST_CHECK_EQUAL( make<Package>( *it )->vendorSupport(), VendorSupportLevel3 );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(unsupported)
+{
+  // old style patches.xml is left to repo2solv.sh
+  SolvBuilder builder( TESTS_SRC_DIR "/repo/yum/data/10.2-updates-subset" );
+  BOOST_CHECK( ! builder.supported() );
+}
@@ -1,6 +1,11 @@
 #include "TestSetup.h"
+#include <sstream>
+#include <boost/thread.hpp>
 #include <zypp/Repository.h>
 #include <zypp/sat/Pool.h>
+#include <zypp/Edition.h>
+#include <zypp/sat/LookupAttr.h>
+#include <zypp/base/StrMatcher.h>
 
 static TestSetup test( Arch_x86_64 );
 
@@ -84,6 +89,160 @@ BOOST_AUTO_TEST_CASE(repolist)
   //test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1" );
 }
 
+inline int sign( int val_r )
+{ return val_r < 0 ? -1 : ( val_r > 0 ? 1 : 0 ); }
+
+BOOST_AUTO_TEST_CASE(compareEdition)
+{
+  // ranked edition compare must agree with Edition::compare
+  sat::Pool satpool( test.satpool() );
+  BOOST_REQUIRE( !satpool.solvablesEmpty() );
+
+  std::vector<Edition> editions;
+  for_( it, satpool.solvablesBegin(), satpool.solvablesEnd() )
+  {
+    editions.push_back( it->edition() );
+    if ( editions.size() == 200 )
+      break;
+  }
+  editions.push_back( Edition( "0:1.0-1" ) );	// probably not in pool
+  editions.push_back( Edition( "1.0-1" ) );
+
+  for_( lhs, editions.begin(), editions.end() )
+    for_( rhs, editions.begin(), editions.end() )
+      BOOST_CHECK_EQUAL( sign( satpool.compareEdition( *lhs, *rhs ) ), sign( lhs->compare( *rhs ) ) );
+}
+
+BOOST_AUTO_TEST_CASE(snapshot)
+{
+  // pool has @System and :openSUSE-11.1 from the repolist test
+  sat::Pool satpool( test.satpool() );
+  Repository repo( satpool.reposFind( ":openSUSE-11.1" ) );
+  BOOST_REQUIRE( repo );
+  sat::Pool::size_type solvables = repo.solvablesSize();
+
+  filesystem::TmpDir tmp;
+  Pathname snapshot( tmp.path() / "pool.snapshot" );
+  satpool.saveSnapshot( snapshot, "cookie" );
+  satpool.reposErase( ":openSUSE-11.1" );
+
+  // outdated snapshot is not loaded
+  BOOST_CHECK( satpool.loadSnapshot( snapshot, "othercookie" ).empty() );
+  BOOST_CHECK( ! satpool.reposFind( ":openSUSE-11.1" ) );
+
+  std::vector<Repository> loaded( satpool.loadSnapshot( snapshot, "cookie" ) );
+  BOOST_REQUIRE_EQUAL( loaded.size(), 1 );
+  BOOST_CHECK_EQUAL( loaded[0].alias(), ":openSUSE-11.1" );
+  BOOST_CHECK_EQUAL( loaded[0].solvablesSize(), solvables );
+  BOOST_CHECK_EQUAL( satpool.reposSize(), 2 );
+}
+
+BOOST_AUTO_TEST_CASE(solvCacheFileProvides)
+{
+  // RepoManager::updateSolvCaches lets the repos solv cache remember the added file provides
+  sat::Pool satpool( test.satpool() );
+  test.loadRepo( TESTS_SRC_DIR "/data/11.0-update" );
+  Repository repo( satpool.reposFind( ":11.0-update" ) );
+  BOOST_CHECK( satpool.repoSolvCacheOutdated( repo ) );
+
+  test.repomanager().updateSolvCaches();
+  // the loaded repo is not changed
+  BOOST_CHECK( sat::LookupRepoAttr( sat::SolvAttr( "repository:addedfileprovides" ), repo ).empty() );
+
+  Pathname solvfile( RepoManagerOptions::makeTestSetup( test.root() ).repoSolvCachePath / ":11.0-update" / "solv" );
+  Repository check( satpool.addRepoSolv( solvfile, "check" ) );
+  sat::LookupRepoAttr added( sat::SolvAttr( "repository:addedfileprovides" ), check );
+  BOOST_CHECK( ! added.empty() );
+  check.eraseFromPool();
+}
+
+/** Providers of all \a caps_r, their names, summaries and the requested editions.
+ * Uses existing ids only, as no new ones may be created after prepareForConcurrentReads.
+ */
+std::string queryAll( const std::vector<Capability> & caps_r )
+{
+  std::ostringstream str;
+  for_( it, caps_r.begin(), caps_r.end() )
+  {
+    str << it->detail().name().c_str() << " >= " << it->detail().ed().c_str() << endl;
+    sat::WhatProvides q( *it );
+    for_( pit, q.begin(), q.end() )
+    {
+      str << *pit << " " << pit->lookupStrAttribute( sat::SolvAttr::summary );
+      sat::LookupAttr names( sat::SolvAttr::name, *pit );
+      for_( ait, names.begin(), names.end() )
+        str << " " << ait.idStr().c_str();
+      str << endl;
+    }
+  }
+  return str.str();
+}
+
+void queryAllTo( const std::vector<Capability> * caps_r, std::string * result_r )
+{ *result_r = queryAll( *caps_r ); }
+
+BOOST_AUTO_TEST_CASE(concurrentReads)
+{
+  sat::Pool satpool( test.satpool() );
+  std::vector<Capability> caps;
+  for_( it, satpool.solvablesBegin(), satpool.solvablesEnd() )
+  {
+    caps.push_back( Capability( it->ident().asString(), Rel::GE, Edition( "0" ) ) );
+    if ( caps.size() == 500 )
+      break;
+  }
+
+  ResPool::instance().prepareForConcurrentReads();
+  BOOST_CHECK( satpool.concurrentReads() );
+
+  std::vector<std::string> results( 4 );
+  boost::thread_group threads;
+  for_( it, results.begin(), results.end() )
+    threads.create_thread( boost::bind( &queryAllTo, &caps, &*it ) );
+  threads.join_all();
+
+  std::string expected( queryAll( caps ) );
+  BOOST_CHECK( ! expected.empty() );
+  for_( it, results.begin(), results.end() )
+    BOOST_CHECK( *it == expected );
+}
+
+/** Matching file list entries and stringified summaries. Both use libsolvs
+ * tmp space, which LookupAttr must serialize even on a prepared pool.
+ */
+std::string lookupAll()
+{
+  std::ostringstream str;
+  sat::LookupAttr files( sat::SolvAttr::filelist );
+  files.setStrMatcher( StrMatcher( "bin/", Match::SUBSTRING | Match::FILES ) );
+  for_( it, files.begin(), files.end() )
+    str << it.inSolvable() << " " << it.asString() << endl;
+  sat::LookupAttr summaries( sat::SolvAttr::summary );
+  for_( it, summaries.begin(), summaries.end() )
+    str << it.inSolvable() << " " << it.asString() << endl;
+  return str.str();
+}
+
+void lookupAllTo( std::string * result_r )
+{ *result_r = lookupAll(); }
+
+BOOST_AUTO_TEST_CASE(concurrentLookupAttr)
+{
+  ResPool::instance().prepareForConcurrentReads();
+  BOOST_CHECK( test.satpool().concurrentReads() );
+
+  std::vector<std::string> results( 4 );
+  boost::thread_group threads;
+  for_( it, results.begin(), results.end() )
+    threads.create_thread( boost::bind( &lookupAllTo, &*it ) );
+  threads.join_all();
+
+  std::string expected( lookupAll() );
+  BOOST_CHECK( expected.find( "bin/" ) != std::string::npos );
+  for_( it, results.begin(), results.end() )
+    BOOST_CHECK( *it == expected );
+}
+
 #if 0
 BOOST_AUTO_TEST_CASE(LookupAttr_)
 {
@@ -0,0 +1,58 @@
+#include "TestSetup.h"
+#include <zypp/sat/SolvableColumns.h>
+
+static TestSetup test( Arch_x86_64 );
+
+/** Columns must match the single attribute lookups. */
+void checkColumns( const sat::SolvableColumns & table_r )
+{
+  for ( unsigned row = 0; row < table_r.size(); ++row )
+  {
+    sat::Solvable solv( table_r.solvable( row ) );
+    BOOST_CHECK_EQUAL( table_r.str( row, 0 ).asString(), solv.lookupStrAttribute( sat::SolvAttr::summary ) );
+    BOOST_CHECK_EQUAL( table_r.str( row, 1 ).asString(), solv.lookupStrAttribute( sat::SolvAttr::vendor ) );
+    BOOST_CHECK_EQUAL( table_r.num( row, 2 ), solv.lookupNumAttribute( sat::SolvAttr::installsize ) );
+    BOOST_CHECK_EQUAL( table_r.num( row, 3 ), solv.lookupNumAttribute( sat::SolvAttr::buildtime ) );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(columns)
+{
+  test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "opensuse" );
+  Repository repo( test.satpool().reposFind( "opensuse" ) );
+  BOOST_REQUIRE( repo );
+
+  std::vector<sat::SolvAttr> attrs;
+  attrs.push_back( sat::SolvAttr::summary );
+  attrs.push_back( sat::SolvAttr::vendor );
+  attrs.push_back( sat::SolvAttr::installsize );
+  attrs.push_back( sat::SolvAttr::buildtime );
+
+  // whole repo: extracted in one pass
+  sat::SolvableColumns all( repo.solvablesBegin(), repo.solvablesEnd(), attrs );
+  BOOST_CHECK_EQUAL( all.size(), repo.solvablesSize() );
+  BOOST_CHECK_EQUAL( all.columns(), 4 );
+  BOOST_CHECK( ! all.strColumn( 0 ).empty() );
+  BOOST_CHECK( all.numColumn( 0 ).empty() );
+  BOOST_CHECK( ! all.numColumn( 2 ).empty() );
+  checkColumns( all );
+
+  // a few solvables (and a duplicate): looked up per solvable
+  std::vector<sat::Solvable> some;
+  some.push_back( *repo.solvablesBegin() );
+  some.push_back( sat::Solvable( repo.solvablesBegin()->id() + 7 ) );
+  some.push_back( *repo.solvablesBegin() );
+  sat::SolvableColumns few( some.begin(), some.end(), attrs );
+  BOOST_CHECK_EQUAL( few.size(), 3 );
+  BOOST_CHECK( few.str( 0, 0 ) == few.str( 2, 0 ) );
+  checkColumns( few );
+
+  sat::SolvableColumns none;
+  BOOST_CHECK( none.empty() );
+
+  // strings would create ids the readers of a prepared pool don't expect
+  test.satpool().setConcurrentReads( true );
+  test.satpool().prepareForConcurrentReads();
+  BOOST_CHECK_THROW( sat::SolvableColumns( some.begin(), some.end(), attrs ), Exception );
+  test.satpool().setConcurrentReads( false );
+}
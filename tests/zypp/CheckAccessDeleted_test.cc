@@ -0,0 +1,73 @@
+#include <unistd.h>
+#include <iostream>
+#include <boost/test/auto_unit_test.hpp>
+
+#include "zypp/base/Logger.h"
+#include "zypp/base/String.h"
+#include "zypp/PathInfo.h"
+#include "zypp/TmpPath.h"
+#include "zypp/ExternalProgram.h"
+#include "zypp/misc/CheckAccessDeleted.h"
+
+using std::endl;
+using namespace zypp;
+
+/** Whether \a data_r reports process \a pid_r accessing \a file_r. */
+bool reports( const CheckAccessDeleted & data_r, pid_t pid_r, const Pathname & file_r )
+{
+  for_( it, data_r.begin(), data_r.end() )
+  {
+    if ( it->pid != str::numstring( pid_r ) )
+      continue;
+    for_( fit, it->files.begin(), it->files.end() )
+      if ( *fit == file_r.asString() )
+        return true;
+  }
+  return false;
+}
+
+BOOST_AUTO_TEST_CASE(deleted_executable)
+{
+  if ( ! PathInfo( "/proc/self/maps" ).isFile() || ! PathInfo( "/bin/sleep" ).isFile() )
+  {
+    BOOST_WARN_MESSAGE( false, "No /proc or /bin/sleep; skipping" );
+    return;
+  }
+
+  filesystem::TmpDir tmp;
+  Pathname exe( tmp.path() / "bin" / "zypp-sleep" );	// 'bin/' is reported even if not verbose
+  filesystem::assert_dir( exe.dirname() );
+  BOOST_REQUIRE_EQUAL( filesystem::copy( "/bin/sleep", exe ), 0 );
+
+  const char * argv[] = { exe.c_str(), "60", NULL };
+  ExternalProgram prog( argv, ExternalProgram::Discard_Stderr );
+  pid_t pid = prog.getpid();
+  BOOST_REQUIRE( pid > 0 );
+  // wait for the exec before deleting the file
+  Pathname procexe( Pathname("/proc") / str::numstring( pid ) / "exe" );
+  for ( unsigned i = 0; i < 100 && filesystem::readlink( procexe ) != exe; ++i )
+    ::usleep( 10000 );
+  BOOST_REQUIRE_EQUAL( filesystem::readlink( procexe ), exe );
+
+  BOOST_CHECK( ! reports( CheckAccessDeleted(), pid, exe ) );
+  filesystem::unlink( exe );
+
+  CheckAccessDeleted checker;
+  BOOST_CHECK( reports( checker, pid, exe ) );
+  for_( it, checker.begin(), checker.end() )
+  {
+    if ( it->pid == str::numstring( pid ) )
+    {
+      BOOST_CHECK_EQUAL( it->ppid, str::numstring( ::getpid() ) );
+      BOOST_CHECK_EQUAL( it->puid, str::numstring( ::getuid() ) );
+      BOOST_CHECK_EQUAL( it->command, "zypp-sleep" );
+    }
+  }
+
+  CheckAccessDeleted verbose( false );
+  verbose.check( /*verbose*/true );
+  BOOST_CHECK( reports( verbose, pid, exe ) );
+
+  prog.kill();
+  prog.close();
+}
@@ -61,3 +61,27 @@ BOOST_AUTO_TEST_CASE(orphaned)
   BOOST_CHECK_EQUAL( proxy.lookup( ResKind::package, "dropped_required" )->status(),	ui::S_KeepInstalled );
   BOOST_CHECK_EQUAL( proxy.lookup( ResKind::package, "dropped" )->status(),		ui::S_AutoDel );
 }
+
+BOOST_AUTO_TEST_CASE(statistics)
+{
+  // solve again, so the statistics don't depend on what the cases before did
+  BOOST_REQUIRE( upgrade() );
+  solver::detail::SolverStatistics stats( getZYpp()->resolver()->solverStatistics() );
+  USR << stats << endl;
+  BOOST_CHECK( stats.valid );
+  BOOST_CHECK( stats.distupgrade );
+  BOOST_CHECK( stats.solved );
+  BOOST_CHECK_EQUAL( stats.problems, 0 );
+  BOOST_CHECK( stats.jobs > 0 );
+  BOOST_CHECK( stats.decisions > 0 );
+  BOOST_CHECK( stats.pkgRules > 0 );
+  BOOST_CHECK_EQUAL( stats.rules, stats.pkgRules + stats.updateRules + stats.featureRules + stats.jobRules
+                                  + stats.distupgradeRules + stats.infarchRules + stats.choiceRules
+                                  + stats.learntRules + stats.otherRules );
+
+  std::string json( stats.asJson() );
+  BOOST_CHECK_EQUAL( json[0], '{' );
+  BOOST_CHECK_EQUAL( json[json.size()-1], '}' );
+  BOOST_CHECK( json.find( "\"distupgrade\":true" ) != std::string::npos );
+  BOOST_CHECK( json.find( "\"solved\":true" ) != std::string::npos );
+}
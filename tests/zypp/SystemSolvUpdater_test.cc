@@ -0,0 +1,123 @@
+#include <iostream>
+#include <sstream>
+#include <set>
+
+#include "TestSetup.h"
+#include "zypp/ExternalProgram.h"
+#include "zypp/ZConfig.h"
+#include "zypp/sat/LookupAttr.h"
+#include "zypp/target/SystemSolvUpdater.h"
+#include "zypp/target/rpm/RpmDb.h"
+
+using target::SystemSolvUpdater;
+using namespace target::rpm;
+
+/** Build the test package, or return an empty path if \c rpmbuild is not available. */
+Pathname buildRpm( const Pathname & topdir_r )
+{
+  ExternalProgram::Arguments argv;
+  argv.push_back( "rpmbuild" );
+  argv.push_back( "-bb" );
+  argv.push_back( "--quiet" );
+  argv.push_back( "--define" );
+  argv.push_back( "_topdir " + topdir_r.asString() );
+  argv.push_back( TESTS_SRC_DIR "/zypp/data/SystemSolvUpdater/sysupd.spec" );
+
+  ExternalProgram prog( argv, ExternalProgram::Stderr_To_Stdout );
+  for ( std::string line( prog.receiveLine() ); ! line.empty(); line = prog.receiveLine() )
+    MIL << "  " << line;
+  if ( prog.close() != 0 )
+    return Pathname();
+  return topdir_r / "RPMS/noarch/sysupd-1.0-1.noarch.rpm";
+}
+
+/** The attributes \c rpmdb2solv stores, per solvable in \a solv_r. */
+std::set<std::string> describe( const Pathname & solv_r )
+{
+  std::set<std::string> ret;
+  Repository repo( sat::Pool::instance().addRepoSolv( solv_r, "describe" ) );
+  for_( it, repo.solvablesBegin(), repo.solvablesEnd() )
+  {
+    unsigned files = 0;
+    sat::LookupAttr q( sat::SolvAttr::filelist, *it );
+    for_( f, q.begin(), q.end() )
+      ++files;
+
+    std::ostringstream str;
+    str << it->ident() << "-" << it->edition() << "." << it->arch()
+        << " installtime " << it->lookupNumAttribute( sat::SolvAttr::installtime )
+        << " rpmdbid " << it->lookupNumAttribute( sat::SolvAttr( "rpm:dbid" ) )
+        << " buildtime " << it->lookupNumAttribute( sat::SolvAttr::buildtime )
+        << " installsize " << it->lookupNumAttribute( sat::SolvAttr::installsize )
+        << " downloadsize " << it->lookupNumAttribute( sat::SolvAttr::downloadsize )
+        << " provides " << it->provides().size()
+        << " requires " << it->requires().size()
+        << " files " << files;
+    ret.insert( str.str() );
+  }
+  repo.eraseFromPool();
+  return ret;
+}
+
+/** The installed package \a name_r in the pool. */
+sat::Solvable findInstalled( const std::string & name_r )
+{
+  Repository system( sat::Pool::instance().findSystemRepo() );
+  for_( it, system.solvablesBegin(), system.solvablesEnd() )
+  {
+    if ( it->name() == name_r )
+      return *it;
+  }
+  return sat::Solvable();
+}
+
+BOOST_AUTO_TEST_CASE(incremental_equals_rebuilt)
+{
+  filesystem::TmpDir tmp;
+  Pathname rpm( buildRpm( tmp.path() / "rpmbuild" ) );
+  if ( rpm.empty() )
+  {
+    BOOST_WARN_MESSAGE( false, "rpmbuild not available; test skipped" );
+    return;
+  }
+
+  Pathname root( tmp.path() / "root" );
+  ZYpp::Ptr z( getZYpp() );
+  z->initializeTarget( root );
+  z->target()->load();
+
+  Pathname solvfile( Pathname::assertprefix( root, ZConfig::instance().repoSolvfilesPath() / sat::Pool::systemRepoAlias() ) / "solv" );
+  Pathname incremental( tmp.path() / "incremental.solv" );
+  BOOST_REQUIRE( filesystem::copy( solvfile, incremental ) == 0 );
+
+  // install: the updater sees the same header as rpmdb2solv
+  {
+    SystemSolvUpdater updater( incremental );
+    BOOST_REQUIRE( updater.valid() );
+    z->target()->rpmDb().installPackage( rpm, RPMINST_JUSTDB|RPMINST_NODEPS|RPMINST_NOSIGNATURE );
+    z->target()->load();	// rebuilds the solv file
+
+    sat::Solvable installed( findInstalled( "sysupd" ) );
+    BOOST_REQUIRE( installed );
+    BOOST_CHECK( installed.lookupNumAttribute( sat::SolvAttr::installtime ) );
+    updater.installed( rpm, installed );
+    BOOST_REQUIRE( updater.write() );
+  }
+  std::set<std::string> rebuilt( describe( solvfile ) );
+  BOOST_CHECK_EQUAL( rebuilt.size(), sat::Pool::instance().findSystemRepo().solvablesSize() );
+  BOOST_CHECK( describe( incremental ) == rebuilt );
+
+  // remove
+  {
+    SystemSolvUpdater updater( incremental );
+    BOOST_REQUIRE( updater.valid() );
+    sat::Solvable installed( findInstalled( "sysupd" ) );
+    BOOST_REQUIRE( installed );
+    z->target()->rpmDb().removePackage( "sysupd", RPMINST_JUSTDB|RPMINST_NODEPS );
+    updater.removed( installed );
+    BOOST_REQUIRE( updater.write() );
+    z->target()->load();
+  }
+  BOOST_CHECK( describe( incremental ) == describe( solvfile ) );
+  BOOST_CHECK( ! findInstalled( "sysupd" ) );
+}
@@ -2,6 +2,7 @@
 #include <iostream>
 #include <list>
 #include <string>
+#include <vector>
 
 // Boost.Test
 #include <boost/test/auto_unit_test.hpp>
@@ -12,6 +13,10 @@
 #include "zypp/ZYpp.h"
 #include "zypp/ZYppFactory.h"
 #include "zypp/TmpPath.h"
+#include "zypp/sat/Pool.h"
+#include "zypp/ZConfig.h"
+#include "zypp/RepoManager.h"
+#include "zypp/PathInfo.h"
 
 using boost::unit_test::test_case;
 using namespace std;
@@ -46,4 +51,68 @@ BOOST_AUTO_TEST_CASE(target_test)
     Target::DistributionLabel dlabel( z->target()->distributionLabel() );
     BOOST_CHECK_EQUAL( dlabel.summary, "A cool distribution" );
     BOOST_CHECK_EQUAL( dlabel.shortName, "" );
+
+    // empty rpmdb: nothing is owned
+    std::vector<std::string> paths;
+    paths.push_back( "/etc/passwd" );
+    paths.push_back( "/usr/bin/zypper" );
+    std::vector<std::string> owners( z->target()->whoOwnsFiles( paths ) );
+    BOOST_CHECK_EQUAL( owners.size(), paths.size() );
+    BOOST_CHECK( owners[0].empty() && owners[1].empty() );
+}
+
+BOOST_AUTO_TEST_CASE(file_owner_index)
+{
+    filesystem::TmpDir tmp;
+
+    ZYpp::Ptr z = getZYpp();
+    z->initializeTarget( tmp.path() );
+    // writes the @System solv cache and the rpmdb cookie
+    z->target()->load();
+
+    // the fixture as solv file, built like any repo cache
+    filesystem::TmpDir repotmp;
+    RepoManager rmanager( RepoManagerOptions::makeTestSetup( repotmp.path() ) );
+    RepoInfo info;
+    info.setAlias( "system" );
+    info.addBaseUrl( (Pathname(TESTS_SRC_DIR) / "/zypp/data/Target/system").asUrl() );
+    info.setGpgCheck( false );
+    rmanager.addRepository( info );
+    rmanager.buildCache( info );
+
+    // replace the targets solv cache, so queries are answered from its filelists
+    Pathname solvfile( tmp.path() / ZConfig::instance().repoSolvfilesPath() / sat::Pool::systemRepoAlias() / "solv" );
+    BOOST_REQUIRE( PathInfo( solvfile ).isFile() );
+    BOOST_REQUIRE_EQUAL( copy( repotmp.path() / "solv" / "system" / "solv", solvfile ), 0 );
+
+    std::vector<std::string> paths;
+    paths.push_back( "/usr/bin/zypper" );		// file, single owner
+    paths.push_back( "/etc/passwd" );			// not owned
+    paths.push_back( "/etc/zypp/zypper.conf" );		// file, two owners
+    paths.push_back( "/usr/share/doc" );		// dir
+    paths.push_back( "/usr/share/doc/zypper" );		// dir, two owners
+    paths.push_back( "/usr/share/doc/zypper/README" );	// below an owned dir
+    std::vector<std::string> owners( z->target()->whoOwnsFiles( paths ) );
+    BOOST_REQUIRE_EQUAL( owners.size(), paths.size() );
+    BOOST_CHECK_EQUAL( owners[0], "zypper" );
+    BOOST_CHECK_EQUAL( owners[1], "" );
+    BOOST_CHECK( owners[2] == "zypper" || owners[2] == "zypper-compat" );
+    BOOST_CHECK_EQUAL( owners[3], "filesystem" );
+    BOOST_CHECK( owners[4] == "zypper" || owners[4] == "zypper-compat" );
+    BOOST_CHECK_EQUAL( owners[5], "" );
+
+    // single queries agree with the batch
+    for ( unsigned i = 0; i < paths.size(); ++i )
+      BOOST_CHECK_EQUAL( z->target()->whoOwnsFile( paths[i] ), owners[i] );
+
+    // like 'rpm -q --whatprovides': a shared file belongs to no single package
+    BOOST_CHECK( z->target()->providesFile( "/usr/bin/zypper", "zypper" ) );
+    BOOST_CHECK( ! z->target()->providesFile( "/usr/bin/zypper", "zypper-compat" ) );
+    BOOST_CHECK( ! z->target()->providesFile( "/etc/zypp/zypper.conf", "zypper" ) );
+    BOOST_CHECK( ! z->target()->providesFile( "/etc/passwd", "filesystem" ) );
+    BOOST_CHECK( z->target()->providesFile( "/etc", "filesystem" ) );
+
+    // the loaded @System repo is not used
+    sat::Pool::instance().systemRepo().eraseFromPool();
+    BOOST_CHECK_EQUAL( z->target()->whoOwnsFile( "/usr/bin/zypper" ), "zypper" );
 }
@@ -155,6 +155,12 @@ BOOST_AUTO_TEST_CASE(test_url1)
     str = "cd:///some/path";
     BOOST_CHECK_EQUAL( str, zypp::Url(str).asString());
     BOOST_CHECK( zypp::Url(str).isValid());
+
+    // throws:  invalid host (not a decoding error)
+    str = "http://%00/some/path";
+    BOOST_CHECK_THROW(zypp::Url(str).asString(), url::UrlBadComponentException );
+    zypp::Url hosturl( "http://localhost/some/path" );
+    BOOST_CHECK_THROW(hosturl.setHost( "%00" ), url::UrlBadComponentException );
 }
 
 BOOST_AUTO_TEST_CASE(test_url2)
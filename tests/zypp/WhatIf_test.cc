@@ -0,0 +1,102 @@
+#include <set>
+#include <sstream>
+
+#include "TestSetup.h"
+#include "zypp/ResPool.h"
+#include "zypp/ui/Selectable.h"
+#include "zypp/solver/detail/Resolver.h"
+
+#define BOOST_TEST_MODULE WhatIf
+
+using solver::detail::PoolItemList;
+using solver::detail::WhatIfResultList;
+
+/////////////////////////////////////////////////////////////////////////////
+
+static TestSetup test;
+
+PoolItem candidate( const std::string & name_r )
+{ return ui::Selectable::get( name_r )->candidateObj(); }
+
+std::set<std::string> names( const PoolItemList & items_r )
+{
+  std::set<std::string> ret;
+  for_( it, items_r.begin(), items_r.end() )
+    ret.insert( it->satSolvable().name() );
+  return ret;
+}
+
+std::set<std::string> names( const char * n1, const char * n2 = 0 )
+{
+  std::set<std::string> ret;
+  ret.insert( n1 );
+  if ( n2 )
+    ret.insert( n2 );
+  return ret;
+}
+
+/** The status of all pool items. */
+std::vector<std::string> statuses()
+{
+  std::vector<std::string> ret;
+  for_( it, test.pool().begin(), test.pool().end() )
+  {
+    std::ostringstream str;
+    str << it->status();
+    ret.push_back( str.str() );
+  }
+  return ret;
+}
+
+void checkWhatIf( unsigned workers_r )
+{
+  PoolItemList items;
+  items.push_back( candidate( "tool" ) );	// pulls in helper
+  items.push_back( candidate( "newlib" ) );	// obsoletes oldlib
+  items.push_back( candidate( "broken" ) );	// requires missing
+
+  std::vector<std::string> before( statuses() );
+  WhatIfResultList results( getZYpp()->resolver()->whatIfInstall( items, workers_r ) );
+  BOOST_CHECK( statuses() == before );
+
+  BOOST_REQUIRE_EQUAL( results.size(), 3U );
+  PoolItemList::const_iterator item( items.begin() );
+  for ( unsigned i = 0; i < results.size(); ++i, ++item )
+    BOOST_CHECK_EQUAL( results[i].item, *item );
+
+  BOOST_CHECK( results[0].solved );
+  BOOST_CHECK( names( results[0].toInstall ) == names( "tool", "helper" ) );
+  BOOST_CHECK( results[0].toRemove.empty() );	// removing base is not asked for
+  BOOST_CHECK( results[0].problems.empty() );
+
+  BOOST_CHECK( results[1].solved );
+  BOOST_CHECK( names( results[1].toInstall ) == names( "newlib" ) );
+  BOOST_CHECK( names( results[1].toRemove ) == names( "oldlib" ) );
+  BOOST_CHECK( results[1].problems.empty() );
+
+  BOOST_CHECK( ! results[2].solved );
+  BOOST_CHECK( ! results[2].problems.empty() );
+
+  // installed packages no job touches are kept
+  for ( unsigned i = 0; i < results.size(); ++i )
+    BOOST_CHECK( ! names( results[i].toRemove ).count( "unrelated" ) );
+}
+
+BOOST_AUTO_TEST_CASE(testcase_init)
+{
+  test.loadTestcaseRepos( TESTS_SRC_DIR"/data/TCwhatif" );
+  // Transactions in the pool are ignored and left untouched.
+  PoolItem base( ui::Selectable::get( "base" )->installedObj() );
+  BOOST_REQUIRE( base );
+  base.status().setToBeUninstalled( ResStatus::USER );
+}
+
+BOOST_AUTO_TEST_CASE(single_worker)
+{
+  checkWhatIf( 1 );
+}
+
+BOOST_AUTO_TEST_CASE(forked_workers)
+{
+  checkWhatIf( 3 );
+}
@@ -0,0 +1,103 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <boost/test/auto_unit_test.hpp>
+
+#include "zypp/base/Logger.h"
+#include "zypp/base/String.h"
+#include "zypp/base/GzStream.h"
+#include "zypp/TmpPath.h"
+#include "zypp/PathInfo.h"
+
+using namespace std;
+using namespace zypp;
+
+#define DATADIR (Pathname(TESTS_SRC_DIR) + "/zypp/base/data/GzStream")
+
+string slurp( const Pathname & file_r, unsigned bufferSize_r = gzstream_detail::fgzstreambuf::defaultBufferSize )
+{
+  ifgzstream in( file_r.c_str(), bufferSize_r );
+  BOOST_REQUIRE( in.is_open() );
+  ostringstream str;
+  str << in.rdbuf();
+  return str.str();
+}
+
+BOOST_AUTO_TEST_CASE(read_compressed)
+{
+  string plain( slurp( DATADIR / "test.txt" ) );
+  BOOST_REQUIRE_EQUAL( plain.size(), 21492 );
+
+  BOOST_CHECK_EQUAL( filesystem::zipType( DATADIR / "test.txt" ),     filesystem::ZT_NONE );
+  BOOST_CHECK_EQUAL( filesystem::zipType( DATADIR / "test.txt.gz" ),  filesystem::ZT_GZ );
+  BOOST_CHECK_EQUAL( filesystem::zipType( DATADIR / "test.txt.xz" ),  filesystem::ZT_XZ );
+  BOOST_CHECK_EQUAL( filesystem::zipType( DATADIR / "test.txt.zst" ), filesystem::ZT_ZSTD );
+
+  BOOST_CHECK( slurp( DATADIR / "test.txt.gz" ) == plain );
+  BOOST_CHECK( slurp( DATADIR / "test.txt.gz", 1 ) == plain );
+#ifdef HAVE_LZMA
+  BOOST_CHECK( slurp( DATADIR / "test.txt.xz" ) == plain );
+  BOOST_CHECK( slurp( DATADIR / "test.txt.xz", 7 ) == plain );
+#endif
+#ifdef HAVE_ZSTD
+  BOOST_CHECK( slurp( DATADIR / "test.txt.zst" ) == plain );
+  BOOST_CHECK( slurp( DATADIR / "test.txt.zst", 7 ) == plain );
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(seek_compressed)
+{
+  string plain( slurp( DATADIR / "test.txt" ) );
+  const char * files[] = { "test.txt.gz",
+#ifdef HAVE_LZMA
+                           "test.txt.xz",
+#endif
+#ifdef HAVE_ZSTD
+                           "test.txt.zst",
+#endif
+  };
+  for ( unsigned i = 0; i < sizeof(files)/sizeof(files[0]); ++i )
+  {
+    ifgzstream in( (DATADIR / files[i]).c_str(), 100 );
+    string word;
+
+    in.seekg( 15000 );
+    in >> word;
+    BOOST_CHECK_EQUAL( word, plain.substr( 15000, plain.find( ' ', 15000 ) - 15000 ) );
+    // backwards
+    in.seekg( 5 );
+    in >> word;
+    BOOST_CHECK_EQUAL( word, "1:" );
+    BOOST_CHECK_EQUAL( in.tellg(), 7 );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(write_gz)
+{
+  filesystem::TmpFile tmp;
+  string plain( slurp( DATADIR / "test.txt" ) );
+  {
+    ofgzstream out( tmp.path().c_str(), 13 );
+    out << plain;
+  }
+  BOOST_CHECK_EQUAL( filesystem::zipType( tmp.path() ), filesystem::ZT_GZ );
+  BOOST_CHECK( slurp( tmp.path() ) == plain );
+}
+
+BOOST_AUTO_TEST_CASE(read_metadata)
+{
+  // Parsers read line by line (timing in benchmarks/GzStream_bench).
+  Pathname file( Pathname(TESTS_SRC_DIR) / "data/11.0-update/repodata/primary.xml.gz" );
+  unsigned bufferSizes[] = { 512, gzstream_detail::fgzstreambuf::defaultBufferSize };
+  unsigned lines[] = { 0, 0 };
+  for ( unsigned i = 0; i < 2; ++i )
+  {
+    ifgzstream in( file.c_str(), bufferSizes[i] );
+    string line;
+    while ( getline( in, line ) )
+      ++lines[i];
+  }
+  BOOST_CHECK_EQUAL( lines[0], 185818 );
+  BOOST_CHECK_EQUAL( lines[0], lines[1] );
+}
@@ -0,0 +1,24 @@
+Name:           sysupd
+Version:        1.0
+Release:        1
+Summary:        Package installed by SystemSolvUpdater_test
+License:        GPL-2.0+
+Group:          System/Packages
+BuildArch:      noarch
+
+%description
+Package installed by SystemSolvUpdater_test.
+
+%prep
+
+%build
+
+%install
+mkdir -p %{buildroot}/usr/share/sysupd
+echo sysupd > %{buildroot}/usr/share/sysupd/README
+
+%files
+%dir /usr/share/sysupd
+/usr/share/sysupd/README
+
+%changelog
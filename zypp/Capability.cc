@@ -141,6 +141,7 @@ namespace zypp
                                     const Edition & ed_r,
                                     const ResKind & kind_r )
     {
+      sat::detail::PoolImpl::IdCreationLock guard( sat::detail::PoolMember::myPool() );
       // First build the name, non-packages prefixed by kind
       sat::Solvable::SplitIdent split( kind_r, name_r );
       sat::detail::IdType nid( split.ident().id() );
@@ -300,7 +301,16 @@ namespace zypp
   {}
 
   const char * Capability::c_str() const
-  { return( _id ? ::pool_dep2str( myPool().getPool(), _id ) : "" ); }
+  {
+    thread::MutexLock guard( myPool().lazyLock() );
+    return( _id ? ::pool_dep2str( myPool().getPool(), _id ) : "" );
+  }
+
+  std::string Capability::asString() const
+  {
+    thread::MutexLock guard( myPool().lazyLock() ); // copy before tmp space is reused
+    return c_str();
+  }
 
   CapMatch Capability::_doMatch( sat::detail::IdType lhs,  sat::detail::IdType rhs )
   {
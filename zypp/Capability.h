@@ -145,12 +145,15 @@ namespace zypp
       { return( _id == sat::detail::emptyId || _id == sat::detail::noId ); }
 
     public:
-      /** Conversion to <tt>const char *</tt> */
+      /** Conversion to <tt>const char *</tt>
+       * \note For relations the string is in libsolvs tmp space, which is
+       * reused by later calls. Use \ref asString in concurrent read mode
+       * (\ref sat::Pool::concurrentReads).
+       */
       const char * c_str() const;
 
       /** \overload */
-      std::string asString() const
-      { return c_str(); }
+      std::string asString() const;
 
     public:
       /** Helper providing more detailed information about a \ref Capability. */
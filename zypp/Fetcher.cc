@@ -20,6 +20,7 @@
 #include "zypp/base/PtrTypes.h"
 #include "zypp/base/DefaultIntegral.h"
 #include "zypp/base/String.h"
+#include "zypp/base/Trace.h"
 #include "zypp/Fetcher.h"
 #include "zypp/ZYppFactory.h"
 #include "zypp/CheckSum.h"
@@ -537,6 +538,8 @@ namespace zypp
 
   void Fetcher::Impl::provideToDest( MediaSetAccess &media, const OnMediaLocation &resource, const Pathname &dest_dir, const Pathname &deltafile )
   {
+    debug::TraceSpan span( "Fetcher::provideToDest", "repo" );
+    span.attr( "file", resource.filename().asString() );
     bool got_from_cache = false;
 
     // start look in cache
@@ -750,6 +753,8 @@ namespace zypp
                              MediaSetAccess &media,
                              const ProgressData::ReceiverFnc & progress_receiver )
   {
+    debug::TraceSpan span( "Fetcher::start", "repo" );
+    span.attr( "jobs", (long long)_resources.size() );
     ProgressData progress(_resources.size());
     progress.sendTo(progress_receiver);
 
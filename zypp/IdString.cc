@@ -29,12 +29,16 @@ namespace zypp
   /////////////////////////////////////////////////////////////////
 
   IdString::IdString( const char * str_r )
-  : _id( ::pool_str2id( myPool().getPool(), str_r, /*create*/true ) )
-  {}
+  {
+    sat::detail::PoolImpl::IdCreationLock guard( myPool() );
+    _id = ::pool_str2id( myPool().getPool(), str_r, /*create*/true );
+  }
 
   IdString::IdString( const std::string & str_r )
-  : _id( ::pool_str2id( myPool().getPool(), str_r.c_str(), /*create*/true ) )
-  {}
+  {
+    sat::detail::PoolImpl::IdCreationLock guard( myPool() );
+    _id = ::pool_str2id( myPool().getPool(), str_r.c_str(), /*create*/true );
+  }
 
   unsigned IdString::size() const
   { return ::strlen( c_str() ); }
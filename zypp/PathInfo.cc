@@ -744,6 +744,29 @@ namespace zypp
       return _Log_Result( 0 );
     }
 
+    namespace
+    {
+      /** Run /bin/cp, cloning the data if \a reflink_r and the filesystem supports it. */
+      int runCp( const Pathname & file, const Pathname & dest, bool reflink_r )
+      {
+        const char * argv[7];
+        unsigned i = 0;
+        argv[i++] = "/bin/cp";
+        argv[i++] = "--remove-destination";
+        if ( reflink_r )
+          argv[i++] = "--reflink=auto";
+        argv[i++] = "--";
+        argv[i++] = file.asString().c_str();
+        argv[i++] = dest.asString().c_str();
+        argv[i] = NULL;
+        ExternalProgram prog( argv, ExternalProgram::Stderr_To_Stdout );
+        for ( string output( prog.receiveLine() ); output.length(); output = prog.receiveLine() ) {
+          MIL << "  " << output;
+        }
+        return prog.close();
+      }
+    }
+
     ///////////////////////////////////////////////////////////////////
     //
     //	METHOD NAME : copy
@@ -763,19 +786,19 @@ namespace zypp
         return _Log_Result( EISDIR );
       }
 
-      const char *const argv[] = {
-        "/bin/cp",
-        "--remove-destination",
-        "--",
-        file.asString().c_str(),
-        dest.asString().c_str(),
-        NULL
-      };
-      ExternalProgram prog( argv, ExternalProgram::Stderr_To_Stdout );
-      for ( string output( prog.receiveLine() ); output.length(); output = prog.receiveLine() ) {
-        MIL << "  " << output;
+      // --reflink needs coreutils >= 7.5; older cp fail on the unknown option.
+      static bool reflinkOk = true;
+      int ret = runCp( file, dest, reflinkOk );
+      if ( ret != 0 && reflinkOk )
+      {
+        int plain = runCp( file, dest, false );
+        if ( plain == 0 )
+        {
+          MIL << "(cp does not support --reflink) ";
+          reflinkOk = false;
+        }
+        ret = plain;
       }
-      int ret = prog.close();
       return _Log_Result( ret, "returned" );
     }
 
@@ -837,6 +860,8 @@ namespace zypp
         switch ( errno )
         {
           case EXDEV: // oldpath  and  newpath are not on the same mounted file system
+          case EMLINK: // oldpath has the maximum number of links
+          case EPERM: // e.g. protected_hardlinks or not supported by the filesystem
             return copy( oldpath, newpath );
             break;
         }
@@ -1057,14 +1082,19 @@ namespace zypp
       int fd = open( file.asString().c_str(), O_RDONLY|O_CLOEXEC );
 
       if ( fd != -1 ) {
-        const int magicSize = 3;
+        const int magicSize = 6;
         unsigned char magic[magicSize];
         memset( magic, 0, magicSize );
-        if ( read( fd, magic, magicSize ) == magicSize ) {
+        if ( read( fd, magic, magicSize ) >= 3 ) {
           if ( magic[0] == 0037 && magic[1] == 0213 ) {
             ret = ZT_GZ;
           } else if ( magic[0] == 'B' && magic[1] == 'Z' && magic[2] == 'h' ) {
             ret = ZT_BZ2;
+          } else if ( magic[0] == 0xFD && magic[1] == '7' && magic[2] == 'z'
+                      && magic[3] == 'X' && magic[4] == 'Z' && magic[5] == 0x00 ) {
+            ret = ZT_XZ;
+          } else if ( magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD ) {
+            ret = ZT_ZSTD;
           }
         }
         close( fd );
@@ -629,6 +629,8 @@ namespace zypp
 
     /**
      * Like 'cp file dest'. Copy file to destination file.
+     * On filesystems supporting it, the copy shares the data blocks
+     * with \a file (<tt>cp --reflink=auto</tt>, if \c cp supports it).
      *
      * @return 0 on success, EINVAL if file is not a file, EISDIR if
      * destiantion is a directory, otherwise the commands return value.
@@ -653,6 +655,8 @@ namespace zypp
 
     /**
      * Create \a newpath as hardlink or copy of \a oldpath.
+     * The file is copied if it can not be hardlinked (different
+     * filesystems, too many links or hardlinks not permitted).
      *
      * @return 0 on success, errno on failure.
      */
@@ -759,11 +763,11 @@ namespace zypp
     /** \name Misc. */
     //@{
     /**
-     * Test whether a file is compressed (gzip/bzip2).
+     * Test whether a file is compressed (gzip/bzip2/xz/zstd).
      *
-     * @return ZT_GZ, ZT_BZ2 if file is compressed, otherwise ZT_NONE.
+     * @return ZT_GZ, ZT_BZ2, ZT_XZ, ZT_ZSTD if file is compressed, otherwise ZT_NONE.
      **/
-    enum ZIP_TYPE { ZT_NONE, ZT_GZ, ZT_BZ2 };
+    enum ZIP_TYPE { ZT_NONE, ZT_GZ, ZT_BZ2, ZT_XZ, ZT_ZSTD };
 
     ZIP_TYPE zipType( const Pathname & file );
 
@@ -23,6 +23,7 @@
 #include "zypp/base/Gettext.h"
 #include "zypp/base/Function.h"
 #include "zypp/base/Regex.h"
+#include "zypp/base/Trace.h"
 #include "zypp/PathInfo.h"
 #include "zypp/TmpPath.h"
 
@@ -38,8 +39,10 @@
 
 #include "zypp/parser/RepoFileReader.h"
 #include "zypp/parser/ServiceFileReader.h"
+#include "zypp/parser/IniDictSnapshot.h"
 #include "zypp/repo/ServiceRepos.h"
 #include "zypp/repo/yum/Downloader.h"
+#include "zypp/repo/yum/SolvBuilder.h"
 #include "zypp/repo/susetags/Downloader.h"
 #include "zypp/parser/plaindir/RepoParser.h"
 #include "zypp/repo/PluginServices.h"
@@ -192,6 +195,32 @@ namespace zypp
       RepoInfoList repos;
       std::string targetDistro;
     };
+
+    /** Functor passing the content of a repo file to a \ref RepoCollector. */
+    class RepoDictCollector
+    {
+    public:
+      RepoDictCollector( RepoCollector & collector_r )
+      : _collector( collector_r )
+      {}
+
+      void operator()( const Pathname & file_r, const parser::IniDict & dict_r ) const
+      {
+        MIL << "repo file: " << file_r << endl;
+        parser::RepoFileReader( dict_r, file_r, bind( &RepoCollector::collect, &_collector, _1 ) );
+      }
+
+    private:
+      RepoCollector & _collector;
+    };
+
+    /** Whether \a file_r ends with ".repo" (or ".repo_N"). */
+    bool allowedRepoFile( const Pathname & file_r )
+    {
+      static str::regex allowedRepoExt("^\\.repo(_[0-9]+)?$");
+      return str::regex_match( file_r.extension(), allowedRepoExt );
+    }
+
     ////////////////////////////////////////////////////////////////////////////
 
     /**
@@ -213,34 +242,18 @@ namespace zypp
      * \short List of RepoInfo's from a directory
      *
      * Goes trough every file ending with ".repo" in a directory and adds all
-     * RepoInfo's contained in that file.
+     * RepoInfo's contained in that file. Unchanged files are taken from
+     * \a snapshot instead of being parsed.
      *
      * \param dir pathname of the directory to read.
+     * \param snapshot cached content of the directory.
      */
-    std::list<RepoInfo> repositories_in_dir( const Pathname &dir )
+    std::list<RepoInfo> repositories_in_dir( const Pathname &dir, parser::IniDictSnapshot & snapshot )
     {
       MIL << "directory " << dir << endl;
-      std::list<RepoInfo> repos;
-      std::list<Pathname> entries;
-      if ( filesystem::readdir( entries, dir, false ) != 0 )
-      {
-	// TranslatorExplanation '%s' is a pathname
-	ZYPP_THROW(Exception(str::form(_("Failed to read directory '%s'"), dir.c_str())));
-      }
-
-      str::regex allowedRepoExt("^\\.repo(_[0-9]+)?$");
-      for ( std::list<Pathname>::const_iterator it = entries.begin(); it != entries.end(); ++it )
-      {
-	if (str::regex_match(it->extension(), allowedRepoExt))
-	{
-	  std::list<RepoInfo> tmp = repositories_in_file( *it );
-	  repos.insert( repos.end(), tmp.begin(), tmp.end() );
-
-	  //std::copy( collector.repos.begin(), collector.repos.end(), std::back_inserter(repos));
-	  //MIL << "ok" << endl;
-	}
-      }
-      return repos;
+      RepoCollector collector;
+      snapshot.readDir( dir, RepoDictCollector( collector ), allowedRepoFile );
+      return collector.repos;
     }
 
     ////////////////////////////////////////////////////////////////////////////
@@ -343,6 +356,28 @@ namespace zypp
 	return true;
       }
 
+    private:
+      ServiceSet & _services;
+    };
+
+    /** Functor passing the content of a service file to a \ref ServiceCollector. */
+    class ServiceDictCollector
+    {
+    public:
+      typedef ServiceCollector::ServiceSet ServiceSet;
+
+      ServiceDictCollector( ServiceSet & services_r )
+      : _services( services_r )
+      {}
+
+      void operator()( const Pathname & file_r, const parser::IniDict & dict_r ) const
+      {
+        // an empty dict may be an unreadable file
+        if ( dict_r.sectionsBegin() == dict_r.sectionsEnd() && ! PathInfo( file_r ).userMayR() )
+          ZYPP_THROW(Exception("Failed to open service file"));
+        parser::ServiceFileReader( dict_r, file_r, ServiceCollector( _services ) );
+      }
+
     private:
       ServiceSet & _services;
     };
@@ -411,8 +446,10 @@ namespace zypp
     Impl( const RepoManagerOptions &opt )
       : _options(opt)
     {
-      init_knownServices();
-      init_knownRepositories();
+      parser::IniDictSnapshot snapshot( _options.repoCachePath / "config.snapshot" );
+      init_knownServices( snapshot );
+      init_knownRepositories( snapshot );
+      snapshot.save();
     }
 
   public:
@@ -463,6 +500,8 @@ namespace zypp
 
     void loadFromCache( const RepoInfo & info, OPT_PROGRESS );
 
+    void updateSolvCaches();
+
     void addRepository( const RepoInfo & info, OPT_PROGRESS );
 
     void addRepositories( const Url & url, OPT_PROGRESS );
@@ -538,8 +577,8 @@ namespace zypp
     }
 
   private:
-    void init_knownServices();
-    void init_knownRepositories();
+    void init_knownServices( parser::IniDictSnapshot & snapshot );
+    void init_knownRepositories( parser::IniDictSnapshot & snapshot );
 
   private:
     RepoManagerOptions	_options;
@@ -609,35 +648,25 @@ namespace zypp
 
   ////////////////////////////////////////////////////////////////////////////
 
-  void RepoManager::Impl::init_knownServices()
+  void RepoManager::Impl::init_knownServices( parser::IniDictSnapshot & snapshot )
   {
     Pathname dir = _options.knownServicesPath;
-    std::list<Pathname> entries;
     if (PathInfo(dir).isExist())
     {
-      if ( filesystem::readdir( entries, dir, false ) != 0 )
-      {
-        // TranslatorExplanation '%s' is a pathname
-        ZYPP_THROW(Exception(str::form(_("Failed to read directory '%s'"), dir.c_str())));
-      }
-
       //str::regex allowedServiceExt("^\\.service(_[0-9]+)?$");
-      for_(it, entries.begin(), entries.end() )
-      {
-        parser::ServiceFileReader(*it, ServiceCollector(_services));
-      }
+      snapshot.readDir( dir, ServiceDictCollector(_services) );
     }
 
     repo::PluginServices(_options.pluginsPath/"services", ServiceCollector(_services));
   }
 
-  void RepoManager::Impl::init_knownRepositories()
+  void RepoManager::Impl::init_knownRepositories( parser::IniDictSnapshot & snapshot )
   {
     MIL << "start construct known repos" << endl;
 
     if ( PathInfo(_options.knownReposPath).isExist() )
     {
-      RepoInfoList repol = repositories_in_dir(_options.knownReposPath);
+      RepoInfoList repol = repositories_in_dir(_options.knownReposPath, snapshot);
       std::list<string> repo_esc_aliases;
       std::list<string> entries;
       for ( RepoInfoList::iterator it = repol.begin();
@@ -911,6 +940,8 @@ namespace zypp
 
   void RepoManager::Impl::refreshMetadata( const RepoInfo & info, RawMetadataRefreshPolicy policy, const ProgressData::ReceiverFnc & progress )
   {
+    debug::TraceSpan span( "RepoManager::refreshMetadata", "repo" );
+    span.attr( "alias", info.alias() );
     assert_alias(info);
     assert_urls(info);
 
@@ -1079,6 +1110,8 @@ namespace zypp
 
   void RepoManager::Impl::buildCache( const RepoInfo & info, CacheBuildPolicy policy, const ProgressData::ReceiverFnc & progressrcv )
   {
+    debug::TraceSpan span( "RepoManager::buildCache", "repo" );
+    span.attr( "alias", info.alias() );
     assert_alias(info);
     Pathname mediarootpath = rawcache_path_for_repoinfo( _options, info );
     Pathname productdatapath = rawproductdata_path_for_repoinfo( _options, info );
@@ -1172,6 +1205,17 @@ namespace zypp
         ManagedFile guard( solvfile, filesystem::unlink );
         scoped_ptr<MediaMounter> forPlainDirs;
 
+        if ( repokind == RepoType::RPMMD && ZConfig::instance().repo_parallelCacheBuild() )
+        {
+          repo::yum::SolvBuilder builder( productdatapath );
+          if ( builder.supported() )
+          {
+            builder.build( solvfile );
+            guard.resetDispose();
+            break;
+          }
+        }
+
         ExternalProgram::Arguments cmd;
         cmd.push_back( "repo2solv.sh" );
 
@@ -1375,6 +1419,8 @@ namespace zypp
 
   void RepoManager::Impl::loadFromCache( const RepoInfo & info, const ProgressData::ReceiverFnc & progressrcv )
   {
+    debug::TraceSpan span( "RepoManager::loadFromCache", "repo" );
+    span.attr( "alias", info.alias() );
     assert_alias(info);
     Pathname solvfile = solv_path_for_repoinfo(_options, info) / "solv";
 
@@ -1413,6 +1459,32 @@ namespace zypp
 
   ////////////////////////////////////////////////////////////////////////////
 
+  void RepoManager::Impl::updateSolvCaches()
+  {
+    sat::Pool satpool( sat::Pool::instance() );
+    for_( it, repoBegin(), repoEnd() )
+    {
+      Repository repo( satpool.reposFind( it->alias() ) );
+      // The first check prepares the pool, saving does not touch it.
+      if ( ! satpool.repoSolvCacheOutdated( repo ) )
+        continue;
+
+      Pathname solvfile = solv_path_for_repoinfo( _options, *it ) / "solv";
+      try
+      {
+        satpool.saveRepoSolv( repo, solvfile );
+        MIL << "Remember added file provides in " << solvfile << endl;
+      }
+      catch ( const Exception & exp )
+      {
+        ZYPP_CAUGHT( exp );
+        WAR << "Failed to remember added file provides in " << solvfile << endl;
+      }
+    }
+  }
+
+  ////////////////////////////////////////////////////////////////////////////
+
   void RepoManager::Impl::addRepository( const RepoInfo & info, const ProgressData::ReceiverFnc & progressrcv )
   {
     assert_alias(info);
@@ -2241,6 +2313,9 @@ namespace zypp
   void RepoManager::loadFromCache( const RepoInfo &info, const ProgressData::ReceiverFnc & progressrcv )
   { return _pimpl->loadFromCache( info, progressrcv ); }
 
+  void RepoManager::updateSolvCaches()
+  { return _pimpl->updateSolvCaches(); }
+
   void RepoManager::cleanCacheDirGarbage( const ProgressData::ReceiverFnc & progressrcv )
   { return _pimpl->cleanCacheDirGarbage( progressrcv ); }
 
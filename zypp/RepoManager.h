@@ -380,6 +380,16 @@ namespace zypp
    void loadFromCache( const RepoInfo &info,
                        const ProgressData::ReceiverFnc & progressrcv = ProgressData::ReceiverFnc() );
 
+   /**
+    * Let the solv caches of the loaded repos remember the file provides
+    * the pool needs from them, so they need not be searched in the
+    * filelists on the next load.
+    *
+    * Call this once after all repos are loaded. It prepares the pool,
+    * but does not change the loaded repos.
+    */
+   void updateSolvCaches();
+
    /**
     * Remove any subdirectories of cache directories which no longer belong
     * to any of known repositories.
@@ -12,6 +12,7 @@
 #include <iostream>
 //#include "zypp/base/Logger.h"
 
+#include "zypp/base/Easy.h"
 #include "zypp/base/SerialNumber.h"
 
 #include "zypp/ZYppFactory.h"
@@ -60,6 +61,19 @@ namespace zypp
   const SerialNumber & ResPool::serial() const
   { return _pimpl->serial(); }
 
+  void ResPool::prepareForConcurrentReads() const
+  {
+    sat::Pool satpool( sat::Pool::instance() );
+    satpool.setConcurrentReads( true );
+    satpool.prepareForConcurrentReads();
+    _pimpl->prepareForConcurrentReads();
+    ResPoolProxy pproxy( proxy() );
+    for_( it, pproxy.begin(), pproxy.end() )
+    {
+      (*it)->picklistEmpty(); // builds the picklist
+    }
+  }
+
   bool ResPool::empty() const
   { return _pimpl->empty(); }
 
@@ -73,6 +73,12 @@ namespace zypp
        */
       const SerialNumber & serial() const;
 
+      /** Turn on \ref sat::Pool::concurrentReads and build all lazily
+       * computed data of the sat pool, the items and the \ref proxy, so
+       * read-only queries may run in parallel threads.
+       */
+      void prepareForConcurrentReads() const;
+
     public:
       /**  */
       bool empty() const;
@@ -140,6 +140,12 @@ namespace zypp
   solver::detail::ItemCapKindList Resolver::installedSatisfied( const PoolItem & item )
   { return _pimpl->installedSatisfied (item); }
 
+  solver::detail::WhatIfResultList Resolver::whatIfInstall( const solver::detail::PoolItemList & items, unsigned workers )
+  { return _pimpl->whatIfInstall( items, workers ); }
+
+  solver::detail::SolverStatistics Resolver::solverStatistics() const
+  { return _pimpl->solverStatistics(); }
+
   void Resolver::reset()
   { _pimpl->reset( false ); /* Do not keep extra requires/conflicts */ }
 
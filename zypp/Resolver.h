@@ -378,6 +378,45 @@ namespace zypp
      */
     solver::detail::ItemCapKindList installedSatisfied( const PoolItem & item );
 
+    /**
+     * Compute what installing each of \a items would do, one solver
+     * job per item, on top of the installed system and the locks
+     * currently set in the pool.
+     *
+     * Other transactions in the pool are ignored, and the status of
+     * the pool items is not changed. By default all jobs are solved in
+     * the calling process. Passing more than one \a workers (or \c 0 for
+     * one per CPU) solves them in parallel in forked processes, which
+     * share the prepared pool.
+     *
+     * \note Forking is unsafe if \b any other thread of the process is
+     * running, not only threads using the pool: a lock another thread
+     * holds at that moment (e.g. inside \c malloc) stays locked forever
+     * in the worker, and the worker inherits curl and rpm state. Use more
+     * than one worker only in single threaded applications.
+     *
+     * \return One \ref solver::detail::WhatIfResult per item, in order:
+     *		item                The item asked to install.
+     *		solved              Whether the job is solvable.
+     *		toInstall           Items the solution would install.
+     *		toRemove            Installed items the solution would remove.
+     *		problems            Problem descriptions if not solved.
+     */
+    solver::detail::WhatIfResultList whatIfInstall( const solver::detail::PoolItemList & items, unsigned workers = 1 );
+
+    /**
+     * Statistics of the last solver run: number of jobs, rules by type,
+     * decisions, problems and the time spent solving, copying the result
+     * back to the pool and collecting the resolver info (see
+     * \ref isInstalledBy).
+     *
+     * Each run also logs them and, if \ref ZConfig::solver_statisticsFile
+     * is set, appends them to that file as a JSON object.
+     *
+     * \see \ref solver::detail::SolverStatistics::asJson
+     */
+    solver::detail::SolverStatistics solverStatistics() const;
+
 
   private:
     friend std::ostream & operator<<( std::ostream & str, const Resolver & obj );
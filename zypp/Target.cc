@@ -97,6 +97,9 @@ namespace zypp
   std::string Target::whoOwnsFile (const std::string & path_str) const
   { return _pimpl->whoOwnsFile (path_str); }
 
+  std::vector<std::string> Target::whoOwnsFiles( const std::vector<std::string> & paths_r ) const
+  { return _pimpl->whoOwnsFiles( paths_r ); }
+
   std::ostream & Target::dumpOn( std::ostream & str ) const
   { return _pimpl->dumpOn( str ); }
 
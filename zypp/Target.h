@@ -93,6 +93,16 @@ namespace zypp
      **/
     std::string whoOwnsFile (const std::string & path_str) const;
 
+    /** Return names of the packages owning \a paths_r (in order)
+     * or empty strings for paths not owned by an installed package.
+     *
+     * Use this rather than calling \ref whoOwnsFile for many paths. If
+     * the targets \c @System solv cache is up to date, the lookup is done
+     * in an index built once from its filelist, instead of querying the rpm
+     * database for each path.
+     **/
+    std::vector<std::string> whoOwnsFiles( const std::vector<std::string> & paths_r ) const;
+
     /** Return the root set for this target */
     Pathname root() const;
 
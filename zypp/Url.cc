@@ -14,8 +14,8 @@
 #include "zypp/Pathname.h"
 #include "zypp/base/Gettext.h"
 #include "zypp/base/String.h"
-#include "zypp/base/Regex.h"
 #include <stdexcept>
+#include <algorithm>
 #include <iostream>
 
 
@@ -27,21 +27,44 @@ namespace zypp
   using namespace zypp::url;
 
 
-  // -----------------------------------------------------------------
-  /*
-   * url       = [scheme:] [//authority] /path [?query] [#fragment]
-   */
-  #define RX_SPLIT_URL                       "^([^:/?#]+:|)" \
-                                             "(//[^/?#]*|)"  \
-                                             "([^?#]*)"        \
-                                             "([?][^#]*|)"   \
-                                             "(#.*|)"
-
-
   ////////////////////////////////////////////////////////////////////
   namespace
   { //////////////////////////////////////////////////////////////////
 
+    // ---------------------------------------------------------------
+    /*
+     * url       = [scheme:] [//authority] /path [?query] [#fragment]
+     *
+     * Split an url into its 5 components, including their delimiters,
+     * like the groups of "^([^:/?#]+:|)(//[^/?#]*|)([^?#]*)([?][^#]*|)(#.*|)".
+     * Any string can be split.
+     */
+    void splitUrl(const std::string &url, std::string (&out)[5])
+    {
+      std::string::size_type beg = 0;
+      std::string::size_type pos = url.find_first_of(":/?#");
+      if( pos != std::string::npos && pos > 0 && url[pos] == ':')
+      {
+        out[0] = url.substr(0, pos+1);
+        beg = pos+1;
+      }
+      if( url.compare(beg, 2, "//") == 0)
+      {
+        pos = std::min(url.find_first_of("/?#", beg+2), url.size());
+        out[1] = url.substr(beg, pos-beg);
+        beg = pos;
+      }
+      pos = std::min(url.find_first_of("?#", beg), url.size());
+      out[2] = url.substr(beg, pos-beg);
+      if( pos < url.size() && url[pos] == '?')
+      {
+        beg = pos;
+        pos = std::min(url.find('#', beg), url.size());
+        out[3] = url.substr(beg, pos-beg);
+      }
+      out[4] = url.substr(pos);
+    }
+
 
     // ---------------------------------------------------------------
     class LDAPUrl: public UrlBase
@@ -370,29 +393,20 @@ namespace zypp
   Url::parseUrl(const std::string &encodedUrl)
   {
     UrlRef      url;
-    str::smatch out;
-    bool        ret = false;
-
-    try
-    {
-      str::regex  rex(RX_SPLIT_URL);
-      ret = str::regex_match(encodedUrl, out, rex);
-    }
-    catch( ... )
-    {}
+    std::string out[5];
 
-    if(ret && out.size() == 6)
+    splitUrl(encodedUrl, out);
     {
-      std::string scheme = out[1];
+      std::string scheme = out[0];
       if (scheme.size() > 1)
         scheme = scheme.substr(0, scheme.size()-1);
-      std::string authority = out[2];
+      std::string authority = out[1];
       if (authority.size() >= 2)
         authority = authority.substr(2);
-      std::string query = out[4];
+      std::string query = out[3];
       if (query.size() > 1)
         query = query.substr(1);
-      std::string fragment = out[5];
+      std::string fragment = out[4];
       if (fragment.size() > 1)
         fragment = fragment.substr(1);
 
@@ -401,7 +415,7 @@ namespace zypp
       {
         url.reset( new UrlBase());
       }
-      url->init(scheme, authority, out[3],
+      url->init(scheme, authority, out[2],
                 query, fragment);
     }
     return url;
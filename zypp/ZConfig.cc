@@ -276,6 +276,7 @@ namespace zypp
         , updateMessagesNotify		( "single | /usr/lib/zypp/notify-message -p %p" )
         , repo_add_probe          	( false )
         , repo_refresh_delay      	( 10 )
+        , repo_parallelCacheBuild	( false )
         , repoLabelIsAlias              ( false )
         , download_use_deltarpm   	( true )
         , download_use_deltarpm_always  ( false )
@@ -284,6 +285,7 @@ namespace zypp
         , download_min_download_speed	( 0 )
         , download_max_download_speed	( 0 )
         , download_max_silent_tries	( 5 )
+        , download_shared_package_cache_size( 4096 )
         , commit_downloadMode		( DownloadDefault )
         , solver_onlyRequires		( false )
         , solver_allowVendorChange	( false )
@@ -371,6 +373,10 @@ namespace zypp
                 {
                   str::strtonum(value, repo_refresh_delay);
                 }
+                else if ( entry == "repo.parallel_cache_build" )
+                {
+                  repo_parallelCacheBuild = str::strToBool( value, repo_parallelCacheBuild );
+                }
                 else if ( entry == "repo.refresh.locales" )
 		{
 		  std::vector<std::string> tmp;
@@ -410,6 +416,14 @@ namespace zypp
                 {
                   str::strtonum(value, download_max_silent_tries);
                 }
+                else if ( entry == "download.shared_package_cache" )
+                {
+                  download_shared_package_cache = Pathname(value);
+                }
+                else if ( entry == "download.shared_package_cache_size" )
+                {
+                  str::strtonum(value, download_shared_package_cache_size);
+                }
                 else if ( entry == "commit.downloadMode" )
                 {
                   commit_downloadMode.set( deserializeDownloadMode( value ) );
@@ -446,6 +460,10 @@ namespace zypp
                 {
                   solver_checkSystemFile = Pathname(value);
                 }
+                else if ( entry == "solver.statisticsFile" )
+                {
+                  solver_statisticsFile = Pathname(value);
+                }
                 else if ( entry == "multiversion" )
                 {
                   str::split( value, inserter( _multiversion, _multiversion.end() ), ", \t" );
@@ -544,6 +562,7 @@ namespace zypp
 
     bool	repo_add_probe;
     unsigned	repo_refresh_delay;
+    bool	repo_parallelCacheBuild;
     LocaleSet	repoRefreshLocales;
     bool	repoLabelIsAlias;
 
@@ -555,6 +574,8 @@ namespace zypp
     int download_min_download_speed;
     int download_max_download_speed;
     int download_max_silent_tries;
+    Pathname download_shared_package_cache;
+    unsigned download_shared_package_cache_size;
 
     Option<DownloadMode> commit_downloadMode;
 
@@ -565,6 +586,7 @@ namespace zypp
     DefaultOption<bool> solverUpgradeRemoveDroppedPackages;
 
     Pathname solver_checkSystemFile;
+    Pathname solver_statisticsFile;
 
     std::set<std::string> &		multiversion()		{ return getMultiversion(); }
     const std::set<std::string> &	multiversion() const	{ return getMultiversion(); }
@@ -797,6 +819,9 @@ namespace zypp
   unsigned ZConfig::repo_refresh_delay() const
   { return _pimpl->repo_refresh_delay; }
 
+  bool ZConfig::repo_parallelCacheBuild() const
+  { return _pimpl->repo_parallelCacheBuild; }
+
   LocaleSet ZConfig::repoRefreshLocales() const
   { return _pimpl->repoRefreshLocales.empty() ? Target::requestedLocales("") :_pimpl->repoRefreshLocales; }
 
@@ -833,6 +858,12 @@ namespace zypp
   long ZConfig::download_max_silent_tries() const
   { return _pimpl->download_max_silent_tries; }
 
+  Pathname ZConfig::download_sharedPackageCachePath() const
+  { return _pimpl->download_shared_package_cache; }
+
+  ByteCount ZConfig::download_sharedPackageCacheSize() const
+  { return ByteCount( _pimpl->download_shared_package_cache_size, ByteCount::MB ); }
+
   DownloadMode ZConfig::commit_downloadMode() const
   { return _pimpl->commit_downloadMode; }
 
@@ -852,6 +883,9 @@ namespace zypp
   unsigned ZConfig::solver_upgradeTestcasesToKeep() const
   { return _pimpl->solver_upgradeTestcasesToKeep; }
 
+  Pathname ZConfig::solver_statisticsFile() const
+  { return _pimpl->solver_statisticsFile; }
+
   bool ZConfig::solverUpgradeRemoveDroppedPackages() const		{ return _pimpl->solverUpgradeRemoveDroppedPackages; }
   void ZConfig::setSolverUpgradeRemoveDroppedPackages( bool val_r )	{ _pimpl->solverUpgradeRemoveDroppedPackages.set( val_r ); }
   void ZConfig::resetSolverUpgradeRemoveDroppedPackages()		{ _pimpl->solverUpgradeRemoveDroppedPackages.restoreToDefault(); }
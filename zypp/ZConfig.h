@@ -23,6 +23,7 @@
 #include "zypp/Arch.h"
 #include "zypp/Locale.h"
 #include "zypp/Pathname.h"
+#include "zypp/ByteCount.h"
 #include "zypp/IdString.h"
 
 #include "zypp/DownloadMode.h"
@@ -181,6 +182,15 @@ namespace zypp
        */
       unsigned repo_refresh_delay() const;
 
+      /**
+       * Whether to build the solv cache of rpm-md repos in process,
+       * converting independent metadata files concurrently (instead
+       * of running repo2solv.sh).
+       * Config option <tt>repo.parallel_cache_build (false)</tt>
+       * \see \ref repo::yum::SolvBuilder
+       */
+      bool repo_parallelCacheBuild() const;
+
       /**
        * List of locales for which translated package descriptions should be downloaded.
        */
@@ -223,6 +233,20 @@ namespace zypp
        */
       long download_max_silent_tries() const;
 
+      /**
+       * Directory of the package cache shared by all repos and roots
+       * (empty if disabled).
+       * Config option <tt>download.shared_package_cache</tt>
+       * \see \ref repo::SharedPackageCache
+       */
+      Pathname download_sharedPackageCachePath() const;
+
+      /**
+       * Size budget of the shared package cache (\c 0: no limit).
+       * Config option <tt>download.shared_package_cache_size (4096 MB)</tt>
+       */
+      ByteCount download_sharedPackageCacheSize() const;
+
 
       /** Whether to consider using a deltarpm when downloading a package.
        * Config option <tt>download.use_deltarpm (true)</tt>
@@ -293,6 +317,13 @@ namespace zypp
        */
       unsigned solver_upgradeTestcasesToKeep() const;
 
+      /**
+       * File to which the statistics of each solver run are appended,
+       * one JSON object per line. Empty if not wanted (the default).
+       * \see \ref Resolver::solverStatistics
+       */
+      Pathname solver_statisticsFile() const;
+
       /** Whether dist upgrade should remove a products dropped packages (true).
        *
        * A new product may suggest a list of old and no longer supported
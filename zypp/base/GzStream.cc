@@ -16,10 +16,14 @@
   Maintainer: Michael Andres <ma@suse.de>
 
   Purpose: Streams reading and writing gzip files.
+           Reading xz and zstd compressed files is supported
+           if libzypp is built with liblzma and libzstd.
 
 /-*/
 
 #include <cerrno>
+#include <cstring>
+#include <algorithm>
 #include <iostream>
 #include "zypp/base/LogControl.h"
 #include "zypp/base/LogTools.h"
@@ -30,6 +34,14 @@ using std::endl;
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <unistd.h>
+
+#ifdef HAVE_LZMA
+#include <lzma.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
 
 ///////////////////////////////////////////////////////////////////
 namespace zypp
@@ -59,12 +71,276 @@ namespace zypp
       return ret;
     }
 
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : fgzstreambuf::Decoder
+    //
+    /** Base class for the xz and zstd decoders.
+     *
+     * Reads the compressed data from \a fd_r into an input buffer and
+     * feeds it to the derived class' \ref decode. Tracks the position
+     * in the uncompressed data, so seek can be emulated.
+     */
+    class fgzstreambuf::Decoder
+    {
+    public:
+      Decoder( int fd_r, unsigned bufferSize_r )
+      : _fd( fd_r )
+      , _in( bufferSize_r )
+      , _inPos( 0 )
+      , _inEnd( 0 )
+      , _inEof( false )
+      , _end( false )
+      , _pos( 0 )
+      {}
+
+      virtual ~Decoder()
+      {}
+
+      /** Decompress up to \a maxcount_r bytes.
+       * \return The number of bytes read, \c 0 at EOF, \c -1 on error.
+       */
+      std::streamsize read( char * buffer_r, std::streamsize maxcount_r, ZlibError & error_r )
+      {
+        while ( true )
+        {
+          if ( _inPos == _inEnd && ! _inEof )
+          {
+            ssize_t got = ::read( _fd, &_in[0], _in.size() );
+            if ( got < 0 )
+            {
+              if ( errno == EINTR )
+                continue;
+              error_r._zError = Z_ERRNO;
+              error_r._errno = errno;
+              return -1;
+            }
+            _inPos = 0;
+            _inEnd = got;
+            _inEof = ( got == 0 );
+          }
+
+          std::streamsize got = decode( buffer_r, maxcount_r );
+          if ( got > 0 )
+          {
+            _pos += got;
+            return got;
+          }
+          if ( got < 0 )
+          {
+            error_r._zError = Z_DATA_ERROR;
+            return -1;
+          }
+          if ( _end )
+            return 0;
+          if ( _inEof && _inPos == _inEnd )
+          {
+            // truncated file
+            error_r._zError = Z_BUF_ERROR;
+            return -1;
+          }
+        }
+      }
+
+      /** Restart reading at the beginning of the file. */
+      bool rewind()
+      {
+        if ( ::lseek( _fd, 0, SEEK_SET ) != 0 || ! reset() )
+          return false;
+        _inPos = _inEnd = 0;
+        _inEof = _end = false;
+        _pos = 0;
+        return true;
+      }
+
+      /** Position in the uncompressed data. */
+      off_t tell() const
+      { return _pos; }
+
+    protected:
+      /** Decompress the pending input into \a buffer_r.
+       * Advance \c _inPos and set \c _end if the data are complete.
+       * \return The number of bytes decoded, \c -1 on error.
+       */
+      virtual std::streamsize decode( char * buffer_r, std::streamsize maxcount_r ) = 0;
+
+      /** Reset the decoder state. */
+      virtual bool reset() = 0;
+
+    protected:
+      int               _fd;
+      std::vector<char> _in;
+      size_t            _inPos;
+      size_t            _inEnd;
+      bool              _inEof;
+      bool              _end;
+      off_t             _pos;
+    };
+    ///////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    namespace
+    { /////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_LZMA
+      /** Decoder for xz (and concatenated xz) files. */
+      class XzDecoder : public fgzstreambuf::Decoder
+      {
+      public:
+        XzDecoder( int fd_r, unsigned bufferSize_r )
+        : Decoder( fd_r, bufferSize_r )
+        , _ok( init() )
+        {}
+
+        virtual ~XzDecoder()
+        { ::lzma_end( &_strm ); }
+
+        bool ok() const
+        { return _ok; }
+
+      protected:
+        virtual std::streamsize decode( char * buffer_r, std::streamsize maxcount_r )
+        {
+          _strm.next_in   = reinterpret_cast<const uint8_t *>( _in.data() + _inPos );
+          _strm.avail_in  = _inEnd - _inPos;
+          _strm.next_out  = reinterpret_cast<uint8_t *>( buffer_r );
+          _strm.avail_out = maxcount_r;
+
+          lzma_ret ret = ::lzma_code( &_strm, ( _inEof ? LZMA_FINISH : LZMA_RUN ) );
+          _inPos = _inEnd - _strm.avail_in;
+          if ( ret == LZMA_STREAM_END )
+            _end = true;
+          else if ( ret != LZMA_OK )
+          {
+            ERR << "lzma_code error " << ret << endl;
+            return -1;
+          }
+          return maxcount_r - _strm.avail_out;
+        }
+
+        virtual bool reset()
+        {
+          ::lzma_end( &_strm );
+          return( _ok = init() );
+        }
+
+      private:
+        bool init()
+        {
+          static const lzma_stream initStrm = LZMA_STREAM_INIT;
+          _strm = initStrm;
+          return( ::lzma_stream_decoder( &_strm, UINT64_MAX, LZMA_CONCATENATED ) == LZMA_OK );
+        }
+
+      private:
+        lzma_stream _strm;
+        bool        _ok;
+      };
+#endif // HAVE_LZMA
+
+#ifdef HAVE_ZSTD
+      /** Decoder for zstd (and concatenated zstd) files. */
+      class ZstdDecoder : public fgzstreambuf::Decoder
+      {
+      public:
+        ZstdDecoder( int fd_r, unsigned bufferSize_r )
+        : Decoder( fd_r, bufferSize_r )
+        , _dstream( ::ZSTD_createDStream() )
+        , _frameDone( false )
+        {
+          if ( _dstream )
+            ::ZSTD_initDStream( _dstream );
+        }
+
+        virtual ~ZstdDecoder()
+        {
+          if ( _dstream )
+            ::ZSTD_freeDStream( _dstream );
+        }
+
+        bool ok() const
+        { return _dstream; }
+
+      protected:
+        virtual std::streamsize decode( char * buffer_r, std::streamsize maxcount_r )
+        {
+          ZSTD_inBuffer  in  = { _in.data() + _inPos, _inEnd - _inPos, 0 };
+          ZSTD_outBuffer out = { buffer_r, size_t(maxcount_r), 0 };
+
+          size_t ret = ::ZSTD_decompressStream( _dstream, &out, &in );
+          if ( ::ZSTD_isError( ret ) )
+          {
+            ERR << "ZSTD_decompressStream: " << ::ZSTD_getErrorName( ret ) << endl;
+            return -1;
+          }
+          _inPos += in.pos;
+          if ( in.pos || out.pos )
+            _frameDone = ( ret == 0 );
+          // A frame may be followed by the next one.
+          if ( _frameDone && _inEof && _inPos == _inEnd )
+            _end = true;
+          return out.pos;
+        }
+
+        virtual bool reset()
+        {
+          _frameDone = false;
+          return( _dstream && ! ::ZSTD_isError( ::ZSTD_initDStream( _dstream ) ) );
+        }
+
+      private:
+        ZSTD_DStream * _dstream;
+        bool           _frameDone;
+      };
+#endif // HAVE_ZSTD
+
+      /** Create a decoder if \a fd_r is a xz or zstd file we can read.
+       * The file offset is left at the beginning of the file.
+       */
+      fgzstreambuf::Decoder * makeDecoder( int fd_r, unsigned bufferSize_r )
+      {
+        unsigned char magic[6] = { 0, 0, 0, 0, 0, 0 };
+        ssize_t got = ::read( fd_r, magic, sizeof(magic) );
+        if ( ::lseek( fd_r, 0, SEEK_SET ) != 0 || got < 4 )
+          return 0;
+
+#ifdef HAVE_LZMA
+        static const unsigned char xzMagic[6] = { 0xFD, '7', 'z', 'X', 'Z', 0x00 };
+        if ( got == 6 && ::memcmp( magic, xzMagic, 6 ) == 0 )
+        {
+          XzDecoder * ret = new XzDecoder( fd_r, bufferSize_r );
+          if ( ret->ok() )
+            return ret;
+          delete ret;
+          return 0;
+        }
+#endif
+#ifdef HAVE_ZSTD
+        static const unsigned char zstdMagic[4] = { 0x28, 0xB5, 0x2F, 0xFD };
+        if ( ::memcmp( magic, zstdMagic, 4 ) == 0 )
+        {
+          ZstdDecoder * ret = new ZstdDecoder( fd_r, bufferSize_r );
+          if ( ret->ok() )
+            return ret;
+          delete ret;
+          return 0;
+        }
+#endif
+        return 0;
+      }
+
+      /////////////////////////////////////////////////////////////////
+    } // namespace
+    ///////////////////////////////////////////////////////////////////
+
     ///////////////////////////////////////////////////////////////////
     //
     //	CLASS NAME : fgzstreambuf
     //
     ///////////////////////////////////////////////////////////////////
 
+    const unsigned fgzstreambuf::defaultBufferSize;
+
     ///////////////////////////////////////////////////////////////////
     //
     //	METHOD NAME : fgzstreambuf::open
@@ -80,7 +356,10 @@ namespace zypp
           if ( mode_r == std::ios_base::in )
 	  {
             _fd = ::open( name_r, O_RDONLY | O_CLOEXEC );
-            _file = gzdopen( _fd, "rb" );
+            if ( _fd != -1 )
+              _decoder.reset( makeDecoder( _fd, _buffer.size() ) );
+            if ( ! _decoder )
+              _file = gzdopen( _fd, "rb" );
 	  }
           else if ( mode_r == std::ios_base::out )
 	  {
@@ -88,6 +367,11 @@ namespace zypp
             _file = gzdopen( _fd, "wb" );
 	  }
           // else: not supported
+#if ZLIB_VERNUM >= 0x1240
+          // zlibs own buffer defaults to 8K
+          if ( _file )
+            gzbuffer( _file, _buffer.size() );
+#endif
 
           if ( isOpen() )
             {
@@ -125,14 +409,27 @@ namespace zypp
           bool failed = false;
           if ( sync() != 0 )
             failed = true;
-	  // it also closes _fd, fine
-          int r = gzclose( _file );
-          if ( r != Z_OK )
+          if ( _decoder )
             {
-              failed = true;
-              // DONT call setZError() here, as _file is no longer valid
-              _error._zError = r;
-              _error._errno = errno;
+              _decoder.reset();
+              if ( ::close( _fd ) != 0 )
+                {
+                  failed = true;
+                  _error._zError = Z_ERRNO;
+                  _error._errno = errno;
+                }
+            }
+          else
+            {
+	      // it also closes _fd, fine
+              int r = gzclose( _file );
+              if ( r != Z_OK )
+                {
+                  failed = true;
+                  // DONT call setZError() here, as _file is no longer valid
+                  _error._zError = r;
+                  _error._errno = errno;
+                }
             }
 
           // Reset everything
@@ -231,6 +528,9 @@ namespace zypp
     std::streamsize
     fgzstreambuf::zReadTo( char * buffer_r, std::streamsize maxcount_r )
     {
+      if ( _decoder )
+        return _decoder->read( buffer_r, maxcount_r, _error );
+
       int read = gzread( _file, buffer_r, maxcount_r );
       if ( read < 0 )
         setZError();
@@ -262,6 +562,26 @@ namespace zypp
     fgzstreambuf::pos_type
     fgzstreambuf::zSeekTo( off_type off_r, std::ios_base::seekdir way_r )
     {
+      if ( _decoder )
+        {
+          // Emulated: rewind if necessary and read forward.
+          off_type target = off_r;
+          if ( way_r == std::ios_base::cur )
+            target += _decoder->tell();
+          else if ( way_r != std::ios_base::beg )
+            return pos_type(off_type(-1));
+          if ( target < 0 || ( target < _decoder->tell() && ! _decoder->rewind() ) )
+            return pos_type(off_type(-1));
+          // the get area was invalidated by seekTo, so _buffer is free
+          while ( _decoder->tell() < target )
+            {
+              std::streamsize chunk = std::min( off_type(_buffer.size()), target - off_type(_decoder->tell()) );
+              if ( _decoder->read( &(_buffer[0]), chunk, _error ) <= 0 )
+                return pos_type(off_type(-1));
+            }
+          return pos_type(target);
+        }
+
       z_off_t ret = gzseek( _file, off_r, way_r );
       if ( ret == -1 )
         setZError();
@@ -276,6 +596,9 @@ namespace zypp
     fgzstreambuf::pos_type
     fgzstreambuf::zTell()
     {
+      if ( _decoder )
+        return _decoder->tell();
+
       z_off_t ret = gztell( _file );
       if ( ret == -1 )
         setZError();
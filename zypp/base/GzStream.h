@@ -16,6 +16,8 @@
   Maintainer: Michael Andres <ma@suse.de>
 
   Purpose: Streams reading and writing gzip files.
+           Reading xz and zstd compressed files is supported
+           if libzypp is built with liblzma and libzstd.
 
 /-*/
 #ifndef ZYPP_BASE_GZSTREAM_H
@@ -26,6 +28,8 @@
 #include <vector>
 #include <zlib.h>
 
+#include "zypp/base/PtrTypes.h"
+
 ///////////////////////////////////////////////////////////////////
 namespace zypp
 { /////////////////////////////////////////////////////////////////
@@ -79,7 +83,15 @@ namespace zypp
      * backward seek in read mode might be expensive).Putback is not
      * supported.
      *
-     * Reading plain (no gziped) files is possible as well.
+     * Reading plain (no gziped) files is possible as well. In read mode
+     * xz and zstd compressed files are recognized by their magic bytes
+     * and decoded if libzypp was built with liblzma or libzstd. For
+     * those seek is emulated by reading forward (and rewinding if
+     * necessary); seeking relative to the end is not supported.
+     *
+     * \a bufferSize_r is the size of the streambufs get/put area and
+     * of the buffer used for reading the compressed data. Large buffers
+     * reduce the per character overhead when parsing big metadata files.
      *
      * This streambuf is used in @ref ifgzstream and  @ref ofgzstream.
      **/
@@ -87,7 +99,10 @@ namespace zypp
 
     public:
 
-      fgzstreambuf( unsigned bufferSize_r = 512 )
+      /** Default size of the internal buffers. */
+      static const unsigned defaultBufferSize = 64 * 1024;
+
+      fgzstreambuf( unsigned bufferSize_r = defaultBufferSize )
       : _fd( -1 )
       ,_file( NULL )
       , _mode( std::ios_base::openmode(0) )
@@ -100,7 +115,7 @@ namespace zypp
 
       bool
       isOpen() const
-      { return _file; }
+      { return _file || _decoder; }
 
       bool
       inReadMode() const
@@ -127,6 +142,10 @@ namespace zypp
         zError() const
         { return _error; }
 
+    public:
+      /** \internal Decoder for xz and zstd files (read mode only). */
+      class Decoder;
+
     protected:
 
       virtual int
@@ -161,6 +180,9 @@ namespace zypp
 
       ZlibError                _error;
 
+      //! xz/zstd decoder (binary incompatible since 12.12, see VERSION.cmake)
+      shared_ptr<Decoder>      _decoder;
+
     private:
 
       void
@@ -213,6 +235,12 @@ namespace zypp
         : stream_type( NULL )
         { this->init( &_streambuf ); this->open( file_r ); }
 
+        /** Ctor using \a bufferSize_r instead of the streambufs default. */
+        fXstream( const char * file_r, unsigned bufferSize_r )
+        : stream_type( NULL )
+        , _streambuf( bufferSize_r )
+        { this->init( &_streambuf ); this->open( file_r ); }
+
         virtual
         ~fXstream()
         {}
@@ -270,7 +298,8 @@ namespace zypp
   ///////////////////////////////////////////////////////////////////
 
   /**
-   * istream reading gzip files as well as plain files.
+   * istream reading gzip files as well as plain files
+   * (and xz or zstd files if support was compiled in).
    **/
   typedef gzstream_detail::fXstream<std::istream,gzstream_detail::fgzstreambuf> ifgzstream;
 
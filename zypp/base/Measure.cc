@@ -18,6 +18,7 @@ extern "C"
 
 #include "zypp/base/Logger.h"
 #include "zypp/base/Measure.h"
+#include "zypp/base/Trace.h"
 #include "zypp/base/String.h"
 
 using std::endl;
@@ -142,6 +143,7 @@ namespace zypp
       : _ident  ( ident_r )
       , _level  ( _glevel )
       , _seq    ( 0 )
+      , _span   ( ident_r, "measure" )
       {
 	_glevel += "..";
         INT << _level << "START MEASURE(" << _ident << ")" << endl;
@@ -192,6 +194,7 @@ namespace zypp
       mutable unsigned _seq;
       mutable Tm       _elapsed;
       mutable Tm       _stop;
+      TraceSpan        _span;
     };
 
     std::string Measure::Impl::_glevel;
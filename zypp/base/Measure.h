@@ -64,6 +64,9 @@ namespace zypp
      * // ELAPSED(Parse)  0 (u 0.17 s 0.02 c 0.00) [ 0 (u 0.02 s 0.00 c 0.00)]
      * // MEASURE(Parse)  0 (u 0.17 s 0.02 c 0.00) [ 0 (u 0.00 s 0.00 c 0.00)]
      * \endcode
+     *
+     * If tracing is enabled (see \ref TraceSpan), each timer is also
+     * recorded as a span in the trace file.
     */
     class Measure
     {
@@ -0,0 +1,248 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/base/Trace.cc
+ *
+*/
+extern "C"
+{
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <time.h>
+}
+#include <iostream>
+#include <fstream>
+
+#include "zypp/base/Easy.h"
+#include "zypp/base/Logger.h"
+#include "zypp/base/String.h"
+#include "zypp/base/Trace.h"
+#include "zypp/thread/Mutex.h"
+#include "zypp/thread/MutexLock.h"
+
+using std::endl;
+
+#undef ZYPP_BASE_LOGGER_LOGGROUP
+#define ZYPP_BASE_LOGGER_LOGGROUP "Trace"
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace debug
+  { /////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    namespace
+    { /////////////////////////////////////////////////////////////////
+
+      /** Monotonic timestamp in microseconds. */
+      inline long long nowUs()
+      {
+        struct timespec ts;
+        ::clock_gettime( CLOCK_MONOTONIC, &ts );
+        return (long long)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+      }
+
+      /** Kernel thread id. */
+      inline long threadId()
+      { return ::syscall( SYS_gettid ); }
+
+      /** Quote and escape a JSON string. */
+      std::string jsonString( const std::string & str_r )
+      {
+        std::string ret( "\"" );
+        for_( ch, str_r.begin(), str_r.end() )
+        {
+          switch ( *ch )
+          {
+            case '"':  ret += "\\\""; break;
+            case '\\': ret += "\\\\"; break;
+            case '\n': ret += "\\n";  break;
+            case '\t': ret += "\\t";  break;
+            default:
+              if ( (unsigned char)*ch < 0x20 )
+                ret += str::form( "\\u%04x", (unsigned char)*ch );
+              else
+                ret += *ch;
+              break;
+          }
+        }
+        return ret += "\"";
+      }
+
+      /** Set when the \ref TraceWriter was destroyed at exit (POD, so it outlives it). */
+      bool writerDestroyed = false;
+
+      ///////////////////////////////////////////////////////////////////
+      /** Writes the trace events to the \c ZYPP_TRACE file. */
+      class TraceWriter
+      {
+      public:
+        /** The writer or \c NULL, if spans end during static destruction after it is gone. */
+        static TraceWriter * instance()
+        {
+          if ( writerDestroyed )
+            return 0;
+          static TraceWriter _instance;
+          return &_instance;
+        }
+
+        bool enabled() const
+        { return _enabled; }
+
+        void write( const std::string & event_r )
+        {
+          thread::MutexLock lock( _mutex );
+          if ( ! _enabled )
+            return;
+          _file << ",\n" << event_r;
+        }
+
+      private:
+        TraceWriter()
+        : _enabled( false )
+        {
+          const char * env = ::getenv( "ZYPP_TRACE" );
+          if ( ! ( env && *env ) )
+            return;
+
+          std::string path( env );
+          std::string::size_type pos = path.find( "%p" );
+          if ( pos != std::string::npos )
+            path.replace( pos, 2, str::numstring( ::getpid() ) );
+
+          _file.open( path.c_str(), std::ios_base::out|std::ios_base::trunc );
+          if ( ! _file.is_open() )
+          {
+            ERR << "Can't open trace file " << path << endl;
+            return;
+          }
+          MIL << "Writing trace to " << path << endl;
+          _enabled = true;
+          _file << "[\n" << str::form( "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"libzypp\"}}", ::getpid() );
+        }
+
+        ~TraceWriter()
+        {
+          thread::MutexLock lock( _mutex );
+          if ( _enabled )
+          {
+            _file << "\n]" << endl;
+            _enabled = false;
+          }
+          writerDestroyed = true;
+        }
+
+      private:
+        bool          _enabled;
+        std::ofstream _file;
+        thread::Mutex _mutex;
+      };
+      ///////////////////////////////////////////////////////////////////
+
+      /////////////////////////////////////////////////////////////////
+    } // namespace
+    ///////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : TraceSpan::Impl
+    //
+    /** TraceSpan implementation. */
+    class TraceSpan::Impl
+    {
+    public:
+      Impl( const std::string & name_r, const char * category_r )
+      : _name( name_r )
+      , _category( category_r ? category_r : "zypp" )
+      , _tid( threadId() )
+      , _start( nowUs() )
+      {}
+
+      ~Impl()
+      {
+        long long dur = nowUs() - _start;
+        std::string event( "{\"name\":" );
+        event += jsonString( _name );
+        event += ",\"cat\":";
+        event += jsonString( _category );
+        event += str::form( ",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":%d,\"tid\":%ld", _start, dur, ::getpid(), _tid );
+        if ( ! _args.empty() )
+        {
+          event += ",\"args\":{";
+          event += _args;
+          event += "}";
+        }
+        event += "}";
+        TraceWriter * writer( TraceWriter::instance() );
+        if ( writer )
+          writer->write( event );
+      }
+
+      void attr( const std::string & key_r, const std::string & jsonValue_r )
+      {
+        if ( ! _args.empty() )
+          _args += ",";
+        _args += jsonString( key_r );
+        _args += ":";
+        _args += jsonValue_r;
+      }
+
+    private:
+      std::string _name;
+      std::string _category;
+      std::string _args;
+      long        _tid;
+      long long   _start;
+    };
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : TraceSpan
+    //
+    ///////////////////////////////////////////////////////////////////
+
+    TraceSpan::TraceSpan( const std::string & name_r, const char * category_r )
+    {
+      if ( enabled() )
+        _pimpl.reset( new Impl( name_r, category_r ) );
+    }
+
+    TraceSpan::~TraceSpan()
+    {}
+
+    bool TraceSpan::enabled()
+    {
+      TraceWriter * writer( TraceWriter::instance() );
+      return writer && writer->enabled();
+    }
+
+    TraceSpan & TraceSpan::attr( const std::string & key_r, const std::string & value_r )
+    {
+      if ( _pimpl )
+        _pimpl->attr( key_r, jsonString( value_r ) );
+      return *this;
+    }
+
+    TraceSpan & TraceSpan::attr( const std::string & key_r, long long value_r )
+    {
+      if ( _pimpl )
+        _pimpl->attr( key_r, str::numstring( value_r ) );
+      return *this;
+    }
+
+    void TraceSpan::stop()
+    { _pimpl.reset(); }
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace debug
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
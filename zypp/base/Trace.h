@@ -0,0 +1,97 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/base/Trace.h
+ *
+*/
+#ifndef ZYPP_BASE_TRACE_H
+#define ZYPP_BASE_TRACE_H
+
+#include <string>
+
+#include "zypp/base/NonCopyable.h"
+#include "zypp/base/PtrTypes.h"
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace debug
+  { /////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : TraceSpan
+    //
+    /** Scoped tracing span written to a Chrome trace file.
+     *
+     * Tracing is enabled by setting \c ZYPP_TRACE to the path of the
+     * trace file (a \c %p in the path is replaced by the process id).
+     * The file is written in Chrome trace event format and can be
+     * loaded into \c chrome://tracing or https://ui.perfetto.dev.
+     *
+     * A span starts on construction and ends when it goes out of scope
+     * (or on \ref stop). Spans record the thread they ran in; spans
+     * started within another span on the same thread appear nested.
+     * Attributes like repo alias, url, package name or number of bytes
+     * can be attached and are shown as the events \c args.
+     *
+     * If tracing is disabled, a span does nothing. Use \ref active to
+     * avoid computing expensive attribute values in vain.
+     *
+     * \code
+     *   debug::TraceSpan span( "RepoManager::refreshMetadata" );
+     *   span.attr( "alias", info.alias() );
+     *   ...
+     *   if ( span.active() )
+     *     span.attr( "url", url.asString() );
+     * \endcode
+     *
+     * \see \ref Measure, which also creates a span if tracing is enabled.
+     */
+    class TraceSpan : private base::NonCopyable
+    {
+    public:
+      /** Ctor starts the span \a name_r (if tracing is enabled). */
+      explicit
+      TraceSpan( const std::string & name_r, const char * category_r = "zypp" );
+
+      /** Dtor ends the span. */
+      ~TraceSpan();
+
+    public:
+      /** Whether tracing is enabled via \c ZYPP_TRACE. */
+      static bool enabled();
+
+      /** Whether this span is recorded. */
+      bool active() const
+      { return _pimpl.get(); }
+
+      /** Add a string attribute. */
+      TraceSpan & attr( const std::string & key_r, const std::string & value_r );
+      /** \overload numeric attribute */
+      TraceSpan & attr( const std::string & key_r, long long value_r );
+
+      /** End the span now. */
+      void stop();
+
+    private:
+      /** Implementation. */
+      class Impl;
+      /** Pointer to implementation (\c NULL if not \ref active). */
+      scoped_ptr<Impl> _pimpl;
+    };
+    ///////////////////////////////////////////////////////////////////
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace debug
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_BASE_TRACE_H
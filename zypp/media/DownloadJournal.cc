@@ -0,0 +1,214 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/media/DownloadJournal.cc
+ *
+*/
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+#include "zypp/base/Logger.h"
+#include "zypp/base/Easy.h"
+
+#include "zypp/AutoDispose.h"
+#include "zypp/Digest.h"
+#include "zypp/PathInfo.h"
+#include "zypp/TmpPath.h"
+#include "zypp/ZConfig.h"
+
+#include "zypp/media/DownloadJournal.h"
+
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace media
+  { /////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : DownloadJournal
+    //
+    ///////////////////////////////////////////////////////////////////
+
+    DownloadJournal::DownloadJournal( const std::string & key_r, const Pathname & dir_r )
+    {
+      std::string name( Digest::digest( Digest::sha1(), key_r ) );
+      _partFile = dir_r / ( name + ".part.zypp" );
+      _journalFile = dir_r / ( name + ".journal.zypp" );
+    }
+
+    Pathname DownloadJournal::defaultDir()
+    { return ZConfig::instance().repoCachePath() / "partial"; }
+
+    bool DownloadJournal::load()
+    {
+      _url.clear();
+      _validator.clear();
+      _blocks.clear();
+
+      if ( ! PathInfo( _journalFile ).isFile() )
+        return false;
+      if ( ! PathInfo( _partFile ).isFile() )
+      {
+        WAR << "Missing " << _partFile << endl;
+        return false;
+      }
+
+      std::ifstream infile( _journalFile.c_str() );
+      for( std::string line; std::getline( infile, line ); )
+      {
+        if ( line.empty() || line[0] == '#' )
+          continue;
+        std::string::size_type sep( line.find( ' ' ) );
+        std::string key( line.substr( 0, sep ) );
+        std::string val( sep == std::string::npos ? std::string() : line.substr( sep+1 ) );
+        if ( key == "url" )
+          _url = val;
+        else if ( key == "validator" )
+          _validator = val;
+        else if ( key == "block" )
+        {
+          std::istringstream l( val );
+          long long off = 0;
+          unsigned long long size = 0;
+          if ( l >> off >> size )
+            _blocks.push_back( MediaBlock( off, size ) );
+        }
+        else
+          WAR << _journalFile << ": ignore unknown line '" << line << "'" << endl;
+      }
+      if ( _validator.empty() && _blocks.empty() )
+        return false;
+      DBG << *this << endl;
+      return true;
+    }
+
+    bool DownloadJournal::save() const
+    {
+      if ( filesystem::assert_dir( _journalFile.dirname() ) != 0 )
+        return false;
+      filesystem::TmpFile tmp( filesystem::TmpFile::makeSibling( _journalFile ) );
+      if ( ! tmp )
+        return false;
+      {
+        std::ofstream outfile( tmp.path().c_str() );
+        outfile << "# partial download " << _partFile.basename() << endl;
+        if ( ! _url.empty() )
+          outfile << "url " << _url << endl;
+        if ( ! _validator.empty() )
+          outfile << "validator " << _validator << endl;
+        for_( it, _blocks.begin(), _blocks.end() )
+          outfile << "block " << (long long)it->off << " " << (unsigned long long)it->size << endl;
+        if ( ! outfile )
+        {
+          WAR << "Can't write " << tmp.path() << endl;
+          return false;
+        }
+      }
+      return filesystem::rename( tmp.path(), _journalFile ) == 0;
+    }
+
+    void DownloadJournal::remove()
+    {
+      if ( PathInfo( _journalFile ).isExist() )
+        filesystem::unlink( _journalFile );
+      if ( PathInfo( _partFile ).isExist() )
+        filesystem::unlink( _partFile );
+      _copyFrom = Pathname();
+      _url.clear();
+      _validator.clear();
+      _blocks.clear();
+    }
+
+    void DownloadJournal::link( const Pathname & tmpfile_r )
+    {
+      _copyFrom = Pathname();
+      if ( filesystem::hardlink( tmpfile_r, _partFile ) != 0 )
+      {
+        DBG << "Can't link " << tmpfile_r << " to " << _partFile << "; will copy it on failure" << endl;
+        _copyFrom = tmpfile_r;
+      }
+    }
+
+    bool DownloadJournal::start( const Pathname & tmpfile_r )
+    {
+      remove();
+      if ( filesystem::assert_dir( _partFile.dirname() ) != 0 )
+      {
+        WAR << "Can't create " << _partFile.dirname() << endl;
+        return false;
+      }
+      link( tmpfile_r );
+      return true;
+    }
+
+    bool DownloadJournal::resume( const Pathname & tmpfile_r, FILE * file_r )
+    {
+      {
+        AutoDispose<FILE*> part( ::fopen( _partFile.c_str(), "re" ), ::fclose );
+        if ( part == NULL )
+        {
+          part.resetDispose();
+          WAR << "Can't open " << _partFile << endl;
+          return false;
+        }
+        char buf[16384];
+        for ( size_t n = ::fread( buf, 1, sizeof(buf), part ); n; n = ::fread( buf, 1, sizeof(buf), part ) )
+        {
+          if ( ::fwrite( buf, 1, n, file_r ) != n )
+          {
+            WAR << "Can't copy " << _partFile << " to " << tmpfile_r << endl;
+            return false;
+          }
+        }
+        if ( ::ferror( part ) || ::fflush( file_r ) != 0 )
+        {
+          WAR << "Can't copy " << _partFile << " to " << tmpfile_r << endl;
+          return false;
+        }
+      }
+      filesystem::unlink( _partFile );
+      link( tmpfile_r );
+      return true;
+    }
+
+    bool DownloadJournal::keep()
+    {
+      if ( ! _copyFrom.empty() )
+      {
+        if ( filesystem::copy( _copyFrom, _partFile ) != 0 )
+        {
+          WAR << "Can't copy " << _copyFrom << " to " << _partFile << endl;
+          remove();
+          return false;
+        }
+        _copyFrom = Pathname();
+      }
+      return save();
+    }
+
+    std::ostream & operator<<( std::ostream & str, const DownloadJournal & obj )
+    {
+      str << "DownloadJournal(" << obj._partFile << ")";
+      if ( ! obj._validator.empty() )
+        str << "{" << obj._url << " " << obj._validator << "}";
+      if ( ! obj._blocks.empty() )
+        str << "{" << obj._blocks.size() << " blocks}";
+      return str;
+    }
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace media
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,152 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/media/DownloadJournal.h
+ *
+*/
+#ifndef ZYPP_MEDIA_DOWNLOADJOURNAL_H
+#define ZYPP_MEDIA_DOWNLOADJOURNAL_H
+
+#include <cstdio>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "zypp/Pathname.h"
+#include "zypp/media/MediaBlockList.h"
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace media
+  { /////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : DownloadJournal
+    //
+    /** Partial download of a file, to be resumed by a later attempt.
+     *
+     * The journal is kept in a stable directory (\ref defaultDir, below
+     * the repo cache), named after the download \c key (usually the URL),
+     * so it survives the media handler and its attach point.
+     *
+     * While downloading, the temporary file is hardlinked to
+     * \ref partFile (\c <sha1 of key>.part.zypp), and the \ref journalFile
+     * (\c <sha1 of key>.journal.zypp) tells what can be reused of it:
+     *
+     * \li For plain HTTP downloads the \ref url and the \ref validator
+     * (a strong \c ETag or \c Last-Modified) of the response. The data
+     * written to \ref partFile are a prefix of the file, to be continued
+     * by a range request, if the server still reports the same validator.
+     *
+     * \li For metalink downloads the \ref blocks which were verified by
+     * their checksums. They are copied (and verified again) from
+     * \ref partFile, if the metalink lists a block of the same range.
+     *
+     * If the process dies, both files are left, so even a restarted
+     * process resumes the download. If the temporary file can not be
+     * hardlinked (e.g. it's on another filesystem), its data are copied
+     * to \ref partFile by \ref keep when the download fails.
+     */
+    class DownloadJournal
+    {
+      friend std::ostream & operator<<( std::ostream & str, const DownloadJournal & obj );
+
+      public:
+        /** Ctor for the download of \a key_r, journaled in \a dir_r (nothing loaded). */
+        DownloadJournal( const std::string & key_r, const Pathname & dir_r = defaultDir() );
+
+        /** Where journals are kept by default (\c repoCachePath/partial). */
+        static Pathname defaultDir();
+
+      public:
+        /** The partially downloaded data. */
+        const Pathname & partFile() const
+        { return _partFile; }
+
+        /** The journal describing \ref partFile. */
+        const Pathname & journalFile() const
+        { return _journalFile; }
+
+        /** Load the journal.
+         * \return Whether a journal and it's \ref partFile exist.
+         */
+        bool load();
+
+        /** Write the journal (atomically). */
+        bool save() const;
+
+        /** Remove \ref partFile and \ref journalFile and clear the data. */
+        void remove();
+
+        /** Start a new journal for the download into \a tmpfile_r.
+         * Any previous journal is removed, and \a tmpfile_r is
+         * hardlinked to \ref partFile (or copied by \ref keep).
+         * \return Whether the download can be journaled.
+         */
+        bool start( const Pathname & tmpfile_r );
+
+        /** Continue the loaded journal with the download into \a tmpfile_r.
+         * The \ref partFile data are copied to \a file_r (the opened
+         * \a tmpfile_r), which then takes the place of \ref partFile.
+         * \return Whether the data could be copied.
+         */
+        bool resume( const Pathname & tmpfile_r, FILE * file_r );
+
+        /** The download failed: make sure \ref partFile holds the data
+         * and save the journal. Call this before removing the temporary file.
+         */
+        bool keep();
+
+      public:
+        /** The download url (plain HTTP). */
+        const std::string & url() const
+        { return _url; }
+
+        void setUrl( const std::string & url_r )
+        { _url = url_r; }
+
+        /** The \c ETag or \c Last-Modified of the response (plain HTTP). */
+        const std::string & validator() const
+        { return _validator; }
+
+        void setValidator( const std::string & validator_r )
+        { _validator = validator_r; }
+
+        /** Verified blocks (metalink). */
+        const std::vector<MediaBlock> & blocks() const
+        { return _blocks; }
+
+        void addBlock( const MediaBlock & blk_r )
+        { _blocks.push_back( blk_r ); }
+
+      private:
+        /** Link \a tmpfile_r to \ref partFile, or remember to copy it. */
+        void link( const Pathname & tmpfile_r );
+
+        Pathname                _partFile;
+        Pathname                _journalFile;
+        Pathname                _copyFrom;	//!< tmpfile to copy on \ref keep
+        std::string             _url;
+        std::string             _validator;
+        std::vector<MediaBlock> _blocks;
+    };
+    ///////////////////////////////////////////////////////////////////
+
+    /** \relates DownloadJournal Stream output */
+    std::ostream & operator<<( std::ostream & str, const DownloadJournal & obj );
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace media
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_MEDIA_DOWNLOADJOURNAL_H
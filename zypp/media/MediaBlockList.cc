@@ -11,12 +11,15 @@
  */
 
 #include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <expat.h>
 
 #include <vector>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 
@@ -460,6 +463,51 @@ MediaBlockList::reuseBlocks(FILE *wfp, string filename)
     }
   if (!found[nblks])
     return;
+  removeBlocks(found);
+}
+
+static bool
+blockOffLess(const MediaBlock &a, const MediaBlock &b)
+{
+  return a.off < b.off;
+}
+
+void
+MediaBlockList::reuseBlocks(FILE *wfp, string filename, const std::vector<MediaBlock> &ranges)
+{
+  if (!chksumlen || ranges.empty())
+    return;
+  int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1)
+    return;
+  size_t nblks = blocks.size();
+  vector<bool> found;
+  found.resize(nblks + 1);
+  std::vector<MediaBlock> sorted(ranges);
+  std::sort(sorted.begin(), sorted.end(), blockOffLess);
+  std::vector<unsigned char> buf;
+  size_t blkno = 0;
+  for (std::vector<MediaBlock>::const_iterator it = sorted.begin(); it != sorted.end(); ++it)
+    {
+      while (blkno < nblks && blocks[blkno].off < it->off)
+	blkno++;
+      if (blkno >= nblks || blocks[blkno].off != it->off || blocks[blkno].size != it->size || !haveChecksum(blkno))
+	continue;
+      buf.resize(it->size);
+      if (!it->size || pread(fd, &buf[0], it->size, it->off) != ssize_t(it->size))
+	continue;
+      if (checkChecksum(blkno, &buf[0], it->size))
+	writeBlock(blkno, wfp, &buf[0], it->size, 0, found);
+    }
+  close(fd);
+  if (!found[nblks])
+    return;
+  removeBlocks(found);
+}
+
+void
+MediaBlockList::removeBlocks(const std::vector<bool> &found)
+{
   // now throw out all of the blocks we found
   std::vector<MediaBlock> nblocks;
   std::vector<unsigned char> nchksums;
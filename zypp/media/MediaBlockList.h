@@ -114,6 +114,13 @@ public:
    **/
   void reuseBlocks(FILE *wfp, std::string filename);
 
+  /**
+   * like reuseBlocks, but only check the given ranges of the file
+   * (e.g. blocks verified by a previous download). A range is reused
+   * if it matches a block with the same checksum.
+   **/
+  void reuseBlocks(FILE *wfp, std::string filename, const std::vector<MediaBlock> &ranges);
+
   /**
    * return block list as string
    **/
@@ -122,6 +129,7 @@ public:
 private:
   void writeBlock(size_t blkno, FILE *fp, const unsigned char *buf, size_t bufl, size_t start, std::vector<bool> &found) const;
   bool checkChecksumRotated(size_t blkno, const unsigned char *buf, size_t bufl, size_t start) const;
+  void removeBlocks(const std::vector<bool> &found);
 
   off_t filesize;
   std::string fsumtype;
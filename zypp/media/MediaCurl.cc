@@ -18,6 +18,8 @@
 #include "zypp/base/String.h"
 #include "zypp/base/Gettext.h"
 #include "zypp/base/Sysconfig.h"
+#include "zypp/base/Trace.h"
+#include "zypp/base/DtorReset.h"
 #include "zypp/base/Gettext.h"
 
 #include "zypp/media/MediaCurl.h"
@@ -25,6 +27,7 @@
 #include "zypp/media/MediaUserAuth.h"
 #include "zypp/media/CredentialManager.h"
 #include "zypp/media/CurlConfig.h"
+#include "zypp/media/DownloadJournal.h"
 #include "zypp/thread/Once.h"
 #include "zypp/Target.h"
 #include "zypp/ZYppFactory.h"
@@ -89,6 +92,55 @@ namespace
     zypp::thread::callOnce(g_InitOnceFlag, _do_init_once);
   }
 
+  /** Process wide curl share handle.
+   *
+   * All easy handles share the DNS cache and the TLS sessions, so
+   * repeated requests to a host, even from different media handlers,
+   * avoid a new lookup and a full handshake. The connection cache is
+   * not shared, as libcurl does not support using a shared one from
+   * concurrently running threads. Like the global init, it is never freed.
+   */
+  zypp::thread::OnceFlag g_ShareOnceFlag = PTHREAD_ONCE_INIT;
+  CURLSH * g_Share = 0;
+  /** One mutex per kind of shared data. libcurl may lock one kind
+   * while holding another, so a single mutex would deadlock. */
+  pthread_mutex_t g_ShareMutex[CURL_LOCK_DATA_LAST];
+
+  extern "C" void _share_lock( CURL *, curl_lock_data data_r, curl_lock_access, void * )
+  {
+    pthread_mutex_lock( &g_ShareMutex[data_r] );
+  }
+
+  extern "C" void _share_unlock( CURL *, curl_lock_data data_r, void * )
+  {
+    pthread_mutex_unlock( &g_ShareMutex[data_r] );
+  }
+
+  extern "C" void _do_share_once()
+  {
+    for ( unsigned i = 0; i < CURL_LOCK_DATA_LAST; ++i )
+      pthread_mutex_init( &g_ShareMutex[i], 0 );
+
+    g_Share = curl_share_init();
+    if ( ! g_Share )
+    {
+      WAR << "curl share init failed" << endl;
+      return;
+    }
+    curl_share_setopt( g_Share, CURLSHOPT_LOCKFUNC, _share_lock );
+    curl_share_setopt( g_Share, CURLSHOPT_UNLOCKFUNC, _share_unlock );
+    curl_share_setopt( g_Share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS );
+#if CURLVERSION_AT_LEAST(7,23,0)
+    curl_share_setopt( g_Share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION );
+#endif
+  }
+
+  inline CURLSH * globalShare()
+  {
+    zypp::thread::callOnce(g_ShareOnceFlag, _do_share_once);
+    return g_Share;
+  }
+
   int log_curl(CURL *curl, curl_infotype info,
                char *ptr, size_t len, void *max_lvl)
   {
@@ -335,6 +387,34 @@ void fillSettingsFromUrl( const Url &url, TransferSettings &s )
     param = url.getQueryParam("head_requests");
     if( !param.empty() && param == "no" )
         s.setHeadRequestsAllowed(false);
+
+    param = url.getQueryParam("http2");
+    if( !param.empty() )
+        s.setHttp2Enabled(str::strToTrue(param));
+
+    param = url.getQueryParam("compress");
+    if( !param.empty() )
+        s.setCompressionEnabled(str::strToTrue(param));
+}
+
+/**
+ * Whether \a filename is not compressed already, so a compressed
+ * transfer (Accept-Encoding) pays off.
+ */
+bool worthCompressing( const Pathname & filename )
+{
+    static const char * compressed[] = {
+      ".gz", ".bz2", ".xz", ".lzma", ".zst", ".zck", ".zip",
+      ".rpm", ".drpm", ".deb", ".iso", ".solv", ".cpio", ".png", ".jpg",
+      NULL
+    };
+    std::string ext( str::toLower( filename.extension() ) );
+    for ( const char ** it = compressed; *it; ++it )
+    {
+      if ( ext == *it )
+        return false;
+    }
+    return true;
 }
 
 /**
@@ -442,7 +522,11 @@ MediaCurl::MediaCurl( const Url &      url_r,
                     "/", // urlpath at attachpoint
                     true ), // does_download
       _curl( NULL ),
-      _customHeaders(0L)
+      _customHeaders(0L),
+      _responseCode( 0 ),
+      _metalinkResponse( false ),
+      _journal( NULL ),
+      _validatorMismatch( false )
 {
   _curlError[0] = '\0';
   _curlDebug = 0L;
@@ -545,7 +629,11 @@ void MediaCurl::setupEasy()
     }
   }
 
-  curl_easy_setopt(_curl, CURLOPT_HEADERFUNCTION, log_redirects_curl);
+  if ( globalShare() )
+    curl_easy_setopt(_curl, CURLOPT_SHARE, globalShare());
+
+  curl_easy_setopt(_curl, CURLOPT_HEADERFUNCTION, &headerCallback);
+  curl_easy_setopt(_curl, CURLOPT_HEADERDATA, this);
   CURLcode ret = curl_easy_setopt( _curl, CURLOPT_ERRORBUFFER, _curlError );
   if ( ret != 0 ) {
     ZYPP_THROW(MediaCurlSetOptException(_url, "Error setting error buffer"));
@@ -593,6 +681,15 @@ void MediaCurl::setupEasy()
   // follow any Location: header that the server sends as part of
   // an HTTP header (#113275)
   SET_OPTION(CURLOPT_FOLLOWLOCATION, 1L);
+
+#if CURLVERSION_AT_LEAST(7,47,0)
+  // HTTP/2 over TLS only, plain http stays at 1.1
+  if ( _settings.http2Enabled() )
+    SET_OPTION(CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+#elif CURLVERSION_AT_LEAST(7,33,0)
+  if ( _settings.http2Enabled() && _url.getScheme() == "https" )
+    SET_OPTION(CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2_0);
+#endif
   // 3 redirects seem to be too few in some cases (bnc #465532)
   SET_OPTION(CURLOPT_MAXREDIRS, 6L);
 
@@ -1245,8 +1342,97 @@ bool MediaCurl::detectDirIndex() const
 
 ///////////////////////////////////////////////////////////////////
 
+size_t MediaCurl::headerCallback( void *ptr, size_t size, size_t nmemb, void *stream )
+{
+  size_t max = log_redirects_curl( ptr, size, nmemb, stream );
+  MediaCurl *me = reinterpret_cast<MediaCurl *>( stream );
+  if ( ! me )
+    return max;
+  // curl passes a single header line
+  string line( (const char *)ptr, size * nmemb );
+  string::size_type end = line.find_last_not_of( "\r\n" );
+  line.erase( end == string::npos ? 0 : end + 1 );
+  return me->processHeader( line ) ? max : 0;
+}
+
+bool MediaCurl::processHeader( const std::string & line_r ) const
+{
+  if ( line_r.compare( 0, 5, "HTTP/" ) == 0 )
+  {
+    // a new response (e.g. after a redirect)
+    string::size_type sep = line_r.find( ' ' );
+    _responseCode = ( sep == string::npos ? 0 : str::strtonum<long>( line_r.substr( sep+1 ) ) );
+    _etag.clear();
+    _lastModified.clear();
+    _date.clear();
+    _metalinkResponse = false;
+    return true;
+  }
+
+  if ( line_r.empty() )
+  {
+    // end of the response headers
+    if ( ! _journal || ( _responseCode != 200 && _responseCode != 206 ) )
+      return true;
+
+    const string validator( rangeValidator() );
+    if ( _responseCode == 206 )
+    {
+      if ( validator != _journal->validator() )
+      {
+        WAR << "Validator changed: '" << validator << "' != '" << _journal->validator() << "'" << endl;
+        _validatorMismatch = true;
+        return false;
+      }
+    }
+    else if ( ! _metalinkResponse && ! validator.empty() && validator != _journal->validator() )
+    {
+      _journal->setValidator( validator );
+      _journal->save();
+    }
+    return true;
+  }
+
+  string::size_type sep = line_r.find( ':' );
+  if ( sep == string::npos )
+    return true;
+  string name( line_r.substr( 0, sep ) );
+  string value( str::trim( line_r.substr( sep+1 ) ) );
+  if ( ::strcasecmp( name.c_str(), "ETag" ) == 0 )
+    _etag = value;
+  else if ( ::strcasecmp( name.c_str(), "Last-Modified" ) == 0 )
+    _lastModified = value;
+  else if ( ::strcasecmp( name.c_str(), "Date" ) == 0 )
+    _date = value;
+  else if ( ::strcasecmp( name.c_str(), "Content-Type" ) == 0 )
+    _metalinkResponse = ( value.find( "application/metalink" ) == 0 );
+  return true;
+}
+
+std::string MediaCurl::rangeValidator() const
+{
+  // RFC 7232: weak validators must not be used for ranges
+  if ( ! _etag.empty() && _etag.compare( 0, 2, "W/" ) != 0 )
+    return _etag;
+  // Last-Modified is strong if it's at least 60 seconds before the Date
+  if ( ! _lastModified.empty() && ! _date.empty() )
+  {
+    time_t lastModified = ::curl_getdate( _lastModified.c_str(), NULL );
+    time_t date = ::curl_getdate( _date.c_str(), NULL );
+    if ( lastModified != -1 && date != -1 && date - lastModified >= 60 )
+      return _lastModified;
+  }
+  return std::string();
+}
+
+///////////////////////////////////////////////////////////////////
+
 void MediaCurl::doGetFileCopy( const Pathname & filename , const Pathname & target, callback::SendReport<DownloadProgressReport> & report, RequestOptions options ) const
 {
+    debug::TraceSpan span( "MediaCurl::doGetFileCopy", "media" );
+    if ( span.active() )
+      span.attr( "url", getFileUrl( filename ).asString() );
+
     Pathname dest = target.absolutename();
     if( assert_dir( dest.dirname() ) )
     {
@@ -1254,6 +1440,15 @@ void MediaCurl::doGetFileCopy( const Pathname & filename , const Pathname & targ
       Url url(getFileUrl(filename));
       ZYPP_THROW( MediaSystemException(url, "System error on " + dest.dirname().asString()) );
     }
+
+    // Interrupted HTTP downloads are continued by a range request, if
+    // the server still reports the same (strong) ETag/Last-Modified.
+    string fileUrl( getFileUrl(filename).asString() );
+    bool resumable = ( _url.getScheme() == "http" || _url.getScheme() == "https" );
+    DownloadJournal journal( fileUrl );
+    bool journaling = false;
+    off_t resumeFrom = 0;
+
     string destNew = target.asString() + ".new.zypp.XXXXXX";
     char *buf = ::strdup( destNew.c_str());
     if( !buf)
@@ -1281,6 +1476,28 @@ void MediaCurl::doGetFileCopy( const Pathname & filename , const Pathname & targ
       ZYPP_THROW(MediaWriteException(destNew));
     }
 
+    if ( resumable && journal.load() && journal.url() == fileUrl && ! journal.validator().empty() )
+    {
+      if ( journal.resume( destNew, file ) )
+      {
+        resumeFrom = ::ftello( file );
+        journaling = true;
+        MIL << "Resuming " << fileUrl << " at " << resumeFrom << endl;
+      }
+      else if ( ::ftruncate( ::fileno( file ), 0 ) != 0 || ::fseeko( file, 0, SEEK_SET ) != 0 )
+      {
+        ::fclose( file );
+        filesystem::unlink( destNew );
+        ZYPP_THROW(MediaWriteException(destNew));
+      }
+    }
+
+    if ( ! journaling && resumable && journal.start( destNew ) )
+    {
+      journal.setUrl( fileUrl );
+      journaling = true;
+    }
+
     DBG << "dest: " << dest << endl;
     DBG << "temp: " << destNew << endl;
 
@@ -1295,18 +1512,45 @@ void MediaCurl::doGetFileCopy( const Pathname & filename , const Pathname & targ
       curl_easy_setopt(_curl, CURLOPT_TIMECONDITION, CURL_TIMECOND_NONE);
       curl_easy_setopt(_curl, CURLOPT_TIMEVALUE, 0L);
     }
+    curl_easy_setopt(_curl, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)resumeFrom);
+    if ( resumeFrom )
+      curl_easy_setopt(_curl, CURLOPT_HTTPHEADER, _customHeaders);	// no metalink for a range
     try
     {
-      doGetFileCopyFile(filename, dest, file, report, options);
+      // the header callback records the validators in the journal
+      DtorReset resetJournal( _journal, (DownloadJournal*)NULL );
+      _journal = journaling ? &journal : NULL;
+      _validatorMismatch = false;
+      _responseCode = 0;
+      // the range must address the uncompressed file
+      doGetFileCopyFile(filename, dest, file, report, resumeFrom ? options | OPTION_NO_ENCODING : options);
     }
     catch (Exception &e)
     {
       ::fclose( file );
-      filesystem::unlink( destNew );
       curl_easy_setopt(_curl, CURLOPT_TIMECONDITION, CURL_TIMECOND_NONE);
       curl_easy_setopt(_curl, CURLOPT_TIMEVALUE, 0L);
+      curl_easy_setopt(_curl, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)0);
+
+      // 200: server ignored the range, 416: file got smaller
+      if ( resumeFrom && ( _validatorMismatch || _responseCode == 200 || _responseCode == 416 ) )
+      {
+        ZYPP_CAUGHT(e);
+        WAR << "Can't resume " << fileUrl << " (HTTP " << _responseCode << "), starting over" << endl;
+        filesystem::unlink( destNew );
+        journal.remove();
+        doGetFileCopy( filename, target, report, options | OPTION_NO_REPORT_START );
+        return;
+      }
+
+      if ( journaling && ! journal.validator().empty() && journal.keep() )
+        MIL << "Keeping partial download " << journal << endl;
+      else if ( journaling )
+        journal.remove();
+      filesystem::unlink( destNew );
       ZYPP_RETHROW(e);
     }
+    curl_easy_setopt(_curl, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)0);
 
     long httpReturnCode = 0;
     CURLcode infoRet = curl_easy_getinfo(_curl,
@@ -1353,7 +1597,11 @@ void MediaCurl::doGetFileCopy( const Pathname & filename , const Pathname & targ
       ::fclose( file );
       filesystem::unlink( destNew );
     }
+    if ( journaling )
+      journal.remove();
 
+    if ( span.active() )
+      span.attr( "bytes", (long long)PathInfo(dest).size() ).attr( "modified", modified ? "yes" : "no" );
     DBG << "done: " << PathInfo(dest) << endl;
 }
 
@@ -1398,6 +1646,17 @@ void MediaCurl::doGetFileCopyFile( const Pathname & filename , const Pathname &
       ZYPP_THROW(MediaCurlSetOptException(url, _curlError));
     }
 
+    // let curl decode a compressed transfer of uncompressed files
+    bool encoding = ( _settings.compressionEnabled()
+                      && !(options & OPTION_NO_ENCODING)
+                      && ( _url.getScheme() == "http" || _url.getScheme() == "https" )
+                      && worthCompressing( filename ) );
+#if CURLVERSION_AT_LEAST(7,21,6)
+    curl_easy_setopt( _curl, CURLOPT_ACCEPT_ENCODING, encoding ? "" : (char *)0 );
+#else
+    curl_easy_setopt( _curl, CURLOPT_ENCODING, encoding ? "" : (char *)0 );
+#endif
+
     // Set callback and perform.
     ProgressData progressData(_curl, _settings.timeout(), url, &report);
     if (!(options & OPTION_NO_REPORT_START))
@@ -1432,6 +1691,14 @@ void MediaCurl::doGetFileCopyFile( const Pathname & filename , const Pathname &
     if ( curl_easy_setopt( _curl, CURLOPT_PROGRESSDATA, NULL ) != 0 ) {
       WAR << "Can't unset CURLOPT_PROGRESSDATA: " << _curlError << endl;;
     }
+    if ( encoding )
+    {
+#if CURLVERSION_AT_LEAST(7,21,6)
+      curl_easy_setopt( _curl, CURLOPT_ACCEPT_ENCODING, (char *)0 );
+#else
+      curl_easy_setopt( _curl, CURLOPT_ENCODING, (char *)0 );
+#endif
+    }
 
     if ( ret != 0 )
     {
@@ -22,6 +22,8 @@
 namespace zypp {
   namespace media {
 
+class DownloadJournal;
+
 ///////////////////////////////////////////////////////////////////
 //
 //	CLASS NAME : MediaCurl
@@ -44,6 +46,8 @@ class MediaCurl : public MediaHandler
         OPTION_NO_IFMODSINCE = 0x04,
         /** do not send a start ProgressReport */
         OPTION_NO_REPORT_START = 0x08,
+        /** do not request a compressed transfer (e.g. when resuming) */
+        OPTION_NO_ENCODING = 0x10,
     };
     ZYPP_DECLARE_FLAGS(RequestOptions,RequestOption);
 
@@ -150,6 +154,16 @@ class MediaCurl : public MediaHandler
 
     void doGetFileCopyFile( const Pathname & srcFilename, const Pathname & dest, FILE *file, callback::SendReport<DownloadProgressReport> & _report, RequestOptions options = OPTION_NONE ) const;
 
+    /**
+     * Curl header callback: remembers the validators of the response
+     * and, if a \ref DownloadJournal is set, records them (or rejects a
+     * resumed response whose validator does not match).
+     */
+    static size_t headerCallback( void *ptr, size_t size, size_t nmemb, void *stream );
+    bool processHeader( const std::string & line_r ) const;
+    /** The strong validator (\c ETag or \c Last-Modified) of the response, if any. */
+    std::string rangeValidator() const;
+
   private:
     /**
      * Return a comma separated list of available authentication methods
@@ -172,6 +186,17 @@ class MediaCurl : public MediaHandler
     char _curlError[ CURL_ERROR_SIZE ];
     curl_slist *_customHeaders;
     TransferSettings _settings;
+
+    /** Response headers remembered by \ref headerCallback. */
+    mutable long _responseCode;
+    mutable std::string _etag;
+    mutable std::string _lastModified;
+    mutable std::string _date;
+    mutable bool _metalinkResponse;
+    /** Journal of the running download (if resumable). */
+    mutable DownloadJournal *_journal;
+    /** A resumed download got a response of a different entity. */
+    mutable bool _validatorMismatch;
 };
 ZYPP_DECLARE_OPERATORS_FOR_FLAGS(MediaCurl::RequestOptions);
 
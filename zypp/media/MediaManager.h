@@ -416,6 +416,12 @@ namespace zypp
      *       'spnego', 'gssnego'.
      *       Note, that this list depends on the list of methods supported
      *       by the curl library.
+     *     - <tt>http2</tt>:
+     *       Use HTTP/2 (multiplexing parallel downloads) for https
+     *       servers supporting it by setting it to "1" (or true, yes, on).
+     *     - <tt>compress</tt>:
+     *       Turn off requesting compressed transfers of uncompressed
+     *       files (Accept-Encoding) by setting it to "0" (or false, no, off).
      *     - <tt>mediahandler</tt>: Set the mediahandler for this url
      *     Valid values are: 'curl', 'multicurl', 'aria2c'
      *   - Authority:
@@ -12,6 +12,7 @@
 
 #include <ctype.h>
 #include <sys/types.h>
+#include <unistd.h>
 #include <signal.h>
 #include <sys/wait.h>
 #include <netdb.h>
@@ -24,8 +25,12 @@
 
 #include "zypp/ZConfig.h"
 #include "zypp/base/Logger.h"
+#include "zypp/base/Trace.h"
+#include "zypp/base/DtorReset.h"
 #include "zypp/media/MediaMultiCurl.h"
+#include "zypp/media/DownloadJournal.h"
 #include "zypp/media/MetaLinkParser.h"
+#include "zypp/media/MirrorScoreboard.h"
 
 using namespace std;
 using namespace zypp::base;
@@ -33,6 +38,13 @@ using namespace zypp::base;
 #undef CURLVERSION_AT_LEAST
 #define CURLVERSION_AT_LEAST(M,N,O) LIBCURL_VERSION_NUM >= ((((M)<<8)+(N))<<8)+(O)
 
+// curl_multi_wait polls curl's sockets together with our DNS pipes,
+// without select's FD_SETSIZE limit.
+#if CURLVERSION_AT_LEAST(7,28,0)
+#define USE_MULTI_WAIT
+#include <poll.h>
+#endif
+
 namespace zypp {
   namespace media {
 
@@ -56,10 +68,17 @@ public:
   bool checkChecksum();
   bool recheckChecksum();
   void disableCompetition();
+  size_t blocksize() const;
 
   void checkdns();
+#ifdef USE_MULTI_WAIT
+  void adddnsfd(std::vector<struct curl_waitfd> &waitfds);
+  void dnsevent(const std::vector<struct curl_waitfd> &waitfds);
+#else
   void adddnsfd(fd_set &rset, int &maxfd);
   void dnsevent(fd_set &rset);
+#endif
+  void dnsdone();
 
   int _workerno;
 
@@ -78,6 +97,9 @@ public:
   double _avgspeed;
   double _maxspeed;
 
+  double _fetchtime;	// seconds spent fetching _received
+  double _latency;	// average time to the first byte
+
   double _sleepuntil;
 
 private:
@@ -117,6 +139,17 @@ public:
 
   void run(std::vector<Url> &urllist);
 
+  /** Seconds to wait for events before the loop has work to do again. */
+  double waittime();
+
+  /** Write verified blocks to \a journal while downloading. */
+  void setJournal(DownloadJournal *journal);
+  /** Save the journal if there are new blocks. */
+  void saveJournal();
+
+  /** Tell \a scoreboard how the mirrors performed. */
+  void updateScoreboard(MirrorScoreboard &scoreboard) const;
+
 protected:
   friend class multifetchworker;
 
@@ -125,6 +158,7 @@ protected:
   Url _baseurl;
 
   FILE *_fp;
+  int _fd;	// fileno(_fp), written with pwrite
   callback::SendReport<DownloadProgressReport> *_report;
   MediaBlockList *_blklist;
   off_t _filesize;
@@ -153,6 +187,10 @@ protected:
   double _lastperiodfetched;
   double _periodavg;
 
+  DownloadJournal *_journal;
+  bool _journaldirty;
+  double _lastjournal;
+
 public:
   double _timeout;
   double _connect_timeout;
@@ -161,11 +199,31 @@ public:
 };
 
 #define BLKSIZE		131072
+#define MAXBLKSIZE	(16 * 1024 * 1024)
+#define BLKTIME		1.0
 #define MAXURLS		10
+#define MAXWAITTIME	.5
 
 
 //////////////////////////////////////////////////////////////////////
 
+/** Journal the blocks of \a origbl which are no longer in \a bl (i.e. were reused). */
+static void
+addReusedBlocks(DownloadJournal &journal, const MediaBlockList &origbl, const MediaBlockList &bl)
+{
+  size_t j = 0;
+  for (size_t i = 0; i < origbl.numBlocks(); i++)
+    {
+      MediaBlock blk = origbl.getBlock(i);
+      while (j < bl.numBlocks() && bl.getBlock(j).off < blk.off)
+	j++;
+      if (j < bl.numBlocks() && bl.getBlock(j).off == blk.off)
+	continue;	// still needed
+      if (origbl.haveChecksum(i))
+	journal.addBlock(blk);
+    }
+}
+
 static double
 currentTime()
 {
@@ -221,9 +279,16 @@ multifetchworker::writefunction(void *ptr, size_t size)
       _size -= len;
       return size;
     }
-  if (fseeko(_request->_fp, _off, SEEK_SET))
-    return size ? 0 : 1;
-  cnt = fwrite(ptr, 1, len, _request->_fp);
+  // positional writes, so the workers don't have to share a file offset
+  for (cnt = 0; cnt < len; )
+    {
+      ssize_t r = pwrite(_request->_fd, (const char *)ptr + cnt, len - cnt, _off + cnt);
+      if (r < 0 && errno == EINTR)
+	continue;
+      if (r <= 0)
+	break;
+      cnt += r;
+    }
   if (cnt > 0)
     {
       _request->_fetchedsize += cnt;
@@ -311,7 +376,10 @@ multifetchworker::multifetchworker(int no, multifetchrequest &request, const Url
   _blkreceived = 0;
   _received = 0;
   _blkstarttime = 0;
-  _avgspeed = 0;
+  // start with what we know about this mirror from previous downloads
+  _avgspeed = _request->_context->scoreboard().speed(url.getHost());
+  _fetchtime = 0;
+  _latency = 0;
   _sleepuntil = 0;
   _maxspeed = _request->_maxspeed;
   _noendrange = false;
@@ -341,6 +409,19 @@ multifetchworker::multifetchworker(int no, multifetchrequest &request, const Url
     }
   curl_easy_setopt(_curl, CURLOPT_PRIVATE, this);
   curl_easy_setopt(_curl, CURLOPT_URL, _urlbuf.c_str());
+#if CURLVERSION_AT_LEAST(7,47,0)
+  // the mirror urls don't carry our query options, use the settings of the context
+  if (_request->_context->_settings.http2Enabled())
+    {
+      curl_easy_setopt(_curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+      // rather wait for a connection we can multiplex on than open a new one
+      curl_easy_setopt(_curl, CURLOPT_PIPEWAIT, 1L);
+    }
+#endif
+#if CURLVERSION_AT_LEAST(7,21,6)
+  // block ranges and checksums refer to the identity encoding
+  curl_easy_setopt(_curl, CURLOPT_ACCEPT_ENCODING, (char *)0);
+#endif
   curl_easy_setopt(_curl, CURLOPT_WRITEFUNCTION, &_writefunction);
   curl_easy_setopt(_curl, CURLOPT_WRITEDATA, this);
   if (_request->_filesize == off_t(-1) || !_request->_blklist || !_request->_blklist->haveChecksum(0))
@@ -499,6 +580,37 @@ multifetchworker::checkdns()
   _state = WORKER_LOOKUP;
 }
 
+#ifdef USE_MULTI_WAIT
+
+void
+multifetchworker::adddnsfd(std::vector<struct curl_waitfd> &waitfds)
+{
+  if (_state != WORKER_LOOKUP)
+    return;
+  struct curl_waitfd waitfd;
+  waitfd.fd = _dnspipe;
+  waitfd.events = CURL_WAIT_POLLIN;
+  waitfd.revents = 0;
+  waitfds.push_back(waitfd);
+}
+
+void
+multifetchworker::dnsevent(const std::vector<struct curl_waitfd> &waitfds)
+{
+  if (_state != WORKER_LOOKUP)
+    return;
+  for (std::vector<struct curl_waitfd>::const_iterator it = waitfds.begin(); it != waitfds.end(); ++it)
+    {
+      if (it->fd == _dnspipe && it->revents)
+	{
+	  dnsdone();
+	  return;
+	}
+    }
+}
+
+#else
+
 void
 multifetchworker::adddnsfd(fd_set &rset, int &maxfd)
 {
@@ -512,9 +624,16 @@ multifetchworker::adddnsfd(fd_set &rset, int &maxfd)
 void
 multifetchworker::dnsevent(fd_set &rset)
 {
-
   if (_state != WORKER_LOOKUP || !FD_ISSET(_dnspipe, &rset))
     return;
+  dnsdone();
+}
+
+#endif
+
+void
+multifetchworker::dnsdone()
+{
   int status;
   while (waitpid(_pid, &status, 0) == -1)
     {
@@ -562,18 +681,21 @@ multifetchworker::recheckChecksum()
   // XXX << "recheckChecksum block " << _blkno << endl;
   if (!_request->_fp || !_blksize || !_request->_blklist)
     return true;
-  if (fseeko(_request->_fp, _blkstart, SEEK_SET))
-    return false;
-  char buf[4096];
+  char buf[65536];
   size_t l = _blksize;
+  off_t off = _blkstart;
   _request->_blklist->createDigest(_dig);	// resets digest
   while (l)
     {
       size_t cnt = l > sizeof(buf) ? sizeof(buf) : l;
-      if (fread(buf, cnt, 1, _request->_fp) != 1)
+      ssize_t r = pread(_request->_fd, buf, cnt, off);
+      if (r < 0 && errno == EINTR)
+	continue;
+      if (r <= 0)
 	return false;
-      _dig.update(buf, cnt);
-      l -= cnt;
+      _dig.update(buf, r);
+      l -= r;
+      off += r;
     }
   return _request->_blklist->verifyDigest(_blkno, _dig);
 }
@@ -691,6 +813,30 @@ multifetchworker::disableCompetition()
 }
 
 
+size_t
+multifetchworker::blocksize() const
+{
+  if (!_avgspeed)
+    return BLKSIZE;
+  // a block should keep the connection busy for a while (and for some
+  // round trips on high latency links), so that we don't spend our time
+  // starting requests
+  double t = _latency * 4 > BLKTIME ? _latency * 4 : BLKTIME;
+  double size = _avgspeed * t;
+  // but leave something to do for the other workers
+  if (_request->_filesize != off_t(-1) && _request->_activeworkers > 1)
+    {
+      double share = double(_request->_filesize - _request->_blkoff) / _request->_activeworkers;
+      if (size > share)
+	size = share;
+    }
+  if (size <= BLKSIZE)
+    return BLKSIZE;
+  if (size >= MAXBLKSIZE)
+    return MAXBLKSIZE;
+  return size_t(size) & ~size_t(4095);
+}
+
 void
 multifetchworker::nextjob()
 {
@@ -704,7 +850,7 @@ multifetchworker::nextjob()
   MediaBlockList *blklist = _request->_blklist;
   if (!blklist)
     {
-      _blksize = BLKSIZE;
+      _blksize = blocksize();
       if (_request->_filesize != off_t(-1))
 	{
 	  if (_request->_blkoff >= _request->_filesize)
@@ -712,9 +858,10 @@ multifetchworker::nextjob()
 	      stealjob();
 	      return;
 	    }
+	  size_t maxsize = _blksize;
 	  _blksize = _request->_filesize - _request->_blkoff;
-	  if (_blksize > BLKSIZE)
-	    _blksize = BLKSIZE;
+	  if (_blksize > maxsize)
+	    _blksize = maxsize;
 	}
     }
   else
@@ -731,8 +878,12 @@ multifetchworker::nextjob()
 	  _request->_blkoff = blk.off;
 	}
       _blksize = blk.off + blk.size - _request->_blkoff;
-      if (_blksize > BLKSIZE && !blklist->haveChecksum(_request->_blkno))
-	_blksize = BLKSIZE;
+      if (!blklist->haveChecksum(_request->_blkno))
+	{
+	  size_t maxsize = blocksize();
+	  if (_blksize > maxsize)
+	    _blksize = maxsize;
+	}
     }
   _blkno = _request->_blkno;
   _blkstart = _request->_blkoff;
@@ -785,6 +936,7 @@ multifetchworker::run()
 multifetchrequest::multifetchrequest(const MediaMultiCurl *context, const Pathname &filename, const Url &baseurl, CURLM *multi, FILE *fp, callback::SendReport<DownloadProgressReport> *report, MediaBlockList *blklist, off_t filesize) : _context(context), _filename(filename), _baseurl(baseurl)
 {
   _fp = fp;
+  _fd = fp ? fileno(fp) : -1;
   _report = report;
   _blklist = blklist;
   _filesize = filesize;
@@ -807,6 +959,9 @@ multifetchrequest::multifetchrequest(const MediaMultiCurl *context, const Pathna
   _lastperiodstart = _lastprogress = _starttime = currentTime();
   _lastperiodfetched = 0;
   _periodavg = 0;
+  _journal = 0;
+  _journaldirty = false;
+  _lastjournal = _starttime;
   _timeout = 0;
   _connect_timeout = 0;
   _maxspeed = 0;
@@ -838,11 +993,11 @@ void
 multifetchrequest::run(std::vector<Url> &urllist)
 {
   int workerno = 0;
+  int stillrunning = 0;
   std::vector<Url>::iterator urliter = urllist.begin();
   for (;;)
     {
-      fd_set rset, wset, xset;
-      int maxfd, nqueue;
+      int nqueue;
 
       if (_finished)
 	{
@@ -881,6 +1036,34 @@ multifetchrequest::run(std::vector<Url> &urllist)
 	  break;
 	}
 
+      double waittime = this->waittime();
+#ifdef USE_MULTI_WAIT
+      std::vector<struct curl_waitfd> waitfds;
+      if (_lookupworkers)
+        for (std::list<multifetchworker *>::iterator workeriter = _workers.begin(); workeriter != _workers.end(); ++workeriter)
+	  (*workeriter)->adddnsfd(waitfds);
+
+      int r = 0;
+      if (!stillrunning && waitfds.empty())
+	{
+	  // curl_multi_wait does not sleep without any fds
+	  poll(NULL, 0, waittime * 1000);
+	}
+      else if (curl_multi_wait(_multi, waitfds.empty() ? NULL : &waitfds[0], waitfds.size(), waittime * 1000, &r) != CURLM_OK)
+	ZYPP_THROW(MediaCurlException(_baseurl, "curl_multi_wait() failed", "unknown error"));
+      if (r != 0 && _lookupworkers)
+	for (std::list<multifetchworker *>::iterator workeriter = _workers.begin(); workeriter != _workers.end(); ++workeriter)
+	  {
+	    multifetchworker *worker = *workeriter;
+	    if (worker->_state != WORKER_LOOKUP)
+	      continue;
+	    (*workeriter)->dnsevent(waitfds);
+	    if (worker->_state != WORKER_LOOKUP)
+	      _lookupworkers--;
+	  }
+#else
+      fd_set rset, wset, xset;
+      int maxfd = -1;
       FD_ZERO(&rset);
       FD_ZERO(&wset);
       FD_ZERO(&xset);
@@ -892,32 +1075,8 @@ multifetchrequest::run(std::vector<Url> &urllist)
 	  (*workeriter)->adddnsfd(rset, maxfd);
 
       timeval tv;
-      // if we added a new job we have to call multi_perform once
-      // to make it show up in the fd set. do not sleep in this case.
-      tv.tv_sec = 0;
-      tv.tv_usec = _havenewjob ? 0 : 200000;
-      if (_sleepworkers && !_havenewjob)
-	{
-	  if (_minsleepuntil == 0)
-	    {
-	      for (std::list<multifetchworker *>::iterator workeriter = _workers.begin(); workeriter != _workers.end(); ++workeriter)
-	        {
-		  multifetchworker *worker = *workeriter;
-		  if (worker->_state != WORKER_SLEEP)
-		    continue;
-		  if (!_minsleepuntil || _minsleepuntil > worker->_sleepuntil)
-		    _minsleepuntil = worker->_sleepuntil;
-		}
-	    }
-	  double sl = _minsleepuntil - currentTime();
-	  if (sl < 0)
-	    {
-	      sl = 0;
-	      _minsleepuntil = 0;
-	    }
-	  if (sl < .2)
-	    tv.tv_usec = sl * 1000000;
-	}
+      tv.tv_sec = (long)waittime;
+      tv.tv_usec = (waittime - tv.tv_sec) * 1000000;
       int r = select(maxfd + 1, &rset, &wset, &xset, &tv);
       if (r == -1 && errno != EINTR)
 	ZYPP_THROW(MediaCurlException(_baseurl, "select() failed", "unknown error"));
@@ -931,14 +1090,14 @@ multifetchrequest::run(std::vector<Url> &urllist)
 	    if (worker->_state != WORKER_LOOKUP)
 	      _lookupworkers--;
 	  }
+#endif
       _havenewjob = false;
 
       // run curl
       for (;;)
         {
           CURLMcode mcode;
-	  int tasks;
-          mcode = curl_multi_perform(_multi, &tasks);
+          mcode = curl_multi_perform(_multi, &stillrunning);
           if (mcode == CURLM_CALL_MULTI_PERFORM)
             continue;
 	  if (mcode != CURLM_OK)
@@ -991,6 +1150,7 @@ multifetchrequest::run(std::vector<Url> &urllist)
 	    ZYPP_THROW(MediaCurlException(_baseurl, "curl_easy_getinfo", "unknown error"));
 	  if (worker->_blkreceived && now > worker->_blkstarttime)
 	    {
+	      worker->_fetchtime += now - worker->_blkstarttime;
 	      if (worker->_avgspeed)
 		worker->_avgspeed = (worker->_avgspeed + worker->_blkreceived / (now - worker->_blkstarttime)) / 2;
 	      else
@@ -1027,6 +1187,9 @@ multifetchrequest::run(std::vector<Url> &urllist)
 	    }
 	  if (cc == 0)
 	    {
+	      double ttfb = 0;
+	      if (curl_easy_getinfo(easy, CURLINFO_STARTTRANSFER_TIME, &ttfb) == CURLE_OK && ttfb > 0)
+		worker->_latency = worker->_latency ? (worker->_latency + ttfb) / 2 : ttfb;
 	      if (!worker->checkChecksum())
 		{
 		  WAR << "#" << worker->_workerno << ": checksum error, disable worker" << endl;
@@ -1054,6 +1217,11 @@ multifetchrequest::run(std::vector<Url> &urllist)
 			}
 		    }
 		  _fetchedgoodsize += worker->_blksize;
+		  if (_journal && _blklist && _blklist->haveChecksum(worker->_blkno))
+		    {
+		      _journal->addBlock(MediaBlock(worker->_blkstart, worker->_blksize));
+		      _journaldirty = true;
+		    }
 		}
 
 	      // make bad workers sleep a little
@@ -1132,6 +1300,13 @@ multifetchrequest::run(std::vector<Url> &urllist)
 	    ZYPP_THROW(MediaCurlException(_baseurl, "User abort", "cancelled"));
 	}
 
+      // so that even a killed process can resume
+      if (_journaldirty && now - _lastjournal > 2)
+	{
+	  saveJournal();
+	  _lastjournal = now;
+	}
+
       if (_timeout && now - _lastprogress > _timeout)
 	break;
     }
@@ -1148,6 +1323,72 @@ multifetchrequest::run(std::vector<Url> &urllist)
     }
 }
 
+double
+multifetchrequest::waittime()
+{
+  // if we added a new job we have to call multi_perform once
+  // to make it show up in the fd set. do not sleep in this case.
+  if (_havenewjob)
+    return 0;
+
+  // wake up for curl's timeouts, sleeping workers and progress reports
+  double waittime = MAXWAITTIME;
+  long curltimeout = -1;
+  if (curl_multi_timeout(_multi, &curltimeout) == CURLM_OK && curltimeout >= 0 && curltimeout < waittime * 1000)
+    waittime = curltimeout / 1000.;
+  if (_sleepworkers)
+    {
+      if (_minsleepuntil == 0)
+	{
+	  for (std::list<multifetchworker *>::iterator workeriter = _workers.begin(); workeriter != _workers.end(); ++workeriter)
+	    {
+	      multifetchworker *worker = *workeriter;
+	      if (worker->_state != WORKER_SLEEP)
+		continue;
+	      if (!_minsleepuntil || _minsleepuntil > worker->_sleepuntil)
+		_minsleepuntil = worker->_sleepuntil;
+	    }
+	}
+      double sl = _minsleepuntil - currentTime();
+      if (sl < 0)
+	{
+	  sl = 0;
+	  _minsleepuntil = 0;
+	}
+      if (sl < waittime)
+	waittime = sl;
+    }
+  return waittime;
+}
+
+void
+multifetchrequest::setJournal(DownloadJournal *journal)
+{
+  _journal = journal;
+}
+
+void
+multifetchrequest::saveJournal()
+{
+  if (!_journal || !_journaldirty)
+    return;
+  _journal->save();
+  _journaldirty = false;
+}
+
+void
+multifetchrequest::updateScoreboard(MirrorScoreboard &scoreboard) const
+{
+  for (std::list<multifetchworker *>::const_iterator workeriter = _workers.begin(); workeriter != _workers.end(); ++workeriter)
+    {
+      const multifetchworker *worker = *workeriter;
+      if (worker->_state == WORKER_BROKEN)
+	scoreboard.failure(worker->_url.getHost());
+      else if (worker->_received && worker->_fetchtime > 0)
+	scoreboard.success(worker->_url.getHost(), worker->_received / worker->_fetchtime, worker->_latency);
+    }
+}
+
 
 //////////////////////////////////////////////////////////////////////
 
@@ -1283,6 +1524,10 @@ int MediaMultiCurl::progressCallback( void *clientp, double dltotal, double dlno
 
 void MediaMultiCurl::doGetFileCopy( const Pathname & filename , const Pathname & target, callback::SendReport<DownloadProgressReport> & report, RequestOptions options ) const
 {
+  debug::TraceSpan span( "MediaMultiCurl::doGetFileCopy", "media" );
+  if ( span.active() )
+    span.attr( "url", getFileUrl( filename ).asString() );
+
   Pathname dest = target.absolutename();
   if( assert_dir( dest.dirname() ) )
   {
@@ -1290,6 +1535,24 @@ void MediaMultiCurl::doGetFileCopy( const Pathname & filename , const Pathname &
     Url url(getFileUrl(filename));
     ZYPP_THROW( MediaSystemException(url, "System error on " + dest.dirname().asString()) );
   }
+
+  // resume an interrupted download: plain ones by a range request,
+  // metalink ones by reusing the verified blocks (see below)
+  DownloadJournal journal( getFileUrl(filename).asString() );
+  bool blockjournal = false;
+  if ( journal.load() )
+  {
+    if ( ! journal.validator().empty() )
+    {
+      // a plain range request, without Accept: metalink
+      curl_easy_setopt(_curl, CURLOPT_HTTPHEADER, _customHeaders);
+      curl_easy_setopt(_curl, CURLOPT_PROGRESSFUNCTION, &MediaCurl::progressCallback);
+      MediaCurl::doGetFileCopy( filename, target, report, options );
+      return;
+    }
+    blockjournal = true;
+  }
+
   string destNew = target.asString() + ".new.zypp.XXXXXX";
   char *buf = ::strdup( destNew.c_str());
   if( !buf)
@@ -1319,6 +1582,14 @@ void MediaMultiCurl::doGetFileCopy( const Pathname & filename , const Pathname &
   DBG << "dest: " << dest << endl;
   DBG << "temp: " << destNew << endl;
 
+  // if we get a plain file, the header callback records its validator
+  bool journaling = false;
+  if ( !blockjournal && ( _url.getScheme() == "http" || _url.getScheme() == "https" ) && journal.start( destNew ) )
+  {
+    journal.setUrl( getFileUrl(filename).asString() );
+    journaling = true;
+  }
+
   // set IFMODSINCE time condition (no download if not modified)
   if( PathInfo(target).isExist() && !(options & OPTION_NO_IFMODSINCE) )
   {
@@ -1337,11 +1608,17 @@ void MediaMultiCurl::doGetFileCopy( const Pathname & filename , const Pathname &
   curl_easy_setopt(_curl, CURLOPT_PRIVATE, file);
   try
     {
+      DtorReset resetJournal( _journal, (DownloadJournal*)NULL );
+      _journal = journaling ? &journal : NULL;
       MediaCurl::doGetFileCopyFile(filename, dest, file, report, options);
     }
   catch (Exception &ex)
     {
       ::fclose(file);
+      if ( journaling && ! journal.validator().empty() && journal.keep() )
+	MIL << "Keeping partial download " << journal << endl;
+      else if ( journaling )
+	journal.remove();
       filesystem::unlink(destNew);
       curl_easy_setopt(_curl, CURLOPT_TIMECONDITION, CURL_TIMECOND_NONE);
       curl_easy_setopt(_curl, CURLOPT_TIMEVALUE, 0L);
@@ -1362,6 +1639,7 @@ void MediaMultiCurl::doGetFileCopy( const Pathname & filename , const Pathname &
 	 || ( httpReturnCode == 213 && _url.getScheme() == "ftp" ) ) // not modified
     {
       DBG << "not modified: " << PathInfo(dest) << endl;
+      journal.remove();
       return;
     }
   }
@@ -1392,6 +1670,7 @@ void MediaMultiCurl::doGetFileCopy( const Pathname & filename , const Pathname &
   if (ismetalink)
     {
       bool userabort = false;
+      span.attr( "metalink", "yes" );
       fclose(file);
       file = NULL;
       Pathname failedFile = ZConfig::instance().repoCachePath() / "MultiCurl.failed";
@@ -1400,11 +1679,20 @@ void MediaMultiCurl::doGetFileCopy( const Pathname & filename , const Pathname &
 	  MetaLinkParser mlp;
 	  mlp.parse(Pathname(destNew));
 	  MediaBlockList bl = mlp.getBlockList();
+	  const MediaBlockList origbl = bl;
 	  vector<Url> urls = mlp.getUrls();
 	  XXX << bl << endl;
+	  // the old data may still be linked to the journal
+	  filesystem::unlink(destNew);
 	  file = fopen(destNew.c_str(), "w+e");
 	  if (!file)
 	    ZYPP_THROW(MediaWriteException(destNew));
+	  if (blockjournal)
+	    {
+	      XXX << "reusing blocks from file " << journal.partFile() << endl;
+	      bl.reuseBlocks(file, journal.partFile().asString(), journal.blocks());
+	      XXX << bl << endl;
+	    }
 	  if (PathInfo(target).isExist())
 	    {
 	      XXX << "reusing blocks from file " << target << endl;
@@ -1425,9 +1713,22 @@ void MediaMultiCurl::doGetFileCopy( const Pathname & filename , const Pathname &
 	      bl.reuseBlocks(file, df.asString());
 	      XXX << bl << endl;
 	    }
+	  // journal what we have so far, the verified blocks follow while downloading
+	  if (origbl.haveChecksum(0) && journal.start(Pathname(destNew)))
+	    {
+	      fflush(file);
+	      addReusedBlocks(journal, origbl, bl);
+	      journal.save();
+	      journaling = true;
+	    }
+	  else
+	    {
+	      journal.remove();
+	      journaling = false;
+	    }
 	  try
 	    {
-	      multifetch(filename, file, &urls, &report, &bl);
+	      multifetch(filename, file, &urls, &report, &bl, off_t(-1), journaling ? &journal : 0);
 	    }
 	  catch (MediaCurlException &ex)
 	    {
@@ -1441,16 +1742,21 @@ void MediaMultiCurl::doGetFileCopy( const Pathname & filename , const Pathname &
 	  if (file)
 	    fclose(file);
 	  file = NULL;
+	  // keep the verified blocks for the next attempt
+	  if (journaling && !journal.blocks().empty() && journal.keep())
+	    MIL << "Keeping partial download " << journal << endl;
+	  else if (journaling)
+	    journal.remove();
+	  // the journal misses blocks not yet verified, so also keep
+	  // the data for a scan by the next attempt
 	  if (PathInfo(destNew).size() >= 63336)
 	    {
 	      ::unlink(failedFile.asString().c_str());
 	      filesystem::hardlinkCopy(destNew, failedFile);
 	    }
+	  filesystem::unlink(destNew);
 	  if (userabort)
-	    {
-	      filesystem::unlink(destNew);
-	      ZYPP_RETHROW(ex);
-	    }
+	    ZYPP_RETHROW(ex);
 	  file = fopen(destNew.c_str(), "w+e");
 	  if (!file)
 	    ZYPP_THROW(MediaWriteException(destNew));
@@ -1473,10 +1779,13 @@ void MediaMultiCurl::doGetFileCopy( const Pathname & filename , const Pathname &
       ERR << "Rename failed" << endl;
       ZYPP_THROW(MediaWriteException(dest));
     }
+  journal.remove();
+  if ( span.active() )
+    span.attr( "bytes", (long long)PathInfo(dest).size() );
   DBG << "done: " << PathInfo(dest) << endl;
 }
 
-void MediaMultiCurl::multifetch(const Pathname & filename, FILE *fp, std::vector<Url> *urllist, callback::SendReport<DownloadProgressReport> *report, MediaBlockList *blklist, off_t filesize) const
+void MediaMultiCurl::multifetch(const Pathname & filename, FILE *fp, std::vector<Url> *urllist, callback::SendReport<DownloadProgressReport> *report, MediaBlockList *blklist, off_t filesize, DownloadJournal *journal) const
 {
   Url baseurl(getFileUrl(filename));
   if (blklist && filesize == off_t(-1) && blklist->haveFilesize())
@@ -1495,6 +1804,11 @@ void MediaMultiCurl::multifetch(const Pathname & filename, FILE *fp, std::vector
       _multi = curl_multi_init();
       if (!_multi)
 	ZYPP_THROW(MediaCurlInitException(baseurl));
+#if CURLVERSION_AT_LEAST(7,43,0)
+      // run the range requests to a HTTP/2 mirror as streams of one connection
+      if (_settings.http2Enabled())
+	curl_multi_setopt(_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+#endif
     }
   multifetchrequest req(this, filename, baseurl, _multi, fp, report, blklist, filesize);
   req._timeout = _settings.timeout();
@@ -1521,12 +1835,40 @@ void MediaMultiCurl::multifetch(const Pathname & filename, FILE *fp, std::vector
 	{
 	}
     }
+  // the workers write to the fd directly
+  if (fp)
+    fflush(fp);
+  // fastest known mirrors first, drop the ones failing recently
+  scoreboard().order(myurllist, BLKSIZE, req._maxworkers, MAXURLS);
   if (!myurllist.size())
     myurllist.push_back(baseurl);
-  req.run(myurllist);
+  req.setJournal(journal);
+  try
+    {
+      req.run(myurllist);
+    }
+  catch (Exception &ex)
+    {
+      ZYPP_CAUGHT(ex);
+      req.saveJournal();
+      const MediaCurlException *cex = dynamic_cast<const MediaCurlException *>(&ex);
+      if (!cex || cex->errstr() != "User abort")
+	req.updateScoreboard(scoreboard());
+      scoreboard().save();
+      ZYPP_RETHROW(ex);
+    }
+  req.updateScoreboard(scoreboard());
+  scoreboard().save();
   checkFileDigest(baseurl, fp, blklist);
 }
 
+MirrorScoreboard & MediaMultiCurl::scoreboard() const
+{
+  if (!_scoreboard)
+    _scoreboard.reset(new MirrorScoreboard(ZConfig::instance().repoCachePath() / "MirrorScoreboard"));
+  return *_scoreboard;
+}
+
 void MediaMultiCurl::checkFileDigest(Url &url, FILE *fp, MediaBlockList *blklist) const
 {
   if (!blklist || !blklist->haveFileChecksum())
@@ -36,6 +36,8 @@ namespace zypp {
 
 class multifetchrequest;
 class multifetchworker;
+class MirrorScoreboard;
+class DownloadJournal;
 
 class MediaMultiCurl : public MediaCurl {
 public:
@@ -47,7 +49,12 @@ public:
 
   virtual void doGetFileCopy( const Pathname & srcFilename, const Pathname & targetFilename, callback::SendReport<DownloadProgressReport> & _report, RequestOptions options = OPTION_NONE ) const;
 
-  void multifetch(const Pathname &filename, FILE *fp, std::vector<Url> *urllist, callback::SendReport<DownloadProgressReport> *report = 0, MediaBlockList *blklist = 0, off_t filesize = off_t(-1)) const;
+  /**
+   * Download from the mirrors in \a urllist into \a fp. If a
+   * \a journal is passed, the blocks verified by their checksum
+   * are recorded in it, so an interrupted download can be resumed.
+   **/
+  void multifetch(const Pathname &filename, FILE *fp, std::vector<Url> *urllist, callback::SendReport<DownloadProgressReport> *report = 0, MediaBlockList *blklist = 0, off_t filesize = off_t(-1), DownloadJournal *journal = 0) const;
 
 protected:
 
@@ -59,6 +66,8 @@ protected:
 
   virtual void setupEasy();
   void checkFileDigest(Url &url, FILE *fp, MediaBlockList *blklist) const;
+  /** Mirror statistics (loaded on demand). */
+  MirrorScoreboard & scoreboard() const;
   static int progressCallback( void *clientp, double dltotal, double dlnow, double ultotal, double ulnow );
 
 private:
@@ -67,6 +76,7 @@ private:
   mutable CURLM *_multi;	// reused for all fetches so we can make use of the dns cache
   mutable std::set<std::string> _dnsok;
   mutable std::map<std::string, CURL *> _easypool;
+  mutable scoped_ptr<MirrorScoreboard> _scoreboard;
 };
 
 ///////////////////////////////////////////////////////////////////
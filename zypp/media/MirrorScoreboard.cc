@@ -0,0 +1,273 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/media/MirrorScoreboard.cc
+ *
+*/
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <boost/interprocess/sync/file_lock.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+
+#include "zypp/base/Logger.h"
+#include "zypp/base/Easy.h"
+#include "zypp/base/String.h"
+
+#include "zypp/PathInfo.h"
+#include "zypp/TmpPath.h"
+
+#include "zypp/media/MirrorScoreboard.h"
+
+using std::endl;
+using boost::interprocess::file_lock;
+using boost::interprocess::scoped_lock;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace media
+  { /////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    namespace
+    { /////////////////////////////////////////////////////////////////
+
+      /** \a score_r as of \a now_r (failures decayed). */
+      MirrorScoreboard::Score decayed( MirrorScoreboard::Score score_r, time_t now_r )
+      {
+        if ( score_r.failures && now_r > score_r.stamp )
+          score_r.failures *= ::pow( 0.5, double(now_r - score_r.stamp) / MirrorScoreboard::halfLife );
+        return score_r;
+      }
+
+      /** Mirror to sort in \ref MirrorScoreboard::order. */
+      struct Candidate
+      {
+        Candidate( unsigned idx_r, int group_r, double cost_r )
+        : idx( idx_r ), group( group_r ), cost( cost_r )
+        {}
+        unsigned idx;
+        int      group;	//!< 0: known good, 1: unknown, 2: failing
+        double   cost;
+
+        bool operator<( const Candidate & rhs ) const
+        {
+          if ( group != rhs.group )
+            return group < rhs.group;
+          if ( group == 0 )
+            return cost < rhs.cost;
+          return false;	// stable: keep the metalink order
+        }
+      };
+
+      /////////////////////////////////////////////////////////////////
+    } // namespace
+    ///////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : MirrorScoreboard::Score
+    //
+    ///////////////////////////////////////////////////////////////////
+
+    double MirrorScoreboard::Score::cost( double blksize_r ) const
+    {
+      if ( speed <= 0 )
+        return 0;
+      return latency + blksize_r / speed;
+    }
+
+    std::ostream & operator<<( std::ostream & str, const MirrorScoreboard::Score & obj )
+    {
+      return str << str::form( "%.0f B/s %.3fs %.2f failures", obj.speed, obj.latency, obj.failures );
+    }
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : MirrorScoreboard
+    //
+    ///////////////////////////////////////////////////////////////////
+
+    const double MirrorScoreboard::failureLimit = 2.0;
+
+    MirrorScoreboard::MirrorScoreboard()
+    {}
+
+    MirrorScoreboard::MirrorScoreboard( const Pathname & file_r )
+    : _file( file_r )
+    , _scores( read( file_r, ::time( 0 ) ) )
+    {
+      DBG << *this << endl;
+    }
+
+    MirrorScoreboard::ScoreMap MirrorScoreboard::read( const Pathname & file_r, time_t now_r )
+    {
+      ScoreMap ret;
+      if ( file_r.empty() )
+        return ret;
+
+      std::ifstream infile( file_r.c_str() );
+      for( std::string line; std::getline( infile, line ); )
+      {
+        // host speed latency failures stamp
+        if ( line.empty() || line[0] == '#' )
+          continue;
+        std::istringstream l( line );
+        std::string host;
+        Score score;
+        long long stamp = 0;
+        if ( ! ( l >> host >> score.speed >> score.latency >> score.failures >> stamp ) )
+        {
+          WAR << file_r << ": ignore malformed line '" << line << "'" << endl;
+          continue;
+        }
+        score.stamp = stamp;
+        if ( now_r - score.stamp > maxAge )
+          continue;
+        ret[host] = score;
+      }
+      return ret;
+    }
+
+    MirrorScoreboard::Score MirrorScoreboard::score( const std::string & host_r ) const
+    {
+      ScoreMap::const_iterator it( _scores.find( host_r ) );
+      if ( it == _scores.end() )
+        return Score();
+      return decayed( it->second, ::time( 0 ) );
+    }
+
+    void MirrorScoreboard::success( const std::string & host_r, double speed_r, double latency_r )
+    {
+      if ( host_r.empty() )
+        return;
+      Score score( this->score( host_r ) );
+      if ( speed_r > 0 )
+        score.speed = score.speed ? ( score.speed + speed_r ) / 2 : speed_r;
+      if ( latency_r > 0 )
+        score.latency = score.latency ? ( score.latency + latency_r ) / 2 : latency_r;
+      score.failures /= 2;	// a recovered host must not stay demoted
+      score.stamp = ::time( 0 );
+      _updated[host_r] = _scores[host_r] = score;
+      XXX << host_r << ": " << score << endl;
+    }
+
+    void MirrorScoreboard::failure( const std::string & host_r )
+    {
+      if ( host_r.empty() )
+        return;
+      Score score( this->score( host_r ) );
+      score.failures += 1;
+      score.stamp = ::time( 0 );
+      _updated[host_r] = _scores[host_r] = score;
+      XXX << host_r << ": " << score << endl;
+    }
+
+    void MirrorScoreboard::order( std::vector<Url> & urls_r, double blksize_r, unsigned keep_r, unsigned max_r ) const
+    {
+      if ( urls_r.empty() )
+        return;
+
+      std::vector<Candidate> candidates;
+      candidates.reserve( urls_r.size() );
+      unsigned good = 0;
+      for ( unsigned idx = 0; idx < urls_r.size(); ++idx )
+      {
+        Score s( score( urls_r[idx].getHost() ) );
+        int group = ( s.failures >= failureLimit ? 2 : s.speed > 0 ? 0 : 1 );
+        if ( group != 2 )
+          ++good;
+        candidates.push_back( Candidate( idx, group, s.cost( blksize_r ) ) );
+      }
+      std::stable_sort( candidates.begin(), candidates.end() );
+
+      std::vector<Url> ret;
+      ret.reserve( urls_r.size() );
+      for_( it, candidates.begin(), candidates.end() )
+      {
+        if ( it->group == 2 && good >= keep_r )
+        {
+          DBG << "Skip failing mirror " << urls_r[it->idx].getHost() << endl;
+          continue;
+        }
+        if ( max_r && ret.size() == max_r )
+          break;
+        ret.push_back( urls_r[it->idx] );
+      }
+      urls_r.swap( ret );
+    }
+
+    bool MirrorScoreboard::save()
+    {
+      if ( _file.empty() || _updated.empty() )
+        return false;
+
+      filesystem::assert_dir( _file.dirname() );
+      Pathname lockfile( _file.extend( ".lock" ) );
+      std::ofstream( lockfile.c_str(), std::ios::app );	// file_lock needs an existing file
+
+      ScoreMap scores;
+      try
+      {
+        // Serialize read, merge and rename with other processes.
+        file_lock lock( lockfile.c_str() );
+        scoped_lock<file_lock> guard( lock );
+
+        // merge with what other processes wrote meanwhile
+        scores = read( _file, ::time( 0 ) );
+        for_( it, _updated.begin(), _updated.end() )
+          scores[it->first] = it->second;
+
+        filesystem::TmpFile tmp( filesystem::TmpFile::makeSibling( _file ) );
+        if ( ! tmp )
+          return false;
+        {
+          std::ofstream outfile( tmp.path().c_str() );
+          outfile << "# host speed latency failures stamp" << endl;
+          for_( it, scores.begin(), scores.end() )
+          {
+            outfile << it->first
+                    << str::form( " %.0f %.4f %.4f %lld", it->second.speed, it->second.latency, it->second.failures, (long long)it->second.stamp )
+                    << endl;
+          }
+          if ( ! outfile )
+          {
+            WAR << "Can't write " << tmp.path() << endl;
+            return false;
+          }
+        }
+        if ( filesystem::rename( tmp.path(), _file ) != 0 )
+          return false;
+        filesystem::chmod( _file, 0644 );
+      }
+      catch ( const boost::interprocess::interprocess_exception & excpt )
+      {
+        WAR << "Can't lock " << lockfile << ": " << excpt.what() << endl;
+        return false;
+      }
+
+      _scores.swap( scores );
+      _updated.clear();
+      return true;
+    }
+
+    std::ostream & operator<<( std::ostream & str, const MirrorScoreboard & obj )
+    {
+      return str << "MirrorScoreboard(" << obj.file() << "){" << obj.size() << "}";
+    }
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace media
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,151 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/media/MirrorScoreboard.h
+ *
+*/
+#ifndef ZYPP_MEDIA_MIRRORSCOREBOARD_H
+#define ZYPP_MEDIA_MIRRORSCOREBOARD_H
+
+#include <ctime>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <map>
+
+#include "zypp/Pathname.h"
+#include "zypp/Url.h"
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace media
+  { /////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : MirrorScoreboard
+    //
+    /** Persistent per host download statistics used to choose mirrors.
+     *
+     * Remembers the average throughput, the latency (time to the first
+     * byte) and the number of failed downloads per host. \ref order
+     * uses them to sort the mirrors of a metalink, so hosts known to be
+     * fast are tried first and hosts which failed recently are dropped
+     * if there are enough alternatives. Hosts without statistics keep
+     * their metalink order.
+     *
+     * The statistics are kept in a text file (one line per host) which
+     * is merged with the current content on \ref save, so concurrent
+     * processes do not lose each others updates. Failures decay with a
+     * half-life of \ref halfLife seconds and are halved by each successful
+     * download. Hosts not seen for \ref maxAge seconds are forgotten.
+     */
+    class MirrorScoreboard
+    {
+      public:
+        /** Statistics of a single host. */
+        struct Score
+        {
+          Score()
+          : speed( 0 ), latency( 0 ), failures( 0 ), stamp( 0 )
+          {}
+          double speed;		//!< average bytes per second
+          double latency;	//!< average seconds to the first byte
+          double failures;	//!< decayed number of failed downloads
+          time_t stamp;		//!< time of the last update
+
+          /** Estimated seconds to fetch a block of \a blksize_r bytes (\c 0 if unknown). */
+          double cost( double blksize_r ) const;
+        };
+
+        /** Failures are halved every 7 days. */
+        static const time_t halfLife = 7 * 24 * 3600;
+        /** Hosts not updated for 90 days are forgotten. */
+        static const time_t maxAge = 90 * 24 * 3600;
+        /** Hosts with this many (decayed) failures are dropped from mirror lists. */
+        static const double failureLimit;
+
+      public:
+        /** Default ctor: empty, not persistent. */
+        MirrorScoreboard();
+
+        /** Ctor loading statistics from \a file_r (missing file is ok). */
+        MirrorScoreboard( const Pathname & file_r );
+
+      public:
+        /** The file we read from and \ref save to. */
+        const Pathname & file() const
+        { return _file; }
+
+        /** Whether there are no statistics. */
+        bool empty() const
+        { return _scores.empty(); }
+
+        /** Number of hosts with statistics. */
+        unsigned size() const
+        { return _scores.size(); }
+
+        /** Statistics for \a host_r as of now, failures decayed (default constructed if unknown). */
+        Score score( const std::string & host_r ) const;
+
+        /** The average speed of \a host_r (\c 0 if unknown). */
+        double speed( const std::string & host_r ) const
+        { return score( host_r ).speed; }
+
+      public:
+        /** A download from \a host_r succeeded with \a speed_r bytes/s and \a latency_r seconds to the first byte. */
+        void success( const std::string & host_r, double speed_r, double latency_r );
+
+        /** A download from \a host_r failed. */
+        void failure( const std::string & host_r );
+
+        /** Sort \a urls_r by the hosts score and drop failing hosts.
+         *
+         * Hosts with statistics are sorted by their estimated cost for
+         * \a blksize_r bytes, followed by the unknown hosts in the
+         * original order, followed by the hosts above \ref failureLimit.
+         * The latter are removed if at least \a keep_r urls remain. At
+         * most \a max_r urls are kept (unlimited if \c 0).
+         */
+        void order( std::vector<Url> & urls_r, double blksize_r, unsigned keep_r = 1, unsigned max_r = 0 ) const;
+
+        /** Merge with the current file content and write it back.
+         * Other processes are locked out (by a \c .lock file next to
+         * \ref file) until the new content is in place.
+         * \return Whether the file was written.
+         */
+        bool save();
+
+      private:
+        typedef std::map<std::string,Score> ScoreMap;
+        /** Read \a file_r content, dropping hosts not updated for \ref maxAge.
+         * Scores are stored as read; failures are decayed by \ref score.
+         */
+        static ScoreMap read( const Pathname & file_r, time_t now_r );
+
+        Pathname _file;
+        ScoreMap _scores;	//!< all known hosts
+        ScoreMap _updated;	//!< hosts updated by us
+    };
+    ///////////////////////////////////////////////////////////////////
+
+    /** \relates MirrorScoreboard::Score Stream output */
+    std::ostream & operator<<( std::ostream & str, const MirrorScoreboard::Score & obj );
+
+    /** \relates MirrorScoreboard Stream output */
+    std::ostream & operator<<( std::ostream & str, const MirrorScoreboard & obj );
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace media
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_MEDIA_MIRRORSCOREBOARD_H
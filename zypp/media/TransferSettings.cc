@@ -35,6 +35,8 @@ public:
         , _verify_peer(false)
         , _ca_path("/etc/ssl/certs")
         , _head_requests_allowed(true)
+        , _http2(false)
+        , _compression(false)
     {}
 
     virtual ~Impl()
@@ -79,6 +81,9 @@ public:
  
     // workarounds
     bool _head_requests_allowed;
+
+    bool _http2;
+    bool _compression;
 };
     
 TransferSettings::TransferSettings()
@@ -313,6 +318,26 @@ bool TransferSettings::headRequestsAllowed() const
     return _impl->_head_requests_allowed;    
 } 
 
+void TransferSettings::setHttp2Enabled( bool enabled )
+{
+    _impl->_http2 = enabled;
+}
+
+bool TransferSettings::http2Enabled() const
+{
+    return _impl->_http2;
+}
+
+void TransferSettings::setCompressionEnabled( bool enabled )
+{
+    _impl->_compression = enabled;
+}
+
+bool TransferSettings::compressionEnabled() const
+{
+    return _impl->_compression;
+}
+
 } // ns media
 } // ns zypp
 
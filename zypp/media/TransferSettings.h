@@ -254,6 +254,29 @@ public:
    */
   bool headRequestsAllowed() const;
 
+  /**
+   * set whether to use HTTP/2 (with multiplexing) if the server supports it
+   * ( default: false )
+   */
+  void setHttp2Enabled( bool enabled );
+
+  /**
+   * whether to use HTTP/2 if the server supports it
+   */
+  bool http2Enabled() const;
+
+  /**
+   * set whether to request compressed transfers of uncompressed files
+   * ( default: false, enable by the \c compress=yes url option ).
+   * Range requests are always sent without \c Accept-Encoding.
+   */
+  void setCompressionEnabled( bool enabled );
+
+  /**
+   * whether to request compressed transfers of uncompressed files
+   */
+  bool compressionEnabled() const;
+
 protected:
   class Impl;
   RWCOW_pointer<Impl> _impl;
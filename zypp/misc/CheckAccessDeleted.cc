@@ -9,8 +9,15 @@
 /** \file	zypp/misc/CheckAccessDeleted.cc
  *
 */
+#include <sys/types.h>
+#include <unistd.h>
+#include <pwd.h>
 #include <iostream>
+#include <fstream>
 #include <unordered_set>
+#include <unordered_map>
+#include <thread>
+#include <atomic>
 #include "zypp/base/LogTools.h"
 #include "zypp/base/String.h"
 #include "zypp/base/Gettext.h"
@@ -169,6 +176,194 @@ namespace zypp
       cache_r.second.insert( n );
     }
     /////////////////////////////////////////////////////////////////
+    /////////////////////////////////////////////////////////////////
+    //
+    // Native scanner reading /proc/<pid>/{status,exe,maps} directly.
+    //
+    // We collect the same kind of files lsof would report as 'txt' or
+    // 'mem'/'DEL' entries: the deleted executable and deleted memory
+    // mapped files (libraries). Deleted files merely held open via a
+    // filedescriptor were never reported, so /proc/<pid>/fd is not
+    // scanned.
+    //
+    /////////////////////////////////////////////////////////////////
+
+    /** Suffix the kernel appends to names of unlinked files. */
+    const std::string deletedSuffix( " (deleted)" );
+
+    /** Whether a deleted file is worth being reported (see \ref addCacheIf). */
+    inline bool wantDeletedFile( const std::string & name_r, bool mapped_r, bool verbose_r )
+    {
+      if ( ! verbose_r )
+      {
+        if ( ! ( str::contains( name_r, "/lib" ) || str::contains( name_r, "bin/" ) ) )
+          return false; // Try to avoid reporting false positive unless verbose.
+      }
+
+      if ( mapped_r )	// skip some wellknown nonlibrary memorymapped files
+      {
+        static const char * black[] = {
+            "/SYSV"
+          , "/var/run/"
+          , "/dev/"
+          , "/memfd:"
+        };
+        for_( it, arrayBegin( black ), arrayEnd( black ) )
+        {
+          if ( str::hasPrefix( name_r, *it ) )
+            return false;
+        }
+      }
+      return true;
+    }
+
+    /** A \ref CheckAccessDeleted::ProcInfo plus the numeric uid we need for the login lookup. */
+    struct ProcScan
+    {
+      uid_t uid;
+      CheckAccessDeleted::ProcInfo pinfo;
+    };
+
+    /** Scan one process; return \c false if it does not access deleted files (or vanished meanwhile). */
+    bool scanProc( pid_t pid_r, bool verbose_r, ProcScan & ret_r )
+    {
+      const Pathname procdir( Pathname("/proc")/str::numstring( pid_r ) );
+      std::unordered_set<std::string> filelist;
+
+      // deleted executable ('txt'):
+      std::string exe( filesystem::readlink( procdir/"exe" ).asString() );
+      if ( str::hasSuffix( exe, deletedSuffix ) )
+      {
+        exe.erase( exe.size() - deletedSuffix.size() );
+        if ( wantDeletedFile( exe, false, verbose_r ) )
+          filelist.insert( exe );
+      }
+
+      // deleted mapped files ('mem'/'DEL'):
+      // "7f..-7f.. r-xp 00000000 08:01 1234     /usr/lib64/libfoo.so.1 (deleted)"
+      {
+        std::ifstream maps( (procdir/"maps").c_str() );
+        for( std::string line; std::getline( maps, line ); )
+        {
+          if ( ! str::hasSuffix( line, deletedSuffix ) )
+            continue;
+          std::string::size_type pos = line.find( '/' );
+          if ( pos == std::string::npos )
+            continue;	// anon mapping
+          std::string name( line, pos, line.size() - pos - deletedSuffix.size() );
+          if ( wantDeletedFile( name, true, verbose_r ) )
+            filelist.insert( name );
+        }
+      }
+
+      if ( filelist.empty() )
+        return false;
+
+      ret_r.uid = uid_t(-1);
+      CheckAccessDeleted::ProcInfo & pinfo( ret_r.pinfo );
+      pinfo = CheckAccessDeleted::ProcInfo();
+      pinfo.pid = str::numstring( pid_r );
+      pinfo.files.insert( pinfo.files.begin(), filelist.begin(), filelist.end() );
+
+      // "Name:\tcommand", "PPid:\t1", "Uid:\t0\t0\t0\t0"
+      {
+        std::ifstream status( (procdir/"status").c_str() );
+        for( std::string line; std::getline( status, line ); )
+        {
+          if ( str::hasPrefix( line, "Name:" ) )
+            pinfo.command = str::trim( line.substr( 5 ) );
+          else if ( str::hasPrefix( line, "PPid:" ) )
+            pinfo.ppid = str::trim( line.substr( 5 ) );
+          else if ( str::hasPrefix( line, "Uid:" ) )
+          {
+            std::vector<std::string> words;
+            str::split( line.substr( 4 ), std::back_inserter( words ) );
+            if ( ! words.empty() )
+            {
+              pinfo.puid = words[0];
+              str::strtonum( words[0], ret_r.uid );
+            }
+            break;	// Uid: follows Name: and PPid:
+          }
+        }
+      }
+
+      if ( pinfo.command.size() == 15 )
+      {
+        // the command name might be truncated, so we check against /proc/<pid>/exe
+        Pathname command( exe );
+        if ( ! command.empty() )
+          pinfo.command = command.basename();
+      }
+      return true;
+    }
+
+    /** Scan all running processes. Large process tables are scanned by several threads.
+     * \return \c false if \c /proc is not available.
+     */
+    bool scanProcs( std::vector<CheckAccessDeleted::ProcInfo> & data_r, bool verbose_r )
+    {
+      std::vector<pid_t> pids;
+      {
+        const pid_t self = ::getpid();
+        int res = filesystem::dirForEach( "/proc", [&pids,self]( const Pathname &, const char *const name_r )->bool {
+          pid_t pid = str::strtonum<pid_t>( name_r );	// 0 if not numeric
+          if ( pid > 0 && pid != self )
+            pids.push_back( pid );
+          return true;
+        } );
+        if ( res != 0 || ! PathInfo( "/proc/self/maps" ).isFile() )
+          return false;
+      }
+
+      std::vector<ProcScan> results( pids.size() );
+      std::vector<char> found( pids.size(), 0 );
+      std::atomic<size_t> next( 0 );
+      auto worker = [&]() {
+        for ( size_t idx = next++; idx < pids.size(); idx = next++ )
+          found[idx] = scanProc( pids[idx], verbose_r, results[idx] );
+      };
+
+      unsigned nthreads = std::min( std::thread::hardware_concurrency(), 8U );
+      if ( pids.size() < 256 )
+        nthreads = 1;	// not worth the overhead
+      std::vector<std::thread> threads;
+      try
+      {
+        for ( unsigned i = 1; i < nthreads; ++i )
+          threads.push_back( std::thread( worker ) );
+      }
+      catch ( const std::system_error & excpt )
+      {
+        WAR << "Can't start scanner thread: " << excpt.what() << endl;
+      }
+      worker();
+      for ( auto & thread : threads )
+        thread.join();
+
+      // pids were read in ascending order; resolve login names (not MT safe)
+      std::unordered_map<uid_t,std::string> logins;
+      for ( size_t idx = 0; idx < pids.size(); ++idx )
+      {
+        if ( ! found[idx] )
+          continue;
+        ProcScan & scan( results[idx] );
+        if ( scan.uid != uid_t(-1) )
+        {
+          auto it( logins.find( scan.uid ) );
+          if ( it == logins.end() )
+          {
+            struct passwd * pw = ::getpwuid( scan.uid );
+            it = logins.insert( std::make_pair( scan.uid, std::string( pw ? pw->pw_name : "" ) ) ).first;
+          }
+          scan.pinfo.login = it->second;
+        }
+        data_r.push_back( std::move( scan.pinfo ) );
+      }
+      return true;
+    }
+
+    /////////////////////////////////////////////////////////////////
   } // namespace
   ///////////////////////////////////////////////////////////////////
 
@@ -176,6 +371,20 @@ namespace zypp
   {
     _data.clear();
 
+    std::vector<ProcInfo> data;
+    if ( scanProcs( data, verbose_r ) )
+    {
+      _data.swap( data );
+      return _data.size();
+    }
+    WAR << "/proc not available; trying lsof..." << endl;
+    return checkLsof( verbose_r );
+  }
+
+  CheckAccessDeleted::size_type CheckAccessDeleted::checkLsof( bool verbose_r )
+  {
+    _data.clear();
+
     static const char* argv[] =
     {
       "lsof", "-n", "-FpcuLRftkn0", NULL
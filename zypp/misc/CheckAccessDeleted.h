@@ -78,11 +78,20 @@ namespace zypp
        * A verbose check will omit this test and collect all processes uning
        * any deleted file.
        *
+       * The data are collected by scanning \c /proc/<pid>/exe and
+       * \c /proc/<pid>/maps of all running processes. If \c /proc is not
+       * available, \c lsof is used instead.
+       *
        * \return the number of processes found.
        * \throws Exception On error collecting the data (e.g. no lsof installed)
        */
       size_type check( bool verbose_r = false );
 
+      /** Same as \ref check, but always collecting the data via \c lsof.
+       * \throws Exception On error collecting the data (e.g. no lsof installed)
+       */
+      size_type checkLsof( bool verbose_r = false );
+
       bool empty() const		{ return _data.empty(); }
       size_type size() const		{ return _data.size(); }
       const_iterator begin() const	{ return _data.begin(); }
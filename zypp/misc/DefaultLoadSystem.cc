@@ -10,9 +10,12 @@
  *
 */
 #include <iostream>
+#include <sstream>
 
 #include "zypp/base/LogTools.h"
 #include "zypp/PathInfo.h"
+#include "zypp/Digest.h"
+#include "zypp/ZConfig.h"
 
 #include "zypp/misc/DefaultLoadSystem.h"
 
@@ -33,6 +36,23 @@ namespace zypp
   ///////////////////////////////////////////////////////////////////
   namespace misc
   { /////////////////////////////////////////////////////////////////
+    namespace
+    {
+      /** The pool snapshots cookie: libzypp version, system architecture
+       * and the solv file cookies of the repos to load.
+       * \c @System is not part of the snapshot, so the rpm database is not
+       * either. File provides \c @System needs which the snapshot does not
+       * remember are simply added when the pool is prepared.
+       */
+      std::string snapshotCookie( const RepoManager & repoManager_r, const RepoInfoList & repos_r )
+      {
+        std::ostringstream str;
+        str << VERSION << " " << ZConfig::instance().systemArchitecture() << endl;
+        for_( it, repos_r.begin(), repos_r.end() )
+          str << it->alias() << " " << repoManager_r.cacheStatus( *it ).checksum() << endl;
+        return Digest::digest( Digest::sha1(), str.str() );
+      }
+    } // namespace
 
     void defaultLoadSystem( const Pathname & sysRoot_r, LoadSystemFlags flags_r )
     {
@@ -61,6 +81,7 @@ namespace zypp
       {
         RepoManager repoManager( sysRoot_r );
         RepoInfoList repos = repoManager.knownRepositories();
+        RepoInfoList toLoad;
         for_( it, repos.begin(), repos.end() )
         {
           RepoInfo & nrepo( *it );
@@ -87,6 +108,36 @@ namespace zypp
             repoManager.buildCache( nrepo );
           }
 
+          toLoad.push_back( nrepo );
+        }
+
+        Pathname snapshot;
+        std::string cookie;
+        if ( flags_r.testFlag( LS_SNAPSHOT ) && ! toLoad.empty() )
+        {
+          snapshot = RepoManagerOptions( sysRoot_r ).repoCachePath / "pool.snapshot";
+          cookie = snapshotCookie( repoManager, toLoad );
+          try
+          {
+            std::vector<Repository> loaded( satpool.loadSnapshot( snapshot, cookie ) );
+            if ( ! loaded.empty() )
+            {
+              for_( it, toLoad.begin(), toLoad.end() )
+                satpool.reposFind( it->alias() ).setInfo( *it );
+              MIL << str::form( "*** Read system at '%s' (snapshot)", sysRoot_r.c_str() ) << endl;
+              return;
+            }
+          }
+          catch ( const Exception & exp )
+          {
+            WAR << "*** load snapshot failed: " << exp.asString() << endl;
+          }
+        }
+
+        for_( it, toLoad.begin(), toLoad.end() )
+        {
+          RepoInfo & nrepo( *it );
+
           MIL << str::form( "*** load repo '%s'\t", nrepo.name().c_str() ) << std::flush;
           try
           {
@@ -99,6 +150,19 @@ namespace zypp
             ZYPP_RETHROW ( exp );
           }
         }
+        repoManager.updateSolvCaches();
+
+        if ( ! snapshot.empty() )
+        {
+          try
+          {
+            satpool.saveSnapshot( snapshot, cookie );
+          }
+          catch ( const Exception & exp )
+          {
+            WAR << "*** save snapshot failed: " << exp.asString() << endl;
+          }
+        }
       }
       MIL << str::form( "*** Read system at '%s'", sysRoot_r.c_str() ) << endl;
     }
@@ -33,7 +33,8 @@ namespace zypp
     enum LoadSystemFlag
     {
       LS_READONLY	= (1 << 0),	//!< // Create readonly ZYpp instance.
-      LS_NOREFRESH	= (1 << 1)	//!< // Don't refresh existing repos.
+      LS_NOREFRESH	= (1 << 1),	//!< // Don't refresh existing repos.
+      LS_SNAPSHOT	= (1 << 2)	//!< // Load the repos from (and update) the pool snapshot.
     };
 
     /** \relates LoadSystemFlag Type-safe way of storing OR-combinations. */
@@ -44,6 +45,13 @@ namespace zypp
      *
      * \see LoadSystemFlag for options.
      *
+     * With \ref LS_SNAPSHOT the enabled repos are loaded from a pool
+     * snapshot in the repo cache directory, if it's still valid for the
+     * cached repos and the system architecture. Otherwise
+     * they are loaded as usual and a new snapshot is written. Refreshing and
+     * building the repos caches is not affected by this flag.
+     * \see sat::Pool::loadSnapshot
+     *
      * \throws Exception on error
      *
      * \todo properly handle service refreshs
@@ -0,0 +1,351 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/parser/IniDictSnapshot.cc
+ *
+*/
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <list>
+
+#include "zypp/base/Logger.h"
+#include "zypp/base/Easy.h"
+#include "zypp/base/String.h"
+#include "zypp/base/Gettext.h"
+#include "zypp/base/Exception.h"
+#include "zypp/base/InputStream.h"
+
+#include "zypp/PathInfo.h"
+#include "zypp/TmpPath.h"
+
+#include "zypp/parser/IniDictSnapshot.h"
+
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace parser
+  { /////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    namespace
+    { /////////////////////////////////////////////////////////////////
+
+      /** Identifies the snapshot format; change it if the layout changes. */
+      const char snapshotMagic[] = "ZYPP-INIDICT-SNAPSHOT 1\n";
+
+      /** Append numbers (host byte order) and length prefixed strings. */
+      struct Writer
+      {
+        void number( unsigned long long num_r )
+        { buf.append( reinterpret_cast<const char *>( &num_r ), sizeof(num_r) ); }
+
+        void string( const std::string & str_r )
+        {
+          number( str_r.size() );
+          buf.append( str_r );
+        }
+
+        std::string buf;
+      };
+
+      /** Read what \ref Writer wrote; \c ok turns \c false on truncated input. */
+      struct Reader
+      {
+        Reader( const std::string & buf_r )
+        : buf( buf_r ), pos( 0 ), ok( true )
+        {}
+
+        unsigned long long number()
+        {
+          unsigned long long ret = 0;
+          if ( ! ok || buf.size() - pos < sizeof(ret) )
+          {
+            ok = false;
+            return 0;
+          }
+          ::memcpy( &ret, buf.data() + pos, sizeof(ret) );
+          pos += sizeof(ret);
+          return ret;
+        }
+
+        std::string string()
+        {
+          unsigned long long len = number();
+          if ( ! ok || buf.size() - pos < len )
+          {
+            ok = false;
+            return std::string();
+          }
+          std::string ret( buf, pos, len );
+          pos += len;
+          return ret;
+        }
+
+        const std::string & buf;
+        std::string::size_type pos;
+        bool ok;
+      };
+
+      /////////////////////////////////////////////////////////////////
+    } // namespace
+    ///////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : IniDictSnapshot
+    //
+    ///////////////////////////////////////////////////////////////////
+
+    IniDictSnapshot::IniDictSnapshot()
+    : _stamp( 0 )
+    , _now( ::time( 0 ) )
+    , _parsed( 0 )
+    , _changed( false )
+    {}
+
+    IniDictSnapshot::IniDictSnapshot( const Pathname & file_r )
+    : _file( file_r )
+    , _stamp( 0 )
+    , _now( ::time( 0 ) )
+    , _parsed( 0 )
+    , _changed( false )
+    {
+      load();
+      DBG << *this << endl;
+    }
+
+    void IniDictSnapshot::load()
+    {
+      PathInfo pi( _file );
+      if ( ! pi.isFile() )
+        return;
+
+      std::string buf( pi.size(), '\0' );
+      {
+        std::ifstream infile( _file.c_str(), std::ios::binary );
+        if ( ! infile.read( &buf[0], buf.size() ) )
+        {
+          WAR << "Can't read " << _file << endl;
+          return;
+        }
+      }
+      if ( buf.compare( 0, sizeof(snapshotMagic)-1, snapshotMagic ) != 0 )
+      {
+        WAR << "Ignore snapshot in unknown format " << _file << endl;
+        return;
+      }
+
+      Reader in( buf );
+      in.pos = sizeof(snapshotMagic)-1;
+      time_t stamp = in.number();
+      DirMap dirs;
+      for ( unsigned long long ndirs = in.number(); in.ok && ndirs; --ndirs )
+      {
+        DirData & dir( dirs[in.string()] );
+        dir.mtime = in.number();
+        for ( unsigned long long nentries = in.number(); in.ok && nentries; --nentries )
+          dir.entries.push_back( in.string() );
+      }
+      FileMap files;
+      for ( unsigned long long nfiles = in.number(); in.ok && nfiles; --nfiles )
+      {
+        FileData & file( files[in.string()] );
+        file.mtime = in.number();
+        file.size = in.number();
+        file.ino = in.number();
+        for ( unsigned long long nsections = in.number(); in.ok && nsections; --nsections )
+        {
+          IniDict::EntrySet & section( file.sections[in.string()] );
+          for ( unsigned long long nentries = in.number(); in.ok && nentries; --nentries )
+          {
+            std::string key( in.string() );
+            section[key] = in.string();
+          }
+        }
+      }
+      if ( ! in.ok || in.pos != buf.size() )
+      {
+        WAR << "Ignore truncated snapshot " << _file << endl;
+        return;
+      }
+
+      _stamp = stamp;
+      _olddirs.swap( dirs );
+      _oldfiles.swap( files );
+    }
+
+    bool IniDictSnapshot::unchanged( const PathInfo & pi_r, time_t mtime_r ) const
+    {
+      // modified in the second the snapshot was taken: mtime can't tell
+      return pi_r.isExist() && pi_r.mtime() == mtime_r && mtime_r < _stamp;
+    }
+
+    bool IniDictSnapshot::parse( const Pathname & file_r, IniDict & dict_r )
+    {
+      InputStream is( file_r );
+      if ( is.stream().fail() )
+      {
+        WAR << "Can't open " << file_r << endl;
+        return false;
+      }
+      dict_r.read( is );
+      return true;
+    }
+
+    void IniDictSnapshot::readDir( const Pathname & dir_r, const ProcessDict & consume_r, const FileFilter & filter_r )
+    {
+      PathInfo dirinfo( dir_r );
+      DirMap::const_iterator olddir( _olddirs.find( dir_r ) );
+      DirData & dir( _dirs[dir_r] );
+      if ( olddir != _olddirs.end() && dirinfo.isDir() && unchanged( dirinfo, olddir->second.mtime ) )
+      {
+        dir = olddir->second;
+      }
+      else
+      {
+        std::list<std::string> entries;
+        if ( filesystem::readdir( entries, dir_r, false ) != 0 )
+        {
+          _dirs.erase( dir_r );
+          // TranslatorExplanation '%s' is a pathname
+          ZYPP_THROW(Exception(str::form(_("Failed to read directory '%s'"), dir_r.c_str())));
+        }
+        dir.mtime = dirinfo.mtime();
+        dir.entries.assign( entries.begin(), entries.end() );
+        _changed = true;
+      }
+
+      for_( it, dir.entries.begin(), dir.entries.end() )
+      {
+        Pathname path( dir_r / *it );
+        if ( filter_r && ! filter_r( path ) )
+          continue;
+
+        PathInfo fileinfo( path );
+        IniDict dict;
+        FileMap::const_iterator oldfile( _oldfiles.find( path ) );
+        if ( oldfile != _oldfiles.end()
+             && fileinfo.isFile()
+             && fileinfo.size() == oldfile->second.size
+             && fileinfo.ino() == oldfile->second.ino
+             && unchanged( fileinfo, oldfile->second.mtime ) )
+        {
+          const FileData & file( _files[path] = oldfile->second );
+          for_( sit, file.sections.begin(), file.sections.end() )
+          {
+            dict.consume( sit->first );
+            for_( eit, sit->second.begin(), sit->second.end() )
+              dict.insertEntry( sit->first, eit->first, eit->second );
+          }
+        }
+        else
+        {
+          ++_parsed;
+          _changed = true;
+          if ( parse( path, dict ) && fileinfo.isFile() )
+          {
+            FileData & file( _files[path] );
+            file.mtime = fileinfo.mtime();
+            file.size = fileinfo.size();
+            file.ino = fileinfo.ino();
+            for_( sit, dict.sectionsBegin(), dict.sectionsEnd() )
+            {
+              IniDict::EntrySet & section( file.sections[*sit] );
+              section.insert( dict.entriesBegin( *sit ), dict.entriesEnd( *sit ) );
+            }
+          }
+        }
+        consume_r( path, dict );
+      }
+    }
+
+    bool IniDictSnapshot::dirty() const
+    {
+      return _changed || _dirs.size() != _olddirs.size() || _files.size() != _oldfiles.size();
+    }
+
+    bool IniDictSnapshot::save()
+    {
+      if ( _file.empty() || ! dirty() )
+        return false;
+
+      Writer out;
+      out.buf = snapshotMagic;
+      out.number( _now );
+      out.number( _dirs.size() );
+      for_( it, _dirs.begin(), _dirs.end() )
+      {
+        out.string( it->first.asString() );
+        out.number( it->second.mtime );
+        out.number( it->second.entries.size() );
+        for_( eit, it->second.entries.begin(), it->second.entries.end() )
+          out.string( *eit );
+      }
+      out.number( _files.size() );
+      for_( it, _files.begin(), _files.end() )
+      {
+        out.string( it->first.asString() );
+        out.number( it->second.mtime );
+        out.number( it->second.size );
+        out.number( it->second.ino );
+        out.number( it->second.sections.size() );
+        for_( sit, it->second.sections.begin(), it->second.sections.end() )
+        {
+          out.string( sit->first );
+          out.number( sit->second.size() );
+          for_( eit, sit->second.begin(), sit->second.end() )
+          {
+            out.string( eit->first );
+            out.string( eit->second );
+          }
+        }
+      }
+
+      filesystem::assert_dir( _file.dirname() );
+      filesystem::TmpFile tmp( filesystem::TmpFile::makeSibling( _file ) );
+      if ( ! tmp )
+        return false;
+      {
+        std::ofstream outfile( tmp.path().c_str(), std::ios::binary );
+        outfile.write( out.buf.data(), out.buf.size() );
+        if ( ! outfile )
+        {
+          WAR << "Can't write " << tmp.path() << endl;
+          return false;
+        }
+      }
+      // the snapshot may contain credentials from the parsed files
+      filesystem::chmod( tmp.path(), 0600 );
+      if ( filesystem::rename( tmp.path(), _file ) != 0 )
+        return false;
+
+      _stamp = _now;
+      _olddirs = _dirs;
+      _oldfiles = _files;
+      _changed = false;
+      MIL << "Saved " << *this << endl;
+      return true;
+    }
+
+    std::ostream & operator<<( std::ostream & str, const IniDictSnapshot & obj )
+    {
+      return str << "IniDictSnapshot(" << obj._file << "){"
+                 << obj._olddirs.size() << " dirs, " << obj._oldfiles.size() << " files, "
+                 << obj._parsed << " parsed}";
+    }
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace parser
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,155 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/parser/IniDictSnapshot.h
+ *
+*/
+#ifndef ZYPP_PARSER_INIDICTSNAPSHOT_H
+#define ZYPP_PARSER_INIDICTSNAPSHOT_H
+
+#include <ctime>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <map>
+
+#include "zypp/base/NonCopyable.h"
+#include "zypp/base/Function.h"
+#include "zypp/Pathname.h"
+#include "zypp/PathInfo.h"
+#include "zypp/parser/IniDict.h"
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace parser
+  { /////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : IniDictSnapshot
+    //
+    /** Cached content of the ini files in some directories.
+     *
+     * \ref readDir passes the parsed content of each file in a
+     * directory to a callback. Files (and directory listings) are
+     * taken from the snapshot if their mtime, size and inode did not change,
+     * otherwise they are parsed and the snapshot is updated. \ref save
+     * writes the files and directories visited by \ref readDir back to
+     * disk, so the next process loads them in one read instead of
+     * parsing every file.
+     *
+     * Like git's index, entries modified in the second the snapshot
+     * was taken are not trusted, as a later change in the same second
+     * would not alter the mtime.
+     *
+     * \code
+     *   IniDictSnapshot snapshot( cachedir / "repos.d.snapshot" );
+     *   snapshot.readDir( "/etc/zypp/repos.d", bind( &consume, _1, _2 ) );
+     *   snapshot.save();
+     * \endcode
+     */
+    class IniDictSnapshot : private base::NonCopyable
+    {
+      friend std::ostream & operator<<( std::ostream & str, const IniDictSnapshot & obj );
+
+      public:
+        /** Called with each file and its content. */
+        typedef function<void( const Pathname &, const IniDict & )> ProcessDict;
+        /** Whether a directory entry should be processed (all if empty). */
+        typedef function<bool( const Pathname & )> FileFilter;
+
+      public:
+        /** Default ctor: empty, not persistent. */
+        IniDictSnapshot();
+
+        /** Ctor loading the snapshot from \a file_r (missing or invalid file is ok). */
+        IniDictSnapshot( const Pathname & file_r );
+
+      public:
+        /** The file we read from and \ref save to. */
+        const Pathname & file() const
+        { return _file; }
+
+        /** Call \a consume_r for each file in \a dir_r accepted by \a filter_r.
+         * \throws Exception If \a dir_r can not be read.
+         */
+        void readDir( const Pathname & dir_r, const ProcessDict & consume_r, const FileFilter & filter_r = FileFilter() );
+
+        /** Number of files \ref readDir had to parse. */
+        unsigned parsed() const
+        { return _parsed; }
+
+        /** Whether \ref save would write the file. */
+        bool dirty() const;
+
+        /** Write the directories and files visited by \ref readDir (atomically).
+         * \return Whether the file was written.
+         */
+        bool save();
+
+      public:
+        typedef std::map<std::string, IniDict::EntrySet> SectionMap;
+
+        /** A parsed file. */
+        struct FileData
+        {
+          FileData()
+          : mtime( 0 ), size( 0 ), ino( 0 )
+          {}
+          time_t     mtime;
+          off_t      size;
+          ino_t      ino;
+          SectionMap sections;
+        };
+
+        /** A directory listing. */
+        struct DirData
+        {
+          DirData()
+          : mtime( 0 )
+          {}
+          time_t                   mtime;
+          std::vector<std::string> entries;
+        };
+
+      private:
+        typedef std::map<Pathname, DirData>  DirMap;
+        typedef std::map<Pathname, FileData> FileMap;
+
+        /** Whether the cached \a mtime_r is still valid for \a pi_r. */
+        bool unchanged( const PathInfo & pi_r, time_t mtime_r ) const;
+
+        /** Parse \a file_r into \a dict_r (\c false if it can't be opened). */
+        static bool parse( const Pathname & file_r, IniDict & dict_r );
+
+        void load();
+
+        Pathname _file;
+        time_t   _stamp;	//!< when the loaded snapshot was taken
+        time_t   _now;	//!< when this snapshot is taken
+        DirMap   _olddirs;
+        FileMap  _oldfiles;
+        DirMap   _dirs;
+        FileMap  _files;
+        unsigned _parsed;
+        bool     _changed;
+    };
+    ///////////////////////////////////////////////////////////////////
+
+    /** \relates IniDictSnapshot Stream output */
+    std::ostream & operator<<( std::ostream & str, const IniDictSnapshot & obj );
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace parser
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_PARSER_INIDICTSNAPSHOT_H
@@ -30,14 +30,14 @@ namespace zypp
   { /////////////////////////////////////////////////////////////////
 
     /**
-   * \short List of RepoInfo's from a file.
-   * \param file pathname of the file to read.
-   */
-    static void repositories_in_stream( const InputStream &is,
-                                        const RepoFileReader::ProcessRepo &callback,
-                                        const ProgressData::ReceiverFnc &progress )
+     * \short List of RepoInfo's from a parsed file.
+     * \param dict the parsed file content.
+     * \param file pathname of the file (stored in the RepoInfo).
+     */
+    static void repositories_in_dict( const IniDict &dict,
+                                      const Pathname &file,
+                                      const RepoFileReader::ProcessRepo &callback )
     {
-      parser::IniDict dict(is);
       for ( parser::IniDict::section_const_iterator its = dict.sectionsBegin();
             its != dict.sectionsEnd();
             ++its )
@@ -96,7 +96,7 @@ namespace zypp
         }
         if (url.isValid())
             info.addBaseUrl(url);
-        info.setFilepath(is.path());
+        info.setFilepath(file);
         MIL << info << endl;
         // add it to the list.
         callback(info);
@@ -105,6 +105,18 @@ namespace zypp
       }
     }
 
+    /**
+   * \short List of RepoInfo's from a file.
+   * \param file pathname of the file to read.
+   */
+    static void repositories_in_stream( const InputStream &is,
+                                        const RepoFileReader::ProcessRepo &callback,
+                                        const ProgressData::ReceiverFnc &progress )
+    {
+      parser::IniDict dict(is);
+      repositories_in_dict(dict, is.path(), callback);
+    }
+
     ///////////////////////////////////////////////////////////////////
     //
     //	CLASS NAME : RepoFileReader
@@ -127,6 +139,14 @@ namespace zypp
       repositories_in_stream(is, _callback, progress);
     }
 
+    RepoFileReader::RepoFileReader( const IniDict &dict,
+                                    const Pathname & repo_file,
+                                    const ProcessRepo & callback )
+      : _callback(callback)
+    {
+      repositories_in_dict(dict, repo_file, _callback);
+    }
+
     RepoFileReader::~RepoFileReader()
     {}
 
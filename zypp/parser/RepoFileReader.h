@@ -26,6 +26,8 @@ namespace zypp
   namespace parser
   { /////////////////////////////////////////////////////////////////
 
+    class IniDict;
+
     /**
      * \short Read repository data from a .repo file
      *
@@ -87,6 +89,17 @@ namespace zypp
       RepoFileReader( const InputStream &is,
                       const ProcessRepo & callback,
                       const ProgressData::ReceiverFnc &progress = ProgressData::ReceiverFnc() );
+
+     /**
+      * \short Constructor. Creates the reader from an already parsed file.
+      *
+      * \param dict The content of \a repo_file (e.g. from an \ref IniDictSnapshot)
+      * \param repo_file The .repo file \a dict was read from
+      * \param callback Callback that will be called for each repository.
+      */
+      RepoFileReader( const IniDict &dict,
+                      const Pathname & repo_file,
+                      const ProcessRepo & callback );
      
       /**
        * Dtor
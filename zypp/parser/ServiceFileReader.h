@@ -27,6 +27,8 @@ namespace zypp
   namespace parser
   { /////////////////////////////////////////////////////////////////
 
+    class IniDict;
+
     /**
      * \short Read service data from a .service file
      *
@@ -70,6 +72,19 @@ namespace zypp
       */
       ServiceFileReader( const Pathname & serviceFile,
                       const ProcessService & callback);
+
+     /**
+      * \short Constructor. Creates the reader from an already parsed file.
+      *
+      * \param dict The content of \a serviceFile (e.g. from an \ref IniDictSnapshot)
+      * \param serviceFile The .service file \a dict was read from
+      * \param callback Callback that will be called for each service.
+      *
+      * \throws AbortRequestException If the callback returns false
+      */
+      ServiceFileReader( const IniDict & dict,
+                      const Pathname & serviceFile,
+                      const ProcessService & callback);
      
       /**
        * Dtor
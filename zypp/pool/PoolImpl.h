@@ -449,6 +449,13 @@ namespace zypp
 	  return _id2item;
 	}
 
+        /** Build the lazily computed \ref store and \ref id2item. */
+        void prepareForConcurrentReads() const
+        {
+          store();
+          id2item();
+        }
+
         ///////////////////////////////////////////////////////////////////
         //
         ///////////////////////////////////////////////////////////////////
@@ -19,6 +19,7 @@
 #include "zypp/repo/PackageProvider.h"
 #include "zypp/repo/Applydeltarpm.h"
 #include "zypp/repo/PackageDelta.h"
+#include "zypp/repo/SharedPackageCache.h"
 
 #include "zypp/TmpPath.h"
 #include "zypp/ZConfig.h"
@@ -293,6 +294,9 @@ namespace zypp
 
       ManagedFile tryDelta( const DeltaRpm & delta_r ) const;
 
+      /** Whether \a file_r exists and matches \a checksum_r. */
+      bool isCached( const Pathname & file_r, const CheckSum & checksum_r ) const;
+
       bool progressDeltaDownload( int value ) const
       { return report()->progressDeltaDownload( value ); }
 
@@ -308,22 +312,45 @@ namespace zypp
     {
       RepoInfo info = _package->repoInfo();
       OnMediaLocation loc( _package->location() );
-      PathInfo cachepath( info.packagesPath() / loc.filename() );
+      Pathname cachepath( info.packagesPath() / loc.filename() );
 
-      if ( cachepath.isFile() && ! loc.checksum().empty() ) // accept cache hit with matching checksum only!
-             // Tempting to do a quick check for matching .rpm-filesize before computing checksum,
-      // but real life shows that loc.downloadSize() and the .rpm-filesize frequently do not
-      // match, even if loc.checksum() and the .rpm-files checksum do. Blame the metadata generator(s).
+      if ( loc.checksum().empty() ) // accept cache hit with matching checksum only!
+	return ManagedFile();	// <-- cache miss
+
+      SharedPackageCache * shared( SharedPackageCache::systemCache() );
+      if ( isCached( cachepath, loc.checksum() ) )
       {
-	CheckSum cachechecksum( loc.checksum().type(), filesystem::checksum( cachepath.path(), loc.checksum().type() ) );
-	if ( cachechecksum == loc.checksum() )
+	if ( shared )
+	  shared->insert( loc.checksum(), cachepath );
+	return ManagedFile( cachepath );  // <-- cache hit
+      }
+      if ( shared && shared->provide( loc.checksum(), cachepath ) )
+      {
+	if ( isCached( cachepath, loc.checksum() ) )
 	{
-	  return ManagedFile( cachepath.path() );  // <-- cache hit
+	  // The link into packagesPath is ours, not the shared caches.
+	  ManagedFile ret( cachepath );
+	  if ( ! info.keepPackages() )
+	    ret.setDispose( filesystem::unlink );
+	  return ret;  // <-- shared cache hit
 	}
+	WAR << "Checksum mismatch in shared cache " << shared->entryPath( loc.checksum() ) << endl;
+	filesystem::unlink( cachepath );
       }
       return ManagedFile();	// <-- cache miss
     }
 
+    bool RpmPackageProvider::isCached( const Pathname & file_r, const CheckSum & checksum_r ) const
+    {
+      // Tempting to do a quick check for matching .rpm-filesize before computing checksum,
+      // but real life shows that loc.downloadSize() and the .rpm-filesize frequently do not
+      // match, even if loc.checksum() and the .rpm-files checksum do. Blame the metadata generator(s).
+      if ( ! PathInfo( file_r ).isFile() )
+	return false;
+      CheckSum cachechecksum( checksum_r.type(), filesystem::checksum( file_r, checksum_r.type() ) );
+      return( cachechecksum == checksum_r );
+    }
+
     ManagedFile RpmPackageProvider::doProvidePackage() const
     {
       Url url;
@@ -354,7 +381,21 @@ namespace zypp
       }
 
       // no patch/delta -> provide full package
-      return Base::doProvidePackage();
+      ManagedFile ret( Base::doProvidePackage() );
+      // Files outside packagesPath are not worth sharing.
+      // A checksum mismatch the user accepted (failOnChecksumError) must
+      // not get into the shared cache, so verify it again.
+      SharedPackageCache * shared( SharedPackageCache::systemCache() );
+      const CheckSum & checksum( _package->location().checksum() );
+      if ( shared && ! checksum.empty()
+           && ret.value() == info.packagesPath() / _package->location().filename() )
+      {
+	if ( isCached( ret.value(), checksum ) )
+	  shared->insert( checksum, ret.value() );
+	else
+	  WAR << "Checksum mismatch, not shared: " << ret.value() << endl;
+      }
+      return ret;
     }
 
     ManagedFile RpmPackageProvider::tryDelta( const DeltaRpm & delta_r ) const
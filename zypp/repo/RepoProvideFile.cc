@@ -105,6 +105,24 @@ namespace zypp
 	  RedirectType _redirect;
       };
 
+      /** Make sure \a file_r in packagesPath is an inode of its own.
+       * Fetcher hardlinks files from a local directory (\c dir:, \c file:),
+       * so the file verified and installed would be the one the directories
+       * owner can still change. A (reflinked) copy replaces such a link.
+       */
+      int unshareLocalFile( const Pathname & file_r )
+      {
+        if ( PathInfo( file_r ).nlink() <= 1 )
+          return 0;
+        Pathname tmp( file_r.extend( ".unshare" ) );
+        int res = filesystem::copy( file_r, tmp );
+        if ( res == 0 )
+          res = filesystem::rename( tmp, file_r );
+        if ( res != 0 )
+          filesystem::unlink( tmp );
+        return res;
+      }
+
       /////////////////////////////////////////////////////////////////
     } // namespace
     ///////////////////////////////////////////////////////////////////
@@ -303,20 +321,25 @@ namespace zypp
               << "' from " << url << endl;
           shared_ptr<MediaSetAccess> access = _impl->mediaAccessForUrl( url, repo_r );
 
-	  fetcher.enqueue( loc_r );
+          fetcher.enqueue( loc_r );
 
-	  // FIXME: works for packages only
-	  fetcher.start( destinationDir, *access );
+          // FIXME: works for packages only
+          fetcher.start( destinationDir, *access );
 
-	  // reached if no exception has been thrown, so this is the correct file
+          // reached if no exception has been thrown, so this is the correct file
           ManagedFile ret( destinationDir + loc_r.filename() );
 
-          std::string scheme( url.getScheme() );
           if ( !repo_r.keepPackages() )
           {
             ret.setDispose( filesystem::unlink );
           }
 
+          std::string scheme( url.getScheme() );
+          if ( ( scheme == "dir" || scheme == "file" ) && unshareLocalFile( ret ) != 0 )
+          {
+            ZYPP_THROW( Exception( "Can't copy " + ret->asString() + " out of " + url.asString() ) );
+          }
+
           if ( loc_r.checksum().empty() )
           {
             // no checksum in metadata
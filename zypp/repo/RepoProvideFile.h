@@ -70,6 +70,12 @@ namespace zypp
       * provides callback hooks for download progress reporting and behaviour
       * on failed checksum verification.
       *
+      * The file is hardlinked or copied into the repos \ref RepoInfo::packagesPath
+      * and unlinked when the returned \ref ManagedFile is disposed (unless
+      * the repo keeps its packages). Files from a local directory (\c dir:,
+      * \c file:) are always copied (reflinked where supported), so the file
+      * verified is not shared with the directories owner.
+      *
       * \throws Exception
       * \todo Investigate why this needs a non-const Repository as arg.
       */
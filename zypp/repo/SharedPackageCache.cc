@@ -0,0 +1,262 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/repo/SharedPackageCache.cc
+ *
+*/
+#include <iostream>
+#include <fstream>
+#include <list>
+#include <vector>
+#include <algorithm>
+#include <boost/interprocess/sync/file_lock.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+
+#include "zypp/base/Logger.h"
+#include "zypp/base/Easy.h"
+#include "zypp/base/String.h"
+
+#include "zypp/PathInfo.h"
+#include "zypp/TmpPath.h"
+#include "zypp/ZConfig.h"
+
+#include "zypp/repo/SharedPackageCache.h"
+
+using std::endl;
+using boost::interprocess::file_lock;
+using boost::interprocess::scoped_lock;
+using boost::interprocess::try_to_lock;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace repo
+  { /////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    namespace
+    { /////////////////////////////////////////////////////////////////
+
+      /** Checksums come from repo metadata: accept plain [0-9a-z] only. */
+      bool saneName( const std::string & name_r )
+      {
+        if ( name_r.empty() )
+          return false;
+        for_( it, name_r.begin(), name_r.end() )
+        {
+          if ( ! ( ( '0' <= *it && *it <= '9' ) || ( 'a' <= *it && *it <= 'z' ) ) )
+            return false;
+        }
+        return true;
+      }
+
+      /** A file in the store. */
+      struct Entry
+      {
+        Entry( const Pathname & path_r, const PathInfo & pi_r )
+        : path( path_r ), mtime( pi_r.mtime() ), size( pi_r.size() )
+        {}
+
+        bool operator<( const Entry & rhs ) const
+        { return mtime < rhs.mtime; }
+
+        Pathname path;
+        time_t   mtime;
+        off_t    size;
+      };
+
+      /** All files in \c root_r/<type>/<xx>/. */
+      void collectEntries( const Pathname & root_r, std::vector<Entry> & entries_r )
+      {
+        std::list<std::string> types;
+        filesystem::readdir( types, root_r, false );
+        for_( tit, types.begin(), types.end() )
+        {
+          std::list<std::string> subdirs;
+          filesystem::readdir( subdirs, root_r / *tit, false );
+          for_( sit, subdirs.begin(), subdirs.end() )
+          {
+            Pathname subdir( root_r / *tit / *sit );
+            std::list<std::string> files;
+            filesystem::readdir( files, subdir, false );
+            for_( fit, files.begin(), files.end() )
+            {
+              PathInfo pi( subdir / *fit );
+              if ( pi.isFile() )
+                entries_r.push_back( Entry( pi.path(), pi ) );
+            }
+          }
+        }
+      }
+
+      /////////////////////////////////////////////////////////////////
+    } // namespace
+    ///////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : SharedPackageCache
+    //
+    ///////////////////////////////////////////////////////////////////
+
+    SharedPackageCache::SharedPackageCache( const Pathname & root_r, const ByteCount & budget_r )
+    : _root( root_r )
+    , _budget( budget_r )
+    {
+      scan();
+      if ( _budget && _size > _budget )
+        evict();
+      MIL << *this << endl;
+    }
+
+    SharedPackageCache * SharedPackageCache::systemCache()
+    {
+      static SharedPackageCache * _cache = 0;
+      static bool _init = false;
+      if ( ! _init )
+      {
+        _init = true;
+        const ZConfig & zconfig( ZConfig::instance() );
+        if ( ! zconfig.download_sharedPackageCachePath().empty() )
+          _cache = new SharedPackageCache( zconfig.download_sharedPackageCachePath(),
+                                           zconfig.download_sharedPackageCacheSize() );
+      }
+      return _cache;
+    }
+
+    Pathname SharedPackageCache::entryPath( const CheckSum & checksum_r ) const
+    {
+      std::string type( str::toLower( checksum_r.type() ) );
+      std::string sum( str::toLower( checksum_r.checksum() ) );
+      if ( ! saneName( type ) || sum.size() < 3 || ! saneName( sum ) )
+        return Pathname();
+      return _root / type / sum.substr( 0, 2 ) / sum;
+    }
+
+    bool SharedPackageCache::provide( const CheckSum & checksum_r, const Pathname & dest_r )
+    {
+      Pathname entry( entryPath( checksum_r ) );
+      if ( entry.empty() || ! PathInfo( entry ).isFile() )
+        return false;
+
+      filesystem::assert_dir( dest_r.dirname() );
+      filesystem::TmpFile tmp( filesystem::TmpFile::makeSibling( dest_r ) );
+      // fails if the entry was evicted meanwhile
+      if ( ! tmp
+           || filesystem::hardlinkCopy( entry, tmp.path() ) != 0
+           || filesystem::rename( tmp.path(), dest_r ) != 0 )
+        return false;
+
+      filesystem::touch( entry );	// LRU
+      MIL << "Shared cache hit " << checksum_r << " -> " << dest_r << endl;
+      return true;
+    }
+
+    bool SharedPackageCache::insert( const CheckSum & checksum_r, const Pathname & file_r )
+    {
+      Pathname entry( entryPath( checksum_r ) );
+      if ( entry.empty() )
+        return false;
+      if ( PathInfo( entry ).isFile() )
+      {
+        filesystem::touch( entry );	// LRU: already there, but used again
+        return true;
+      }
+
+      if ( filesystem::assert_dir( entry.dirname() ) != 0 )
+        return false;
+      filesystem::TmpFile tmp( filesystem::TmpFile::makeSibling( entry ) );
+      if ( ! tmp
+           || filesystem::hardlinkCopy( file_r, tmp.path() ) != 0 )
+        return false;
+      // shared by all users and roots
+      filesystem::chmod( tmp.path(), 0644 );
+      filesystem::touch( tmp.path() );
+      if ( filesystem::rename( tmp.path(), entry ) != 0 )
+        return false;
+
+      _size += PathInfo( entry ).size();
+      if ( _budget && _size > _budget )
+        evict();
+      return true;
+    }
+
+    unsigned SharedPackageCache::evict()
+    {
+      Pathname lockfile( _root / ".lock" );
+      filesystem::assert_dir( _root );
+      std::ofstream( lockfile.c_str(), std::ios::app );	// file_lock needs an existing file
+
+      unsigned removed = 0;
+      try
+      {
+        file_lock lock( lockfile.c_str() );
+        scoped_lock<file_lock> guard( lock, try_to_lock );
+        if ( ! guard.owns() )
+        {
+          MIL << "Shared cache " << _root << " is evicted by an other process" << endl;
+          return 0;
+        }
+
+        std::vector<Entry> entries;
+        collectEntries( _root, entries );
+        std::sort( entries.begin(), entries.end() );
+
+        ByteCount::SizeType size = 0;
+        for_( it, entries.begin(), entries.end() )
+          size += it->size;
+
+        for_( it, entries.begin(), entries.end() )
+        {
+          if ( ! _budget || size <= _budget )
+            break;
+          // a process still using the entry keeps its own hardlink
+          if ( filesystem::unlink( it->path ) == 0 )
+          {
+            size -= it->size;
+            ++removed;
+          }
+        }
+        _size = size;
+      }
+      catch ( const boost::interprocess::interprocess_exception & excpt )
+      {
+        WAR << "Can't lock " << lockfile << ": " << excpt.what() << endl;
+        return 0;
+      }
+      MIL << "Evicted " << removed << " entries from " << *this << endl;
+      return removed;
+    }
+
+    void SharedPackageCache::scan()
+    {
+      std::vector<Entry> entries;
+      collectEntries( _root, entries );
+      ByteCount::SizeType size = 0;
+      for_( it, entries.begin(), entries.end() )
+        size += it->size;
+      _size = size;
+    }
+
+    /******************************************************************
+    **
+    **	FUNCTION NAME : operator<<
+    **	FUNCTION TYPE : std::ostream &
+    */
+    std::ostream & operator<<( std::ostream & str, const SharedPackageCache & obj )
+    {
+      return str << "SharedPackageCache(" << obj._root << "){" << obj._size << " of " << obj._budget << "}";
+    }
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace repo
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
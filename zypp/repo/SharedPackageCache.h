@@ -0,0 +1,117 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/repo/SharedPackageCache.h
+ *
+*/
+#ifndef ZYPP_REPO_SHAREDPACKAGECACHE_H
+#define ZYPP_REPO_SHAREDPACKAGECACHE_H
+
+#include <iosfwd>
+
+#include "zypp/base/NonCopyable.h"
+#include "zypp/Pathname.h"
+#include "zypp/ByteCount.h"
+#include "zypp/CheckSum.h"
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace repo
+  { /////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : SharedPackageCache
+    //
+    /** Content addressed package store shared by all repos and roots on a host.
+     *
+     * Files are stored as <tt>root/<type>/<2 digits>/<checksum></tt> and are
+     * hardlinked (copied if on a different filesystem) into the per repo
+     * \ref RepoInfo::packagesPath. So the same package reached through
+     * different repos or chroots is downloaded and stored once.
+     *
+     * Each hit updates the entries mtime. If the stores size exceeds the
+     * budget, the least recently used entries are removed.
+     *
+     * Several processes may use the store at the same time: Entries are
+     * created by atomically renaming a complete file into place, a lookup
+     * racing with an eviction is just a cache miss, and only one process
+     * at a time evicts (guarded by <tt>root/.lock</tt>).
+     *
+     * \see \ref ZConfig::download_sharedPackageCachePath
+     */
+    class SharedPackageCache : private base::NonCopyable
+    {
+      friend std::ostream & operator<<( std::ostream & str, const SharedPackageCache & obj );
+
+      public:
+        /** Ctor taking the stores root directory and its size budget. */
+        SharedPackageCache( const Pathname & root_r, const ByteCount & budget_r );
+
+        /** The cache configured in \ref ZConfig or \c 0 if disabled. */
+        static SharedPackageCache * systemCache();
+
+      public:
+        /** The stores root directory. */
+        const Pathname & root() const
+        { return _root; }
+
+        /** Size the store is evicted down to (\c 0: no limit). */
+        const ByteCount & budget() const
+        { return _budget; }
+
+        /** Current size of the store (as far as this process knows). */
+        const ByteCount & size() const
+        { return _size; }
+
+        /** Path of the entry for \a checksum_r (whether it exists or not). */
+        Pathname entryPath( const CheckSum & checksum_r ) const;
+
+      public:
+        /** Link the entry for \a checksum_r to \a dest_r.
+         * An existing \a dest_r is atomically replaced.
+         * \return \c false on cache miss or if \a dest_r can't be written.
+         */
+        bool provide( const CheckSum & checksum_r, const Pathname & dest_r );
+
+        /** Remember \a file_r, whose checksum must be \a checksum_r.
+         * An existing entry is just marked as used. Evicts old
+         * entries if the budget is exceeded.
+         * \return \c false if the file could not be stored.
+         */
+        bool insert( const CheckSum & checksum_r, const Pathname & file_r );
+
+        /** Remove least recently used entries until the store fits into the budget.
+         * Does nothing if an other process is currently evicting.
+         * \return The number of removed entries.
+         */
+        unsigned evict();
+
+      private:
+        /** Sum up the size of all entries. */
+        void scan();
+
+      private:
+        Pathname  _root;
+        ByteCount _budget;
+        ByteCount _size;
+    };
+    ///////////////////////////////////////////////////////////////////
+
+    /** \relates SharedPackageCache Stream output */
+    std::ostream & operator<<( std::ostream & str, const SharedPackageCache & obj );
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace repo
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_REPO_SHAREDPACKAGECACHE_H
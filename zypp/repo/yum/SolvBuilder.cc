@@ -0,0 +1,299 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/repo/yum/SolvBuilder.cc
+ *
+*/
+extern "C"
+{
+#include <solv/pool.h>
+#include <solv/repo.h>
+#include <solv/repo_solv.h>
+#include <solv/repo_write.h>
+#include <solv/repo_rpmmd.h>
+#include <solv/repo_repomdxml.h>
+#include <solv/repo_updateinfoxml.h>
+#include <solv/repo_deltainfoxml.h>
+#include <solv/solv_xfopen.h>
+}
+#include <cstring>
+#include <iostream>
+#include <list>
+#include <thread>
+#include <system_error>
+
+#include "zypp/base/Logger.h"
+#include "zypp/base/Easy.h"
+#include "zypp/base/String.h"
+#include "zypp/base/Gettext.h"
+#include "zypp/AutoDispose.h"
+#include "zypp/PathInfo.h"
+#include "zypp/TmpPath.h"
+#include "zypp/repo/RepoException.h"
+
+#include "zypp/repo/yum/SolvBuilder.h"
+
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace repo
+  { /////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////
+    namespace yum
+    { /////////////////////////////////////////////////////////////////
+
+      ///////////////////////////////////////////////////////////////////
+      namespace
+      { /////////////////////////////////////////////////////////////////
+
+        /** Strip the compression suffix and a checksum prefix:
+         * <tt>"0123abcd-primary.xml.gz"</tt> is a \c "primary.xml".
+         */
+        std::string metadataName( const std::string & file_r )
+        {
+          std::string name( file_r );
+          static const char * suffixes[] = { ".gz", ".bz2", ".xz", ".lzma" };
+          for ( unsigned i = 0; i < sizeof(suffixes)/sizeof(suffixes[0]); ++i )
+          {
+            if ( str::hasSuffix( name, suffixes[i] ) )
+            {
+              name.erase( name.size() - ::strlen( suffixes[i] ) );
+              break;
+            }
+          }
+          std::string::size_type dash = name.find( '-' );
+          if ( dash != std::string::npos && dash != 0 && name.find_first_not_of( "0123456789abcdef" ) == dash )
+            name.erase( 0, dash+1 );
+          return name;
+        }
+
+        /** Write \a repo_r to \a file_r; \c false on error. */
+        bool writeRepo( ::Repo * repo_r, const Pathname & file_r )
+        {
+          FILE * fp = ::fopen( file_r.c_str(), "we" );
+          if ( ! fp )
+            return false;
+          bool ok = ( ::repo_write( repo_r, fp ) == 0 );
+          return( ::fclose( fp ) == 0 && ok );
+        }
+
+        /////////////////////////////////////////////////////////////////
+      } // namespace
+      ///////////////////////////////////////////////////////////////////
+
+      ///////////////////////////////////////////////////////////////////
+      //
+      //	CLASS NAME : SolvBuilder
+      //
+      ///////////////////////////////////////////////////////////////////
+
+      SolvBuilder::SolvBuilder( const Pathname & repodir_r )
+      : _repodir( repodir_r )
+      , _supported( true )
+      {
+        std::list<std::string> files;
+        if ( filesystem::readdir( files, _repodir / "repodata", false ) != 0 )
+        {
+          _supported = false;
+          return;
+        }
+        files.sort();
+
+        std::vector<Part> parts;
+        for ( unsigned kind = REPOMD; kind <= DELTAINFO; ++kind )
+          parts.push_back( Part( Kind(kind) ) );
+        std::vector<Pathname> susedata;
+
+        for_( it, files.begin(), files.end() )
+        {
+          Pathname path( _repodir / "repodata" / *it );
+          std::string name( metadataName( *it ) );
+          if ( name == "repomd.xml" )
+            parts[REPOMD].files.push_back( path );
+          else if ( name == "suseinfo.xml" )
+            parts[SUSEINFO].files.push_back( path );
+          else if ( name == "primary.xml" )
+            parts[PRIMARY].files.push_back( path );
+          else if ( name == "susedata.xml" )
+            susedata.push_back( path );
+          else if ( name == "patterns.xml" )
+            parts[PATTERNS].files.push_back( path );
+          else if ( name == "updateinfo.xml" )
+            parts[UPDATEINFO].files.push_back( path );
+          else if ( name == "deltainfo.xml" || name == "prestodelta.xml" )
+            parts[DELTAINFO].files.push_back( path );
+          else if ( name == "filelists.xml" || name == "other.xml"
+                    || str::hasSuffix( name, ".asc" ) || str::hasSuffix( name, ".key" ) )
+            continue;	// not used
+          else
+          {
+            MIL << "Unsupported metadata file " << path << endl;
+            _supported = false;
+          }
+        }
+
+        if ( parts[PRIMARY].files.size() > 1 )
+        {
+          MIL << "Multiple primary files in " << _repodir << endl;
+          _supported = false;
+        }
+        else if ( parts[PRIMARY].files.size() == 1 )
+        {
+          // susedata extends the primary solvables
+          parts[PRIMARY].files.insert( parts[PRIMARY].files.end(), susedata.begin(), susedata.end() );
+        }
+
+        for_( it, parts.begin(), parts.end() )
+        {
+          if ( ! it->files.empty() )
+            _parts.push_back( *it );
+        }
+        MIL << *this << endl;
+      }
+
+      std::string SolvBuilder::convert( const Part & part_r, const Pathname & file_r )
+      {
+        // Called on a worker thread: a private pool and no logging.
+        ::Pool * pool = ::pool_create();
+        AutoDispose< ::Pool *> guard( pool, ::pool_free );
+        ::Repo * repo = ::repo_create( pool, "" );
+
+        for_( it, part_r.files.begin(), part_r.files.end() )
+        {
+          // streams through the decompressor, nothing is unpacked to disk
+          FILE * fp = ::solv_xfopen( it->c_str(), "r" );
+          if ( ! fp )
+            return str::form( "Can't open %s", it->c_str() );
+
+          int ret = 0;
+          switch ( part_r.kind )
+          {
+            case REPOMD:
+            case SUSEINFO:
+              ret = ::repo_add_repomdxml( repo, fp, 0 );
+              break;
+            case PRIMARY:
+              ret = ::repo_add_rpmmd( repo, fp, 0, ( it == part_r.files.begin() ? 0 : REPO_EXTEND_SOLVABLES ) );
+              break;
+            case PATTERNS:
+              ret = ::repo_add_rpmmd( repo, fp, 0, 0 );
+              break;
+            case UPDATEINFO:
+              ret = ::repo_add_updateinfoxml( repo, fp, 0 );
+              break;
+            case DELTAINFO:
+              ret = ::repo_add_deltainfoxml( repo, fp, 0 );
+              break;
+          }
+          ::fclose( fp );
+          if ( ret != 0 )
+            return str::form( "%s: %s", it->c_str(), ::pool_errstr( pool ) );
+        }
+
+        if ( ! writeRepo( repo, file_r ) )
+          return str::form( "Can't write %s", file_r.c_str() );
+        return std::string();
+      }
+
+      void SolvBuilder::build( const Pathname & solvfile_r ) const
+      {
+        filesystem::TmpDir tmpdir( filesystem::TmpDir::makeSibling( solvfile_r ) );
+        if ( tmpdir.path().empty() )
+          ZYPP_THROW( RepoException( str::form( _("Can't create %s"), solvfile_r.dirname().c_str() ) ) );
+
+        std::vector<Pathname> partfiles;
+        for ( unsigned i = 0; i < _parts.size(); ++i )
+          partfiles.push_back( tmpdir.path() / str::numstring( i ) );
+
+        // Convert the parts concurrently; the first one on this thread.
+        std::vector<std::string> errors( _parts.size() );
+        std::vector<std::thread> threads;
+        for ( unsigned i = 1; i < _parts.size(); ++i )
+        {
+          try
+          {
+            threads.push_back( std::thread( [this,i,&partfiles,&errors]() {
+              try
+              {
+                errors[i] = convert( _parts[i], partfiles[i] );
+              }
+              catch ( const std::exception & excpt )
+              {
+                errors[i] = excpt.what();
+              }
+            } ) );
+          }
+          catch ( const std::system_error & excpt )
+          {
+            WAR << "Can't start converter thread: " << excpt.what() << endl;
+            errors[i] = convert( _parts[i], partfiles[i] );
+          }
+        }
+        if ( ! _parts.empty() )
+          errors[0] = convert( _parts[0], partfiles[0] );
+        for_( it, threads.begin(), threads.end() )
+          it->join();
+
+        for_( it, errors.begin(), errors.end() )
+        {
+          if ( ! it->empty() )
+          {
+            ERR << *it << endl;
+            RepoException ex( str::form( _("Failed to cache repo (%s)."), _repodir.c_str() ) );
+            ex.remember( *it );
+            ZYPP_THROW( ex );
+          }
+        }
+
+        // Merge the parts (like mergesolv).
+        ::Pool * pool = ::pool_create();
+        AutoDispose< ::Pool *> guard( pool, ::pool_free );
+        ::Repo * repo = ::repo_create( pool, "" );
+        for_( it, partfiles.begin(), partfiles.end() )
+        {
+          FILE * fp = ::fopen( it->c_str(), "re" );
+          int ret = ( fp ? ::repo_add_solv( repo, fp, 0 ) : -1 );
+          if ( fp )
+            ::fclose( fp );
+          if ( ret != 0 )
+            ZYPP_THROW( RepoException( str::form( _("Failed to cache repo (%s)."), it->c_str() ) ) );
+        }
+        ::repo_internalize( repo );
+
+        filesystem::TmpFile tmp( filesystem::TmpFile::makeSibling( solvfile_r ) );
+        if ( ! tmp || ! writeRepo( repo, tmp.path() ) || filesystem::rename( tmp.path(), solvfile_r ) != 0 )
+          ZYPP_THROW( RepoException( str::form( _("Can't create %s"), solvfile_r.c_str() ) ) );
+        filesystem::chmod( solvfile_r, 0644 );
+        MIL << "Built " << solvfile_r << " from " << _parts.size() << " parts" << endl;
+      }
+
+      /******************************************************************
+      **
+      **	FUNCTION NAME : operator<<
+      **	FUNCTION TYPE : std::ostream &
+      */
+      std::ostream & operator<<( std::ostream & str, const SolvBuilder & obj )
+      {
+        str << "SolvBuilder(" << obj._repodir << "){";
+        for_( it, obj._parts.begin(), obj._parts.end() )
+          str << ( it == obj._parts.begin() ? "" : "," ) << it->kind << ":" << it->files.size();
+        return str << "}" << ( obj._supported ? "" : "[unsupported]" );
+      }
+
+      /////////////////////////////////////////////////////////////////
+    } // namespace yum
+    ///////////////////////////////////////////////////////////////////
+    /////////////////////////////////////////////////////////////////
+  } // namespace repo
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,121 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/repo/yum/SolvBuilder.h
+ *
+*/
+#ifndef ZYPP_REPO_YUM_SOLVBUILDER_H
+#define ZYPP_REPO_YUM_SOLVBUILDER_H
+
+#include <iosfwd>
+#include <vector>
+
+#include "zypp/base/NonCopyable.h"
+#include "zypp/Pathname.h"
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace repo
+  { /////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////
+    namespace yum
+    { /////////////////////////////////////////////////////////////////
+
+      ///////////////////////////////////////////////////////////////////
+      //
+      //	CLASS NAME : SolvBuilder
+      //
+      /** Build the solv file of a downloaded rpm-md repo in process.
+       *
+       * Does what <tt>repo2solv.sh</tt> does, but without running a
+       * pipeline of external tools per metadata file. Independent metadata
+       * files (\c primary.xml and \c susedata.xml, \c patterns.xml,
+       * \c updateinfo.xml, ...) are converted on separate threads, each
+       * streaming the compressed file through the libsolv parser. The
+       * results are merged into the solv file.
+       *
+       * \code
+       *   SolvBuilder builder( rawcache );
+       *   if ( builder.supported() )
+       *     builder.build( solvfile );
+       *   else
+       *     ... run repo2solv.sh
+       * \endcode
+       *
+       * \see \ref ZConfig::repo_parallelCacheBuild
+       */
+      class SolvBuilder : private base::NonCopyable
+      {
+        friend std::ostream & operator<<( std::ostream & str, const SolvBuilder & obj );
+
+        public:
+          /** Ctor taking the directory containing \c repodata/. */
+          SolvBuilder( const Pathname & repodir_r );
+
+        public:
+          /** Whether all metadata files are understood.
+           * If not, the solv file should be built by <tt>repo2solv.sh</tt>.
+           */
+          bool supported() const
+          { return _supported; }
+
+          /** Convert the metadata and atomically write \a solvfile_r.
+           * \throws RepoException if a metadata file is broken.
+           */
+          void build( const Pathname & solvfile_r ) const;
+
+        public:
+          /** The metadata parsers, in the order their results are merged. */
+          enum Kind
+          {
+            REPOMD,
+            SUSEINFO,
+            PRIMARY,	//!< plus susedata extending the primary solvables
+            PATTERNS,
+            UPDATEINFO,
+            DELTAINFO
+          };
+
+        private:
+          /** Metadata files converted together by one thread. */
+          struct Part
+          {
+            Part( Kind kind_r )
+            : kind( kind_r )
+            {}
+            Kind                  kind;
+            std::vector<Pathname> files;
+          };
+
+          /** Convert \a part_r and write it to \a file_r.
+           * \return An error message or an empty string on success.
+           */
+          static std::string convert( const Part & part_r, const Pathname & file_r );
+
+        private:
+          Pathname          _repodir;
+          std::vector<Part> _parts;
+          bool              _supported;
+      };
+      ///////////////////////////////////////////////////////////////////
+
+      /** \relates SolvBuilder Stream output */
+      std::ostream & operator<<( std::ostream & str, const SolvBuilder & obj );
+
+      /////////////////////////////////////////////////////////////////
+    } // namespace yum
+    ///////////////////////////////////////////////////////////////////
+    /////////////////////////////////////////////////////////////////
+  } // namespace repo
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_REPO_YUM_SOLVBUILDER_H
@@ -34,6 +34,25 @@ namespace zypp
 
     using detail::noSolvableId;
 
+    namespace
+    {
+      /** Stringifying, matching and globalizing local ids create ids and use libsolvs tmp space
+       * (\see \ref detail::PoolImpl::lazyLock).
+       */
+      inline thread::MutexLock lazyLock()
+      { return detail::PoolMember::myPool().lazyLock(); }
+
+      /** Plain iteration just pages in attribute data, which a prepared pool keeps in memory
+       * (\see \ref detail::PoolImpl::lookupLock).
+       */
+      inline thread::MutexLock lookupLock()
+      { return detail::PoolMember::myPool().lookupLock(); }
+
+      /** Whether \a dip_r must globalize its local ids (creating them on demand). */
+      inline bool hasLocalIds( const ::_Dataiterator * dip_r )
+      { return dip_r->data && dip_r->data->localpool; }
+    }
+
     ///////////////////////////////////////////////////////////////////
     //
     //	CLASS NAME : LookupAttr::Impl
@@ -300,6 +319,7 @@ namespace zypp
       : _dip( new ::Dataiterator )
       , _mstring( mstring_r )
       {
+        thread::MutexLock guard( lookupLock() );
         ::dataiterator_init( _dip, sat::Pool::instance().get(), repoId_r, solvId_r, attrId_r,
                              _mstring.empty() ? 0 : _mstring.c_str(), flags_r );
       }
@@ -309,6 +329,7 @@ namespace zypp
       : _dip( new ::Dataiterator )
       , _mstring( mstring_r ? mstring_r : "" )
       {
+        thread::MutexLock guard( lazyLock() );
         ::dataiterator_init( _dip, sat::Pool::instance().get(), repoId_r, solvId_r, attrId_r,
                              _mstring.empty() ? 0 : _mstring.c_str(), flags_r );
       }
@@ -320,6 +341,7 @@ namespace zypp
         if ( rhs._dip )
         {
           _dip = new ::Dataiterator;
+          thread::MutexLock guard( lookupLock() );
           ::dataiterator_init_clone( _dip, rhs._dip );
 	  ::dataiterator_strdup( _dip );
         }
@@ -358,13 +380,13 @@ namespace zypp
     { return _dip ? SolvAttr( _dip->key->name ) : SolvAttr::noAttr; }
 
     void LookupAttr::iterator::nextSkipSolvAttr()
-    { if ( _dip ) ::dataiterator_skip_attribute( _dip.get() ); }
+    { if ( _dip ) { thread::MutexLock guard( lookupLock() ); ::dataiterator_skip_attribute( _dip.get() ); } }
 
     void LookupAttr::iterator::nextSkipSolvable()
-    { if ( _dip ) ::dataiterator_skip_solvable( _dip.get() ); }
+    { if ( _dip ) { thread::MutexLock guard( lookupLock() ); ::dataiterator_skip_solvable( _dip.get() ); } }
 
     void LookupAttr::iterator::nextSkipRepo()
-    { if ( _dip ) ::dataiterator_skip_repo( _dip.get() ); }
+    { if ( _dip ) { thread::MutexLock guard( lookupLock() ); ::dataiterator_skip_repo( _dip.get() ); } }
 
     void LookupAttr::iterator::stayInThisSolvable()
     { if ( _dip ) { _dip.get()->repoid = -1; _dip.get()->flags |= SEARCH_THISSOLVID; } }
@@ -475,6 +497,7 @@ namespace zypp
         return subEnd();
       // setup the new sub iterator with the remembered position
       detail::DIWrap dip( 0, 0, 0 );
+      thread::MutexLock guard( lookupLock() );
       ::dataiterator_clonepos( dip.get(), _dip.get() );
       switch ( subtype )
       {
@@ -600,10 +623,13 @@ namespace zypp
             break;
 
           case REPOKEY_TYPE_DIRSTRARRAY:
-	    // may or may not be stringified depending on SEARCH_FILES flag
-            return( _dip->flags & SEARCH_FILES
-		    ? _dip->kv.str
-		    : ::repodata_dir2str( _dip->data, _dip->kv.id, _dip->kv.str ) );
+            {
+	      // may or may not be stringified depending on SEARCH_FILES flag
+	      thread::MutexLock guard( lazyLock() );
+	      return( _dip->flags & SEARCH_FILES
+		      ? _dip->kv.str
+		      : ::repodata_dir2str( _dip->data, _dip->kv.id, _dip->kv.str ) );
+            }
             break;
         }
       }
@@ -620,6 +646,7 @@ namespace zypp
           case REPOKEY_TYPE_IDARRAY:
           case REPOKEY_TYPE_CONSTANTID:
             {
+              thread::MutexLock guard( lazyLock() );
               detail::IdType id = ::repodata_globalize_id( _dip->data, _dip->kv.id, 1 );
               return ISRELDEP(id) ? Capability( id ).asString()
                                   : IdString( id ).asString();
@@ -629,6 +656,7 @@ namespace zypp
           case REPOKEY_TYPE_STR:
           case REPOKEY_TYPE_DIRSTRARRAY:
             {
+              thread::MutexLock guard( lazyLock() ); // copy before tmp space is reused
               const char * ret( c_str() );
               return ret ? ret : "";
             }
@@ -674,7 +702,12 @@ namespace zypp
           case REPOKEY_TYPE_ID:
           case REPOKEY_TYPE_IDARRAY:
           case REPOKEY_TYPE_CONSTANTID:
-            return IdString( ::repodata_globalize_id( _dip->data, _dip->kv.id, 1 ) );
+            {
+              if ( ! hasLocalIds( _dip.get() ) )
+                return IdString( _dip->kv.id );
+              thread::MutexLock guard( lazyLock() );
+              return IdString( ::repodata_globalize_id( _dip->data, _dip->kv.id, 1 ) );
+            }
             break;
         }
       }
@@ -685,6 +718,7 @@ namespace zypp
     {
       if ( _dip )
       {
+        thread::MutexLock guard( lazyLock() ); // chk2str uses tmp space
         switch ( solvAttrType() )
         {
           case REPOKEY_TYPE_MD5:
@@ -750,14 +784,20 @@ namespace zypp
 
     detail::IdType LookupAttr::iterator::dereference() const
     {
-      return _dip ? ::repodata_globalize_id( _dip->data, _dip->kv.id, 1 )
-                  : detail::noId;
+      if ( ! _dip )
+        return detail::noId;
+      if ( ! hasLocalIds( _dip.get() ) )
+        return _dip->kv.id;
+      thread::MutexLock guard( lazyLock() );
+      return ::repodata_globalize_id( _dip->data, _dip->kv.id, 1 );
     }
 
     void LookupAttr::iterator::increment()
     {
       if ( _dip )
       {
+	// matching and file searches stringify the values
+	thread::MutexLock guard( ( _dip->flags & SEARCH_FILES ) || _dip->matcher.match ? lazyLock() : lookupLock() );
 	if ( ! ::dataiterator_step( _dip.get() ) )
 	{
 	  _dip.reset();
@@ -765,8 +805,6 @@ namespace zypp
 	}
 	else
 	{
-	  INT << _dip->kv.str << endl;
-	  INT << "  " << *this << endl;
 	  ::dataiterator_strdup( _dip.get() );
 	}
       }
@@ -14,15 +14,21 @@
 
 #include "zypp/base/Easy.h"
 #include "zypp/base/Logger.h"
+#include "zypp/base/String.h"
 #include "zypp/base/Gettext.h"
 #include "zypp/base/Exception.h"
 
 #include "zypp/AutoDispose.h"
+#include "zypp/PathInfo.h"
+#include "zypp/TmpPath.h"
+#include "zypp/Edition.h"
 
 #include "zypp/sat/detail/PoolImpl.h"
 #include "zypp/sat/Pool.h"
 #include "zypp/sat/LookupAttr.h"
 
+using std::endl;
+
 ///////////////////////////////////////////////////////////////////
 namespace zypp
 { /////////////////////////////////////////////////////////////////
@@ -48,6 +54,26 @@ namespace zypp
     void Pool::prepareForSolving() const
     { return myPool().prepareForSolving(); }
 
+    bool Pool::concurrentReads() const
+    { return myPool().concurrentReads(); }
+
+    void Pool::setConcurrentReads( bool yesno_r )
+    { myPool().setConcurrentReads( yesno_r ); }
+
+    void Pool::prepareForConcurrentReads() const
+    { myPool().prepareForConcurrentReads(); }
+
+    int Pool::compareEdition( const Edition & lhs, const Edition & rhs ) const
+    {
+      if ( lhs.id() == rhs.id() )
+        return 0;
+      unsigned lrank = myPool().evrRank( lhs.id() );
+      unsigned rrank = lrank ? myPool().evrRank( rhs.id() ) : 0;
+      if ( lrank && rrank )
+        return( lrank == rrank ? 0 : ( lrank < rrank ? -1 : 1 ) );
+      return lhs.compare( rhs );
+    }
+
     bool Pool::reposEmpty() const
     { return ! myPool()->urepos; }
 
@@ -166,6 +192,38 @@ namespace zypp
 
     /////////////////////////////////////////////////////////////////
 
+    bool Pool::repoSolvCacheOutdated( const Repository & repo_r ) const
+    { return repo_r && myPool().solvCacheOutdated( repo_r.get() ); }
+
+    void Pool::saveRepoSolv( const Repository & repo_r, const Pathname & file_r )
+    {
+      filesystem::TmpFile tmp( filesystem::TmpFile::makeSibling( file_r ) );
+      if ( ! tmp )
+        ZYPP_THROW( Exception( "Can't create solv file: "+file_r.asString() ) );
+
+      {
+        AutoDispose<FILE*> file( ::fopen( tmp.path().c_str(), "we" ), ::fclose );
+        if ( file == NULL )
+        {
+          file.resetDispose();
+          ZYPP_THROW( Exception( "Can't create solv file: "+file_r.asString() ) );
+        }
+
+        if ( myPool()._writeSolv( repo_r.get(), file ) != 0 )
+          ZYPP_THROW( Exception( "Error writing solv file: "+file_r.asString() ) );
+
+        file.resetDispose();
+        if ( ::fclose( file ) != 0 )
+          ZYPP_THROW( Exception( "Error writing solv file: "+file_r.asString() ) );
+      }
+
+      if ( filesystem::rename( tmp.path(), file_r ) != 0 )
+        ZYPP_THROW( Exception( "Can't create solv file: "+file_r.asString() ) );
+      filesystem::chmod( file_r, 0644 );
+    }
+
+    /////////////////////////////////////////////////////////////////
+
     Repository Pool::addRepoHelix( const Pathname & file_r, const std::string & alias_r )
     {
       // Using a temporay repo! (The additional parenthesis are required.)
@@ -188,6 +246,115 @@ namespace zypp
       return ret;
     }
 
+    /////////////////////////////////////////////////////////////////
+
+    namespace
+    {
+      /** Snapshot file format:
+       * \code
+       * <snapshotMagic>
+       * <cookie>
+       * <number of repos>
+       * <alias>
+       * <solv data>
+       * <alias>
+       * ...
+       * \endcode
+       */
+      const char * snapshotMagic = "ZYPP-POOL-SNAPSHOT-1";
+
+      std::string getline( FILE * file_r )
+      {
+        std::string ret;
+        for ( int ch = ::getc( file_r ); ch != EOF && ch != '\n'; ch = ::getc( file_r ) )
+          ret += ch;
+        return ret;
+      }
+    } // namespace
+
+    void Pool::saveSnapshot( const Pathname & file_r, const std::string & cookie_r )
+    {
+      filesystem::TmpFile tmp( filesystem::TmpFile::makeSibling( file_r ) );
+      if ( ! tmp )
+        ZYPP_THROW( Exception( "Can't create pool snapshot: "+file_r.asString() ) );
+
+      std::vector<Repository> repos;
+      for_( it, reposBegin(), reposEnd() )
+      {
+        if ( ! it->isSystemRepo() )
+          repos.push_back( *it );
+      }
+
+      {
+        AutoDispose<FILE*> file( ::fopen( tmp.path().c_str(), "we" ), ::fclose );
+        if ( file == NULL )
+        {
+          file.resetDispose();
+          ZYPP_THROW( Exception( "Can't create pool snapshot: "+file_r.asString() ) );
+        }
+
+        ::fprintf( file, "%s\n%s\n%zu\n", snapshotMagic, cookie_r.c_str(), repos.size() );
+        for_( it, repos.begin(), repos.end() )
+        {
+          ::fprintf( file, "%s\n", it->alias().c_str() );
+          if ( myPool()._writeSolv( it->get(), file ) != 0 )
+            ZYPP_THROW( Exception( "Error writing pool snapshot: "+file_r.asString() ) );
+        }
+
+        file.resetDispose();
+        if ( ::fclose( file ) != 0 )
+          ZYPP_THROW( Exception( "Error writing pool snapshot: "+file_r.asString() ) );
+      }
+
+      if ( filesystem::rename( tmp.path(), file_r ) != 0 )
+        ZYPP_THROW( Exception( "Can't create pool snapshot: "+file_r.asString() ) );
+      MIL << "Pool snapshot " << file_r << ": " << repos.size() << " repos" << endl;
+    }
+
+    std::vector<Repository> Pool::loadSnapshot( const Pathname & file_r, const std::string & cookie_r )
+    {
+      std::vector<Repository> ret;
+
+      AutoDispose<FILE*> file( ::fopen( file_r.c_str(), "re" ), ::fclose );
+      if ( file == NULL )
+      {
+        file.resetDispose();
+        MIL << "No pool snapshot " << file_r << endl;
+        return ret;
+      }
+
+      if ( getline( file ) != snapshotMagic || getline( file ) != cookie_r )
+      {
+        MIL << "Pool snapshot " << file_r << " is outdated." << endl;
+        return ret;
+      }
+
+      try
+      {
+        unsigned count = str::strtonum<unsigned>( getline( file ) );
+        for ( unsigned i = 0; i < count; ++i )
+        {
+          std::string alias( getline( file ) );
+          if ( alias.empty() )
+            ZYPP_THROW( Exception( "Error reading pool snapshot: "+file_r.asString() ) );
+
+          reposErase( alias );
+          ret.push_back( reposInsert( alias ) );
+          if ( myPool()._addSolv( ret.back().get(), file ) != 0 )
+            ZYPP_THROW( Exception( "Error reading pool snapshot: "+file_r.asString() ) );
+        }
+      }
+      catch ( const Exception & excpt )
+      {
+        for_( it, ret.begin(), ret.end() )
+          it->eraseFromPool();
+        ZYPP_RETHROW( excpt );
+      }
+
+      MIL << "Pool snapshot " << file_r << ": loaded " << ret.size() << " repos" << endl;
+      return ret;
+    }
+
    /////////////////////////////////////////////////////////////////
 
     void Pool::setTextLocale( const Locale & locale_r )
@@ -13,6 +13,7 @@
 #define ZYPP_SAT_POOL_H
 
 #include <iosfwd>
+#include <vector>
 
 #include "zypp/Pathname.h"
 
@@ -26,6 +27,7 @@ namespace zypp
 
   class SerialNumber;
   class RepoInfo;
+  class Edition;
 
   ///////////////////////////////////////////////////////////////////
   namespace sat
@@ -68,6 +70,61 @@ namespace zypp
 	/** \ref prepare plus some expensive checks done before solving only. */
 	void prepareForSolving() const;
 
+      public:
+        /** \name Concurrent read access.
+         *
+         * Per default the pool must not be used by more than one thread,
+         * as even plain queries change libsolvs data on demand (ids are
+         * created, whatprovides are computed, attribute data are paged in).
+         * In concurrent read mode those changes are serialized by a lock,
+         * and queries copy results which might be moved by another thread
+         * (e.g. \ref WhatProvides).
+         *
+         * \code
+         *   sat::Pool pool( sat::Pool::instance() );
+         *   pool.setConcurrentReads( true );
+         *   pool.prepareForConcurrentReads(); // or ResPool::prepareForConcurrentReads
+         *   // start the reading threads...
+         * \endcode
+         *
+         * Once prepared, these queries take no lock and copy nothing:
+         * \ref WhatProvides for relations known at that time, plain
+         * \ref Solvable attribute lookups (str, num, bool, id), iterating
+         * a \ref LookupAttr without match string, and reading \ref IdString
+         * and \ref Capability details.
+         *
+         * Still serialized are: looking up ids by string (\ref IdString and
+         * \ref Capability ctors), stringifying relations, localized strings,
+         * checksums and media locations, and \ref LookupAttr with a match
+         * string or searching file lists (libsolvs tmp space is shared).
+         *
+         * After \ref prepareForConcurrentReads no new ids must be created.
+         * Readers access the string and relation space without lock, so a new
+         * id could move them underneath. Build all \ref IdString and \ref Capability
+         * the readers need beforehand (as well as any \ref SolvableColumns, which
+         * store strings as \ref IdString); creating one anyway is logged as error
+         * and asserted.
+         *
+         * Any change to the pool (adding or removing repos, solvables or
+         * locales, solving, ...) still requires exclusive access and calling
+         * \ref prepareForConcurrentReads again. So do \c const \c char* results
+         * which point into libsolvs tmp space, e.g. \ref Capability::c_str for
+         * relations: use \c asString.
+         */
+        //@{
+        /** Whether concurrent read mode is on. */
+        bool concurrentReads() const;
+
+        /** Turn concurrent read mode on or off (no other thread must use the pool meanwhile). */
+        void setConcurrentReads( bool yesno_r );
+
+        /** \ref prepare and build all data which are otherwise computed on demand.
+         * Call it after the pool was changed, before starting the readers.
+         * \see \ref concurrentReads for what is lock-free afterwards.
+         */
+        void prepareForConcurrentReads() const;
+        //@}
+
       public:
         /** Whether \ref Pool contains repos. */
         bool reposEmpty() const;
@@ -122,6 +179,27 @@ namespace zypp
         */
         Repository addRepoSolv( const Pathname & file_r, const RepoInfo & info_r );
 
+      public:
+        /** \name Remember file provides in solv cache files.
+         * If the \ref Pool needs to search a repos filelist for file provides,
+         * writing the repo back to its solv cache file lets the file remember
+         * them. Loading it next time will not need to search the filelist again,
+         * unless new file dependencies are added to the \ref Pool (e.g. by adding
+         * a repo). \see \ref RepoManager::loadFromCache.
+         */
+        //@{
+        /** Whether \a repo_r should be written back to the solv file it was loaded from.
+         * Only repos loaded unfiltered from a single solv file qualify.
+         * This prepares the \ref Pool, i.e. the filelists are searched if needed.
+         */
+        bool repoSolvCacheOutdated( const Repository & repo_r ) const;
+
+        /** Atomically replace \a file_r by \a repo_r written as solv file.
+         * \throws Exception if writing the file fails.
+         */
+        void saveRepoSolv( const Repository & repo_r, const Pathname & file_r );
+        //@}
+
       public:
         /** Load \ref Solvables from a helix-file into a \ref Repository named \c name_r.
          * Supports loading of gzip compressed files (.gz). In case of an exception
@@ -137,6 +215,33 @@ namespace zypp
         */
         Repository addRepoHelix( const Pathname & file_r, const RepoInfo & info_r );
 
+      public:
+        /** \name Pool snapshot.
+         * All repos except the system repo written to a single file, so
+         * they can be loaded at once on the next start. The repos are stored
+         * architecture filtered and with the file provides already added,
+         * so loading them does not need to search the filelists again.
+         *
+         * Whether the snapshot is still valid is determined by \a cookie_r,
+         * which must identify the state of the stored repos (e.g. by their
+         * solv files cookies). \see \ref misc::defaultLoadSystem.
+         */
+        //@{
+        /** Write all repos except the system repo to \a file_r.
+         * \throws Exception if writing the file fails.
+         */
+        void saveSnapshot( const Pathname & file_r, const std::string & cookie_r );
+
+        /** Load the repos stored in \a file_r, if the snapshots cookie matches \a cookie_r.
+         * Repos of the same name already in the \ref Pool are replaced. The
+         * \ref RepoInfo is not stored in the snapshot, so the caller should
+         * \ref Repository::setInfo.
+         * \return The loaded repos, or an empty vector if the snapshot is missing or outdated.
+         * \throws Exception if reading the file fails (in that case no repo is loaded).
+         */
+        std::vector<Repository> loadSnapshot( const Pathname & file_r, const std::string & cookie_r );
+        //@}
+
       public:
         /** Whether \ref Pool contains solvables. */
         bool solvablesEmpty() const;
@@ -167,6 +272,15 @@ namespace zypp
         WhatProvides whatProvides( Capability cap_r ) const
         { return WhatProvides( cap_r ); }
 
+      public:
+        /** Compare two editions like \ref Edition::compare does.
+         * Editions used by solvables in the pool are compared by their rank in
+         * a precomputed order of all editions in the pool, which is rebuilt on
+         * demand whenever the pools content changes. Unknown editions fall back
+         * to \ref Edition::compare. Use this when sorting many pool items.
+         */
+        int compareEdition( const Edition & lhs, const Edition & rhs ) const;
+
       public:
         /** \name Requested locales. */
         //@{
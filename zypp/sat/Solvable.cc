@@ -170,6 +170,7 @@ namespace zypp
     std::string Solvable::lookupStrAttribute( const SolvAttr & attr ) const
     {
       NO_SOLVABLE_RETURN( std::string() );
+      thread::MutexLock guard( myPool().lookupLock() );
       const char * s = ::solvable_lookup_str( _solvable, attr.id() );
       return s ? s : std::string();
     }
@@ -177,6 +178,7 @@ namespace zypp
     std::string Solvable::lookupStrAttribute( const SolvAttr & attr, const Locale & lang_r ) const
     {
       NO_SOLVABLE_RETURN( std::string() );
+      thread::MutexLock guard( myPool().lazyLock() );
       const char * s = 0;
       if ( lang_r == Locale::noCode )
       {
@@ -196,24 +198,28 @@ namespace zypp
     unsigned long long Solvable::lookupNumAttribute( const SolvAttr & attr ) const
     {
       NO_SOLVABLE_RETURN( 0 );
+      thread::MutexLock guard( myPool().lookupLock() );
       return ::solvable_lookup_num( _solvable, attr.id(), 0 );
     }
 
     bool Solvable::lookupBoolAttribute( const SolvAttr & attr ) const
     {
       NO_SOLVABLE_RETURN( false );
+      thread::MutexLock guard( myPool().lookupLock() );
       return ::solvable_lookup_bool( _solvable, attr.id() );
     }
 
     detail::IdType Solvable::lookupIdAttribute( const SolvAttr & attr ) const
     {
       NO_SOLVABLE_RETURN( detail::noId );
+      thread::MutexLock guard( myPool().lookupLock() );
       return ::solvable_lookup_id( _solvable, attr.id() );
     }
 
     CheckSum Solvable::lookupCheckSumAttribute( const SolvAttr & attr ) const
     {
       NO_SOLVABLE_RETURN( CheckSum() );
+      thread::MutexLock guard( myPool().lazyLock() );
       detail::IdType chksumtype = 0;
       const char * s = ::solvable_lookup_checksum( _solvable, attr.id(), &chksumtype );
       if ( ! s )
@@ -253,6 +259,7 @@ namespace zypp
     OnMediaLocation Solvable::lookupLocation() const
     {
       NO_SOLVABLE_RETURN( OnMediaLocation() );
+      thread::MutexLock guard( myPool().lazyLock() ); // the result is in libsolvs tmp space
       // medianumber and path
       unsigned medianr;
       const char * file = ::solvable_lookup_location( _solvable, &medianr );
@@ -515,6 +522,7 @@ namespace zypp
     {
       NO_SOLVABLE_RETURN( ! rhs.get() );
       ::_Solvable * rhssolvable( rhs.get() );
+      thread::MutexLock guard( myPool().lookupLock() );
       return rhssolvable && ( _solvable == rhssolvable || ::solvable_identical( _solvable, rhssolvable ) );
     }
 
@@ -0,0 +1,166 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/sat/SolvableColumns.cc
+ *
+*/
+#include <iostream>
+#include <map>
+
+#include "zypp/base/Logger.h"
+#include "zypp/base/Exception.h"
+
+#include "zypp/sat/detail/PoolImpl.h"
+#include "zypp/sat/SolvableColumns.h"
+#include "zypp/sat/LookupAttr.h"
+#include "zypp/sat/Pool.h"
+#include "zypp/Repository.h"
+
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace sat
+  { /////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    namespace
+    { /////////////////////////////////////////////////////////////////
+
+      const SolvableColumns::size_type noRow = SolvableColumns::size_type(-1);
+
+      /** Store the value \a it_r points to in \a row_r (columns are allocated on demand). */
+      void storeValue( SolvableColumns::StrColumn & strs_r, SolvableColumns::NumColumn & nums_r,
+                       SolvableColumns::size_type rows_r, SolvableColumns::size_type row_r,
+                       const LookupAttr::iterator & it_r )
+      {
+        if ( it_r.solvAttrNumeric() )
+        {
+          if ( nums_r.empty() )
+            nums_r.resize( rows_r );
+          nums_r[row_r] = it_r.asUnsignedLL();
+          return;
+        }
+
+        if ( strs_r.empty() )
+          strs_r.resize( rows_r );
+        if ( it_r.solvAttrIdString() )
+          strs_r[row_r] = it_r.idStr();				// already in the pool
+        else if ( it_r.solvAttrType() == REPOKEY_TYPE_STR )
+          strs_r[row_r] = IdString( it_r.c_str() );
+        else
+          strs_r[row_r] = IdString( it_r.asString() );	// dirs, checksums, ...
+      }
+
+      /////////////////////////////////////////////////////////////////
+    } // namespace
+    ///////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : SolvableColumns
+    //
+    ///////////////////////////////////////////////////////////////////
+
+    void SolvableColumns::extract()
+    {
+      _columns.clear();
+      _columns.resize( _attrs.size() );
+      if ( _solvables.empty() || _attrs.empty() )
+        return;
+      // Storing string values creates ids, which readers of a prepared pool don't expect.
+      if ( detail::PoolMember::myPool().preparedForConcurrentReads() )
+        ZYPP_THROW( Exception( "SolvableColumns must be built before prepareForConcurrentReads" ) );
+
+      // Row of each solvable and the rows per repo. Duplicate
+      // solvables are copied from their first row at the end.
+      std::vector<size_type> rowOf( Pool::instance().capacity(), noRow );
+      std::map<detail::RepoIdType, std::vector<size_type> > repoRows;
+      std::vector<std::pair<size_type,size_type> > duplicates;
+      for ( size_type row = 0; row < _solvables.size(); ++row )
+      {
+        Solvable solv( _solvables[row] );
+        if ( ! solv || solv.id() >= rowOf.size() )
+          continue;
+        if ( rowOf[solv.id()] != noRow )
+        {
+          duplicates.push_back( std::make_pair( row, rowOf[solv.id()] ) );
+          continue;
+        }
+        rowOf[solv.id()] = row;
+        repoRows[solv.repository().id()].push_back( row );
+      }
+
+      for_( rit, repoRows.begin(), repoRows.end() )
+      {
+        Repository repo( rit->first );
+        const std::vector<size_type> & rows( rit->second );
+        // Walking the whole repo is cheaper unless only a few of its solvables are wanted.
+        bool walkRepo = ( rows.size() * 4 >= repo.solvablesSize() );
+
+        for ( size_type col = 0; col < _attrs.size(); ++col )
+        {
+          Column & column( _columns[col] );
+          if ( walkRepo )
+          {
+            LookupAttr q( _attrs[col], repo );
+            for_( it, q.begin(), q.end() )
+            {
+              size_type row = rowOf[it.inSolvable().id()];
+              if ( row != noRow )
+                storeValue( column.strs, column.nums, size(), row, it );
+              it.nextSkipSolvable();	// first value only
+            }
+          }
+          else
+          {
+            for_( row, rows.begin(), rows.end() )
+            {
+              LookupAttr q( _attrs[col], _solvables[*row] );
+              LookupAttr::iterator it( q.begin() );
+              if ( it != q.end() )
+                storeValue( column.strs, column.nums, size(), *row, it );
+            }
+          }
+        }
+      }
+
+      for_( it, duplicates.begin(), duplicates.end() )
+      {
+        for_( col, _columns.begin(), _columns.end() )
+        {
+          if ( ! col->strs.empty() )
+            col->strs[it->first] = col->strs[it->second];
+          if ( ! col->nums.empty() )
+            col->nums[it->first] = col->nums[it->second];
+        }
+      }
+      DBG << *this << endl;
+    }
+
+    /******************************************************************
+    **
+    **	FUNCTION NAME : operator<<
+    **	FUNCTION TYPE : std::ostream &
+    */
+    std::ostream & operator<<( std::ostream & str, const SolvableColumns & obj )
+    {
+      str << "SolvableColumns(" << obj.size() << " rows){";
+      for_( it, obj._attrs.begin(), obj._attrs.end() )
+        str << ( it == obj._attrs.begin() ? "" : "," ) << *it;
+      return str << "}";
+    }
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace sat
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,155 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/sat/SolvableColumns.h
+ *
+*/
+#ifndef ZYPP_SAT_SOLVABLECOLUMNS_H
+#define ZYPP_SAT_SOLVABLECOLUMNS_H
+
+#include <iosfwd>
+#include <vector>
+
+#include "zypp/base/Easy.h"
+#include "zypp/IdString.h"
+#include "zypp/sat/Solvable.h"
+#include "zypp/sat/SolvAttr.h"
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace sat
+  { /////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : SolvableColumns
+    //
+    /** Attribute values of many \ref Solvable, stored column by column.
+     *
+     * Instead of looking up each attribute of each solvable (like
+     * \ref Solvable::lookupStrAttribute does), each column is extracted
+     * in one pass over the repositories attribute data. Numeric values
+     * are stored as <tt>unsigned long long</tt>, all others as \ref IdString.
+     * Multi valued attributes store their first value only.
+     *
+     * \code
+     *   std::vector<SolvAttr> attrs;
+     *   attrs.push_back( SolvAttr::summary );
+     *   attrs.push_back( SolvAttr::installsize );
+     *   SolvableColumns table( query.begin(), query.end(), attrs );
+     *   for ( unsigned row = 0; row < table.size(); ++row )
+     *     cout << table.solvable( row ) << " " << table.str( row, 0 ) << " " << table.num( row, 1 ) << endl;
+     * \endcode
+     *
+     * \note Translated texts are not looked up. Use \ref Solvable::summary
+     * and friends if the text in the requested locale is needed.
+     *
+     * \note Storing string values may create new ids. So in \ref Pool::concurrentReads
+     * mode build the table before \ref Pool::prepareForConcurrentReads. Building
+     * it on a prepared pool throws.
+     */
+    class SolvableColumns
+    {
+      friend std::ostream & operator<<( std::ostream & str, const SolvableColumns & obj );
+
+      public:
+        typedef std::vector<IdString>           StrColumn;
+        typedef std::vector<unsigned long long> NumColumn;
+        typedef unsigned                        size_type;
+
+      public:
+        /** Default ctor: empty table */
+        SolvableColumns()
+        {}
+
+        /** Extract \a attrs_r for a range of \ref Solvable, \ref PoolItem or \ref ResObject::constPtr
+         * (e.g. a \ref PoolQuery result).
+         * \throws Exception if the pool is prepared for concurrent reads.
+         */
+        template <class _Iterator>
+        SolvableColumns( _Iterator begin_r, _Iterator end_r, const std::vector<SolvAttr> & attrs_r )
+        : _attrs( attrs_r )
+        {
+          for_( it, begin_r, end_r )
+            _solvables.push_back( asSolvable()( *it ) );
+          extract();
+        }
+
+      public:
+        /** Number of rows (solvables). */
+        size_type size() const
+        { return _solvables.size(); }
+
+        /** Whether there are no rows. */
+        bool empty() const
+        { return _solvables.empty(); }
+
+        /** Number of columns (attributes). */
+        size_type columns() const
+        { return _attrs.size(); }
+
+        /** The \ref Solvable in \a row_r. */
+        Solvable solvable( size_type row_r ) const
+        { return _solvables[row_r]; }
+
+        /** The \ref SolvAttr in \a col_r. */
+        SolvAttr attr( size_type col_r ) const
+        { return _attrs[col_r]; }
+
+      public:
+        /** String value (or \ref IdString::Null) in \a row_r and \a col_r. */
+        IdString str( size_type row_r, size_type col_r ) const
+        {
+          const StrColumn & col( _columns[col_r].strs );
+          return col.empty() ? IdString() : col[row_r];
+        }
+
+        /** Numeric value (or \c 0) in \a row_r and \a col_r. */
+        unsigned long long num( size_type row_r, size_type col_r ) const
+        {
+          const NumColumn & col( _columns[col_r].nums );
+          return col.empty() ? 0 : col[row_r];
+        }
+
+        /** All string values in \a col_r (empty if the column has none). */
+        const StrColumn & strColumn( size_type col_r ) const
+        { return _columns[col_r].strs; }
+
+        /** All numeric values in \a col_r (empty if the column has none). */
+        const NumColumn & numColumn( size_type col_r ) const
+        { return _columns[col_r].nums; }
+
+      private:
+        /** Values of one column, allocated when the first value is stored. */
+        struct Column
+        {
+          StrColumn strs;
+          NumColumn nums;
+        };
+
+        void extract();
+
+      private:
+        std::vector<Solvable> _solvables;
+        std::vector<SolvAttr> _attrs;
+        std::vector<Column>   _columns;
+    };
+    ///////////////////////////////////////////////////////////////////
+
+    /** \relates SolvableColumns Stream output */
+    std::ostream & operator<<( std::ostream & str, const SolvableColumns & obj );
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace sat
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_SAT_SOLVABLECOLUMNS_H
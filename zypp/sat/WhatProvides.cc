@@ -30,7 +30,8 @@ namespace zypp
     //
     /** WhatProvides implementation date.
      * Stores the offset into a O terminated Id array. Per default
-     * libsolvs whatprovidesdata, otherwise private data.
+     * libsolvs whatprovidesdata, otherwise private data (e.g. a copy
+     * of libsolvs result in concurrent read mode).
      *
      * As libsolvs whatprovidesdata might be realocated
      * while iterating a result, the iterator takes an
@@ -49,6 +50,17 @@ namespace zypp
         : _offset( offset_r ), _private( 0 )
         {}
 
+        Impl( const detail::IdType * ids_r )
+        : _offset( 0 ), _private( 0 )
+        {
+          // use private data to store a copy (incl. trailing NULL)
+          for ( ; *ids_r; ++ids_r )
+            _pdata.push_back( *ids_r );
+          _pdata.push_back( detail::noId );
+
+          _private = &_pdata.front(); // ptr to 1st element
+        }
+
         Impl( const std::tr1::unordered_set<detail::IdType> & ids_r )
         : _offset( 0 ), _private( 0 )
         {
@@ -96,10 +108,15 @@ namespace zypp
 
     WhatProvides::WhatProvides( Capability cap_r )
     {
+      thread::MutexLock guard( myPool().lookupLock() );
       unsigned res( myPool().whatProvides( cap_r ) );
       if ( myPool().whatProvidesData( res ) )
       {
-        _pimpl.reset( new Impl( res ) );
+        // Unless prepared, concurrent readers may relocate libsolvs index while we iterate.
+        if ( myPool().concurrentReads() && ! myPool().preparedForConcurrentReads() )
+          _pimpl.reset( new Impl( myPool().getPool()->whatprovidesdata + res ) );
+        else
+          _pimpl.reset( new Impl( res ) );
       }
       // else: no Impl for empty result.
     }
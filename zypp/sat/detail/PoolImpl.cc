@@ -11,6 +11,8 @@
 */
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <cassert>
 #include <boost/mpl/int.hpp>
 
 #include "zypp/base/Easy.h"
@@ -21,8 +23,10 @@
 #include "zypp/base/WatchFile.h"
 #include "zypp/base/Sysconfig.h"
 #include "zypp/base/IOStream.h"
+#include "zypp/AutoDispose.h"
 
 #include "zypp/ZConfig.h"
+#include "zypp/PathInfo.h"
 
 #include "zypp/sat/detail/PoolImpl.h"
 #include "zypp/sat/Pool.h"
@@ -35,6 +39,8 @@
 
 extern "C"
 {
+#include <solv/evr.h>
+#include <solv/repo_write.h>
 // Workaround libsolv project not providing a common include
 // directory. (the -devel package does, but the git repo doesn't).
 // #include <solv/repo_helix.h>
@@ -174,6 +180,8 @@ namespace zypp
       //
       PoolImpl::PoolImpl()
       : _pool( ::pool_create() )
+      , _concurrentReads( false )
+      , _preparedForConcurrentReads( false )
       {
         MIL << "Creating sat-pool." << endl;
         if ( ! _pool )
@@ -232,6 +240,7 @@ namespace zypp
           else           MIL << a1 << endl;
         }
         ::pool_freewhatprovides( _pool );
+        _preparedForConcurrentReads = false;
       }
 
       void PoolImpl::prepare() const
@@ -246,7 +255,7 @@ namespace zypp
         {
           MIL << "pool_createwhatprovides..." << endl;
 
-          ::pool_addfileprovides( _pool );
+          ::pool_addfileprovides_queue( _pool, _addedFileProvides, _addedFileProvidesInst );
           ::pool_createwhatprovides( _pool );
         }
         if ( ! _pool->languages )
@@ -269,6 +278,53 @@ namespace zypp
 	prepare();
       }
 
+      void PoolImpl::prepareForConcurrentReads() const
+      {
+        thread::MutexLock guard( lazyLock() );
+        prepare();
+        // The lists may create ids and whatprovides themselves, so
+        // build them first.
+        getAvailableLocales();
+        multiversionList();
+        onSystemByUserList();
+        requiredFilesystems();
+        evrRank( noId );
+        Pool pool( Pool::instance() );
+        for_( it, pool.solvablesBegin(), pool.solvablesEnd() )
+        {
+          it->arch(); // registers unknown architectures
+        }
+        // Providers of all relations known so far, so queries
+        // don't touch libsolvs whatprovides index.
+        for ( IdType rel = 1; rel < _pool->nrels; ++rel )
+        {
+          ::pool_whatprovides( _pool, MAKERELDEP(rel) );
+        }
+        // Keep all attribute data in memory, so lookups don't page.
+        for_( it, pool.reposBegin(), pool.reposEnd() )
+        {
+          ::repo_disable_paging( it->get() );
+        }
+        // pool_createwhatprovides dropped the id hashes. Rebuild them,
+        // so looking up existing ids doesn't change anything.
+        ::pool_str2id( _pool, "solvable:name", /*create*/false );
+        ::pool_rel2id( _pool, SOLVABLE_NAME, SOLVABLE_NAME, REL_EQ, /*create*/false );
+
+        _preparedForConcurrentReads = true;
+        MIL << "Prepared for concurrent reads: " << _pool->ss.nstrings << " strings, "
+            << _pool->nrels << " relations" << endl;
+      }
+
+      void PoolImpl::checkNoNewIds( int nstrings_r, int nrels_r ) const
+      {
+        if ( _pool->ss.nstrings != nstrings_r || _pool->nrels != nrels_r )
+        {
+          ERR << "New id created after prepareForConcurrentReads: "
+              << ( _pool->ss.nstrings - nstrings_r ) << " strings, " << ( _pool->nrels - nrels_r ) << " relations" << endl;
+          assert( ! "No new ids after prepareForConcurrentReads" );
+        }
+      }
+
       ///////////////////////////////////////////////////////////////////
 
       ::_Repo * PoolImpl::_createRepo( const std::string & name_r )
@@ -285,6 +341,7 @@ namespace zypp
         setDirty(__FUNCTION__, repo_r->name );
         ::repo_free( repo_r, /*reuseids*/false );
         eraseRepoInfo( repo_r );
+        _unfilteredSolvRepos.erase( repo_r );
 	if ( isSystemRepo( repo_r ) )
 	{
 	  // systemRepo added
@@ -295,9 +352,17 @@ namespace zypp
       int PoolImpl::_addSolv( ::_Repo * repo_r, FILE * file_r )
       {
         setDirty(__FUNCTION__, repo_r->name );
+        bool wasEmpty = ! repo_r->nsolvables;
         int ret = ::repo_add_solv( repo_r, file_r, 0 );
         if ( ret == 0 )
-          _postRepoAdd( repo_r );
+        {
+          // Only a solv file loaded unfiltered into an empty repo may be
+          // written back (see solvCacheOutdated).
+          if ( _postRepoAdd( repo_r ) == 0 && wasEmpty && ! isSystemRepo( repo_r ) )
+            _unfilteredSolvRepos.insert( repo_r );
+          else
+            _unfilteredSolvRepos.erase( repo_r );
+        }
         return ret;
       }
 
@@ -310,8 +375,9 @@ namespace zypp
         return 0;
       }
 
-      void PoolImpl::_postRepoAdd( ::_Repo * repo_r )
+      unsigned PoolImpl::_postRepoAdd( ::_Repo * repo_r )
       {
+        unsigned filtered = 0;
         if ( ! isSystemRepo( repo_r ) )
         {
             // Filter out unwanted archs
@@ -342,6 +408,7 @@ namespace zypp
               {
                 // Free remembered entries
                   ::repo_free_solvable_block( repo_r, blockBegin, blockSize, /*reuseids*/false );
+                  filtered += blockSize;
                   blockBegin = blockSize = 0;
               }
           }
@@ -349,6 +416,7 @@ namespace zypp
           {
               // Free remembered entries
               ::repo_free_solvable_block( repo_r, blockBegin, blockSize, /*reuseids*/false );
+              filtered += blockSize;
               blockBegin = blockSize = 0;
           }
         }
@@ -357,6 +425,72 @@ namespace zypp
 	  // systemRepo added
 	  _onSystemByUserListPtr.reset(); // re-evaluate
 	}
+        return filtered;
+      }
+
+      int PoolImpl::_writeSolv( ::_Repo * repo_r, FILE * file_r )
+      {
+        prepare();
+        if ( _coversAddedFileProvides( repo_r ) )
+          return ::repo_write( repo_r, file_r );
+
+        // Store what's already remembered plus the new ones.
+        Queue stored;
+        ::repo_lookup_idarray( repo_r, SOLVID_META, REPOSITORY_ADDEDFILEPROVIDES, stored );
+        const Queue & added( isSystemRepo( repo_r ) ? _addedFileProvidesInst : _addedFileProvides );
+        for_( it, added.begin(), added.end() )
+        {
+          if ( ! stored.contains( *it ) )
+            stored.push( *it );
+        }
+
+        // The loaded repo must not change, so the file provides are added
+        // to a copy read back into a scratch pool.
+        AutoDispose<FILE*> tmpfile( ::tmpfile(), ::fclose );
+        if ( tmpfile == NULL )
+        {
+          tmpfile.resetDispose();
+          return -1;
+        }
+        if ( ::repo_write( repo_r, tmpfile ) != 0 || ::fflush( tmpfile ) != 0 )
+          return -1;
+        ::rewind( tmpfile );
+
+        AutoDispose< ::_Pool *> scratch( ::pool_create(), ::pool_free );
+        ::_Repo * scratchrepo = ::repo_create( scratch, repo_r->name );
+        if ( ::repo_add_solv( scratchrepo, tmpfile ) != 0 )
+          return -1;
+
+        ::Repodata * data = ::repo_add_repodata( scratchrepo, REPO_REUSE_REPODATA );
+        for_( it, stored.begin(), stored.end() )
+          ::repodata_add_idarray( data, SOLVID_META, REPOSITORY_ADDEDFILEPROVIDES,
+                                  ::pool_str2id( scratch, ::pool_id2str( _pool, *it ), /*create*/1 ) );
+        ::repodata_internalize( data );
+        return ::repo_write( scratchrepo, file_r );
+      }
+
+      bool PoolImpl::_coversAddedFileProvides( ::_Repo * repo_r ) const
+      {
+        const Queue & added( isSystemRepo( repo_r ) ? _addedFileProvidesInst : _addedFileProvides );
+        if ( added.empty() )
+          return true;
+
+        Queue stored;
+        ::repo_lookup_idarray( repo_r, SOLVID_META, REPOSITORY_ADDEDFILEPROVIDES, stored );
+        for_( it, added.begin(), added.end() )
+        {
+          if ( ! stored.contains( *it ) )
+            return false;
+        }
+        return true;
+      }
+
+      bool PoolImpl::solvCacheOutdated( ::_Repo * repo_r ) const
+      {
+        if ( ! _unfilteredSolvRepos.count( repo_r ) )
+          return false;
+        prepare();
+        return ! _coversAddedFileProvides( repo_r );
       }
 
       detail::SolvableIdType PoolImpl::_addSolvables( ::_Repo * repo_r, unsigned count_r )
@@ -397,6 +531,48 @@ namespace zypp
 
       ///////////////////////////////////////////////////////////////////
 
+      namespace
+      {
+        /** Order edition ids by \c ::pool_evrcmp. */
+        struct EvrLess
+        {
+          EvrLess( ::_Pool * pool_r ) : _pool( pool_r ) {}
+          bool operator()( detail::IdType lhs, detail::IdType rhs ) const
+          { return ::pool_evrcmp( _pool, lhs, rhs, EVRCMP_COMPARE ) < 0; }
+          ::_Pool * _pool;
+        };
+      } // namespace
+
+      void PoolImpl::evrRankInit() const
+      {
+        std::vector<unsigned>( _pool->ss.nstrings, 0 ).swap( _evrRank );
+
+        // collect the distinct editions in use:
+        std::vector<detail::IdType> evrs;
+        for ( detail::SolvableIdType id = getFirstId(); id != noSolvableId; id = getNextId( id ) )
+        {
+          detail::IdType evr = _pool->solvables[id].evr;
+          if ( ! _evrRank[evr] )
+          {
+            _evrRank[evr] = 1; // mark as seen
+            evrs.push_back( evr );
+          }
+        }
+
+        // sort them once; equal editions (e.g. '1.0' and '0:1.0') share a rank:
+        std::sort( evrs.begin(), evrs.end(), EvrLess( _pool ) );
+        unsigned rank = 0;
+        for_( it, evrs.begin(), evrs.end() )
+        {
+          if ( it == evrs.begin() || ::pool_evrcmp( _pool, *(it-1), *it, EVRCMP_COMPARE ) != 0 )
+            ++rank;
+          _evrRank[*it] = rank;
+        }
+        MIL << "evrRank: " << evrs.size() << " editions, " << rank << " ranks" << endl;
+      }
+
+      ///////////////////////////////////////////////////////////////////
+
       // need on demand and id based Locale
       void _locale_hack( const LocaleSet & locales_r,
                          std::tr1::unordered_set<IdString> & locale2Solver )
@@ -20,11 +20,15 @@ extern "C"
 #include <solv/repo_solv.h>
 }
 #include <iosfwd>
+#include <vector>
 
 #include "zypp/base/Tr1hash.h"
 #include "zypp/base/NonCopyable.h"
 #include "zypp/base/SerialNumber.h"
+#include "zypp/thread/Mutex.h"
+#include "zypp/thread/MutexLock.h"
 #include "zypp/sat/detail/PoolMember.h"
+#include "zypp/sat/Queue.h"
 #include "zypp/RepoInfo.h"
 #include "zypp/Locale.h"
 #include "zypp/Capability.h"
@@ -70,7 +74,73 @@ namespace zypp
 	  /** \ref prepare plus some expensive checks done before solving only. */
 	  void prepareForSolving() const;
 
+        public:
+          /** \name Concurrent read access (see \ref sat::Pool::concurrentReads). */
+          //@{
+          bool concurrentReads() const
+          { return _concurrentReads; }
+
+          void setConcurrentReads( bool yesno_r )
+          { _concurrentReads = yesno_r; _preparedForConcurrentReads = false; }
+
+          /** Whether \ref concurrentReads is on and the pool was not changed
+           * since \ref prepareForConcurrentReads.
+           */
+          bool preparedForConcurrentReads() const
+          { return _concurrentReads && _preparedForConcurrentReads; }
+
+          /** Lock to hold while calling into libsolv functions which always
+           * alter the pool as a side effect (creating ids, tmp space).
+           * Actually locked only if \ref concurrentReads is on.
+           */
+          thread::MutexLock lazyLock() const
+          { return thread::MutexLock( _lazyMutex, _concurrentReads ); }
+
+          /** Lock to hold while calling into libsolv functions which alter the
+           * pool only until it is prepared (computing whatprovides, paging in
+           * attribute data). Not locked if \ref preparedForConcurrentReads.
+           */
+          thread::MutexLock lookupLock() const
+          { return thread::MutexLock( _lazyMutex, _concurrentReads && ! _preparedForConcurrentReads ); }
+
+          /** Lock to hold while creating ids (\ref IdString, \ref Capability).
+           * If \ref preparedForConcurrentReads, readers access the string and
+           * relation space without lock, so looking up existing ids is fine, but
+           * a new id would reallocate them underneath. This is an error, checked
+           * (logged and asserted) when the lock is released. Code which creates ids
+           * in bulk (e.g. \ref SolvableColumns) must refuse to run on a prepared pool.
+           */
+          class IdCreationLock
+          {
+            public:
+              IdCreationLock( const PoolImpl & impl_r )
+              : _impl( impl_r )
+              , _lock( impl_r.lazyLock() )
+              , _nstrings( impl_r._pool->ss.nstrings )
+              , _nrels( impl_r._pool->nrels )
+              {}
+
+              ~IdCreationLock()
+              {
+                if ( _impl.preparedForConcurrentReads() )
+                  _impl.checkNoNewIds( _nstrings, _nrels );
+              }
+
+            private:
+              const PoolImpl &  _impl;
+              thread::MutexLock _lock;
+              int               _nstrings;
+              int               _nrels;
+          };
+
+          /** \ref prepare and build all data which are otherwise created on demand. */
+          void prepareForConcurrentReads() const;
+          //@}
+
         private:
+          /** Complain if ids were created since \ref IdCreationLock remembered the counts. */
+          void checkNoNewIds( int nstrings_r, int nrels_r ) const;
+
           /** Invalidate housekeeping data (e.g. whatprovides) if the
            *  pools content changed.
            */
@@ -121,8 +191,28 @@ namespace zypp
           detail::SolvableIdType _addSolvables( ::_Repo * repo_r, unsigned count_r );
           //@}
 
-          /** Helper postprocessing the repo after adding solv or helix files. */
-          void _postRepoAdd( ::_Repo * repo_r );
+          /** Helper postprocessing the repo after adding solv or helix files.
+           * \return The number of solvables filtered out.
+           */
+          unsigned _postRepoAdd( ::_Repo * repo_r );
+
+          /** Write a repo as solv file.
+           * The file provides added by \ref prepare are remembered in the
+           * file, so libsolv does not need to search the filelists for
+           * them again after reading it. The loaded repo is not changed.
+           */
+          int _writeSolv( ::_Repo * repo_r, FILE * file_r );
+
+          /** Whether writing the repo back to the solv file it was loaded from
+           * would remember more file provides added by \ref prepare.
+           * Only repos loaded unfiltered from a single solv file qualify.
+           * Prepares the pool.
+           */
+          bool solvCacheOutdated( ::_Repo * repo_r ) const;
+
+        private:
+          /** Whether the repo remembers all file provides added by \ref prepare. */
+          bool _coversAddedFileProvides( ::_Repo * repo_r ) const;
 
         public:
           /** a \c valid \ref Solvable has a non NULL repo pointer. */
@@ -196,7 +286,7 @@ namespace zypp
            * Use \ref whatProvidesData to get the stored Id.
           */
           unsigned whatProvides( Capability cap_r )
-          { prepare(); return ::pool_whatprovides( _pool, cap_r.id() ); }
+          { thread::MutexLock guard( lookupLock() ); prepare(); return ::pool_whatprovides( _pool, cap_r.id() ); }
 
         public:
           /** \name Requested locales. */
@@ -263,6 +353,22 @@ namespace zypp
           }
           //@}
 
+        public:
+          /** \name Precomputed edition order. */
+          //@{
+          /** Rank of edition \c evr_r among all editions used by solvables in the pool.
+           * Ranks follow \ref Edition::compare (higher is newer, equal editions share
+           * a rank). \c 0 is returned if no solvable uses \c evr_r. The table is
+           * rebuilt on demand whenever the pools content changed.
+           */
+          unsigned evrRank( IdType evr_r ) const
+          {
+            if ( _evrRankWatcher.remember( _serial ) )
+              evrRankInit();
+            return( unsigned(evr_r) < _evrRank.size() ? _evrRank[evr_r] : 0 );
+          }
+          //@}
+
 	public:
 	  /** accessor for etc/sysconfig/storage reading file on demand */
 	  const std::set<std::string> & requiredFilesystems() const;
@@ -290,8 +396,24 @@ namespace zypp
           void onSystemByUserListInit() const;
           mutable scoped_ptr<OnSystemByUserList> _onSystemByUserListPtr;
 
+          /** Build the \ref evrRank table by sorting all editions used by solvables. */
+          void evrRankInit() const;
+          mutable std::vector<unsigned> _evrRank;
+          SerialNumberWatcher _evrRankWatcher;
+
 	  /** filesystems mentioned in /etc/sysconfig/storage */
 	  mutable scoped_ptr<std::set<std::string> > _requiredFilesystemsPtr;
+
+          /** File provides added by the last \ref prepare (all repos / installed repo). */
+          mutable Queue _addedFileProvides;
+          mutable Queue _addedFileProvidesInst;
+          /** Repos loaded unfiltered from a single solv file (see \ref solvCacheOutdated). */
+          std::set<RepoIdType> _unfilteredSolvRepos;
+
+          /** Serialize lazy changes if \ref concurrentReads. */
+          bool _concurrentReads;
+          mutable bool _preparedForConcurrentReads;
+          mutable thread::Mutex _lazyMutex;
       };
       ///////////////////////////////////////////////////////////////////
 
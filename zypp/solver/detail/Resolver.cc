@@ -18,6 +18,9 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
  * 02111-1307, USA.
  */
+#include <time.h>
+#include <algorithm>
+#include <sstream>
 #include <boost/static_assert.hpp>
 
 #include "zypp/solver/detail/Resolver.h"
@@ -27,14 +30,17 @@
 
 #include "zypp/Capabilities.h"
 #include "zypp/ZConfig.h"
+#include "zypp/Date.h"
 #include "zypp/base/Logger.h"
 #include "zypp/base/String.h"
 #include "zypp/base/Gettext.h"
 #include "zypp/base/Algorithm.h"
+#include "zypp/base/Tr1hash.h"
 #include "zypp/ResPool.h"
 #include "zypp/ResFilters.h"
 #include "zypp/sat/Pool.h"
 #include "zypp/sat/Solvable.h"
+#include "zypp/sat/WhatProvides.h"
 #include "zypp/sat/Transaction.h"
 #include "zypp/ResolverProblem.h"
 
@@ -384,6 +390,76 @@ void Resolver::applySolutions( const ProblemSolutionList & solutions )
   }
 }
 
+//---------------------------------------------------------------------------
+// ItemCapKindIndex
+
+void ItemCapKindIndex::add( const PoolItem & key, const PoolItem & item, Capability cap, Dep kind, bool initial )
+{
+    _entries.push_back( Entry( key.satSolvable().id(), item.satSolvable().id(), cap.id(), kind, initial ) );
+}
+
+void ItemCapKindIndex::sort()
+{
+    std::stable_sort( _entries.begin(), _entries.end() );
+}
+
+ItemCapKindList ItemCapKindIndex::find( const PoolItem & key ) const
+{
+    ItemCapKindList ret;
+    Entry probe( key.satSolvable().id(), 0, 0, Dep::REQUIRES, false );
+    for_( it, std::lower_bound( _entries.begin(), _entries.end(), probe ), std::upper_bound( _entries.begin(), _entries.end(), probe ) )
+    {
+	ret.push_back( ItemCapKind( PoolItem( sat::Solvable( it->item ) ), Capability( it->cap ), it->kind, it->initial ) );
+    }
+    return ret;
+}
+
+//---------------------------------------------------------------------------
+
+namespace
+{
+    // Fill the ItemCapKindIndex of Resolver::collectResolverInfo, one
+    // relation 'installer needs installed due to cap' at a time.
+    // Supplements are passed with the supplemented item as installer.
+    struct ResolverInfoCollector
+    {
+	ResolverInfoCollector( ItemCapKindIndex & isInstalledBy_r, ItemCapKindIndex & installs_r,
+			       ItemCapKindIndex & satifiedByInstalled_r, ItemCapKindIndex & installedSatisfied_r )
+	    : isInstalledBy( isInstalledBy_r )
+	    , installs( installs_r )
+	    , satifiedByInstalled( satifiedByInstalled_r )
+	    , installedSatisfied( installedSatisfied_r )
+	{}
+
+	void operator()( const PoolItem & installer, const PoolItem & installed, Capability cap, Dep kind )
+	{
+	    // The first installer found is the one triggering the installation.
+	    bool alreadySetForInstallation = installedBy.count( installed.satSolvable().id() );
+	    ResStatus & status( installed.status() );
+
+	    if ( status.isToBeInstalled()
+		 && relations.insert( ((unsigned long long)installed.satSolvable().id() << 32) | installer.satSolvable().id() ).second ) {
+		// no initial installation if it has been set be e.g. user
+		isInstalledBy.add( installed, installer, cap, kind, status.isBySolver() && !alreadySetForInstallation );
+		installs.add( installer, installed, cap, kind, !alreadySetForInstallation );
+		installedBy.insert( installed.satSolvable().id() );
+	    }
+
+	    if ( status.staysInstalled() ) { // Is already satisfied by an item which is installed
+		satifiedByInstalled.add( installer, installed, cap, kind, kind == Dep::SUPPLEMENTS && !alreadySetForInstallation );
+		installedSatisfied.add( installed, installer, cap, kind, false );
+	    }
+	}
+
+	ItemCapKindIndex & isInstalledBy;
+	ItemCapKindIndex & installs;
+	ItemCapKindIndex & satifiedByInstalled;
+	ItemCapKindIndex & installedSatisfied;
+	std::tr1::unordered_set<sat::detail::SolvableIdType> installedBy;	// keys in isInstalledBy
+	std::tr1::unordered_set<unsigned long long> relations;		// (key,item) in isInstalledBy
+    };
+} // namespace
+
 void Resolver::collectResolverInfo()
 {
     if ( _satResolver
@@ -391,221 +467,136 @@ void Resolver::collectResolverInfo()
 	 && _installs.empty()) {
 
 	// generating new
+	unsigned long long start = SolverStatistics::now();
+	ResolverInfoCollector collect( _isInstalledBy, _installs, _satifiedByInstalled, _installedSatisfied );
 	PoolItemList itemsToInstall = _satResolver->resultItemsToInstall();
 
-	for (PoolItemList::const_iterator instIter = itemsToInstall.begin();
-	     instIter != itemsToInstall.end(); instIter++) {
+	for_( instIter, itemsToInstall.begin(), itemsToInstall.end() ) {
 	    // Requires
-	    for (Capabilities::const_iterator capIt = (*instIter)->dep (Dep::REQUIRES).begin(); capIt != (*instIter)->dep (Dep::REQUIRES).end(); ++capIt)
-	    {
-		sat::WhatProvides possibleProviders(*capIt);
-		for_( iter, possibleProviders.begin(), possibleProviders.end() ) {
-		    PoolItem provider = ResPool::instance().find( *iter );
-
-		    // searching if this provider will already be installed
-		    bool found = false;
-		    bool alreadySetForInstallation = false;
-		    ItemCapKindMap::const_iterator pos = _isInstalledBy.find(provider);
-		    while (pos != _isInstalledBy.end()
-			   && pos->first == provider
-			   && !found) {
-			alreadySetForInstallation = true;
-			ItemCapKind capKind = pos->second;
-			if (capKind.item == *instIter)  found = true;
-			pos++;
-		    }
-
-		    if (!found
-			&& provider.status().isToBeInstalled()) {
-			if (provider.status().isBySolver()) {
-			    ItemCapKind capKindisInstalledBy( *instIter, *capIt, Dep::REQUIRES, !alreadySetForInstallation );
-			    _isInstalledBy.insert (make_pair( provider, capKindisInstalledBy));
-			} else {
-			    // no initial installation cause it has been set be e.g. user
-			    ItemCapKind capKindisInstalledBy( *instIter, *capIt, Dep::REQUIRES, false );
-			    _isInstalledBy.insert (make_pair( provider, capKindisInstalledBy));
-			}
-			ItemCapKind capKindisInstalledBy( provider, *capIt, Dep::REQUIRES, !alreadySetForInstallation );
-			_installs.insert (make_pair( *instIter, capKindisInstalledBy));
-		    }
-
-		    if (provider.status().staysInstalled()) { // Is already satisfied by an item which is installed
-			ItemCapKind capKindisInstalledBy( provider, *capIt, Dep::REQUIRES, false );
-			_satifiedByInstalled.insert (make_pair( *instIter, capKindisInstalledBy));
-
-			ItemCapKind installedSatisfied( *instIter, *capIt, Dep::REQUIRES, false );
-			_installedSatisfied.insert (make_pair( provider, installedSatisfied));
-		    }
-		}
+	    Capabilities requires( (*instIter)->dep( Dep::REQUIRES ) );
+	    for_( capIt, requires.begin(), requires.end() ) {
+		sat::WhatProvides possibleProviders( *capIt );
+		for_( iter, possibleProviders.begin(), possibleProviders.end() )
+		    collect( *instIter, PoolItem( *iter ), *capIt, Dep::REQUIRES );
 	    }
 
 	    if (!(_satResolver->onlyRequires())) {
 		//Recommends
-		for (Capabilities::const_iterator capIt = (*instIter)->dep (Dep::RECOMMENDS).begin(); capIt != (*instIter)->dep (Dep::RECOMMENDS).end(); ++capIt)
-		{
-		    sat::WhatProvides possibleProviders(*capIt);
-		    for_( iter, possibleProviders.begin(), possibleProviders.end() ) {
-			PoolItem provider = ResPool::instance().find( *iter );
-
-			// searching if this provider will already be installed
-			bool found = false;
-			bool alreadySetForInstallation = false;
-			ItemCapKindMap::const_iterator pos = _isInstalledBy.find(provider);
-			while (pos != _isInstalledBy.end()
-			       && pos->first == provider
-			       && !found) {
-			    alreadySetForInstallation = true;
-			    ItemCapKind capKind = pos->second;
-			    if (capKind.item == *instIter)  found = true;
-			    pos++;
-			}
-
-			if (!found
-			    && provider.status().isToBeInstalled()) {
-			    if (provider.status().isBySolver()) {
-				ItemCapKind capKindisInstalledBy( *instIter, *capIt, Dep::RECOMMENDS, !alreadySetForInstallation );
-				_isInstalledBy.insert (make_pair( provider, capKindisInstalledBy));
-			    } else {
-				// no initial installation cause it has been set be e.g. user
-				ItemCapKind capKindisInstalledBy( *instIter, *capIt, Dep::RECOMMENDS, false );
-				_isInstalledBy.insert (make_pair( provider, capKindisInstalledBy));
-			    }
-			    ItemCapKind capKindisInstalledBy( provider, *capIt, Dep::RECOMMENDS, !alreadySetForInstallation );
-			    _installs.insert (make_pair( *instIter, capKindisInstalledBy));
-			}
-
-			if (provider.status().staysInstalled()) { // Is already satisfied by an item which is installed
-			    ItemCapKind capKindisInstalledBy( provider, *capIt, Dep::RECOMMENDS, false );
-			    _satifiedByInstalled.insert (make_pair( *instIter, capKindisInstalledBy));
-
-			    ItemCapKind installedSatisfied( *instIter, *capIt, Dep::RECOMMENDS, false );
-			    _installedSatisfied.insert (make_pair( provider, installedSatisfied));
-			}
-		    }
+		Capabilities recommends( (*instIter)->dep( Dep::RECOMMENDS ) );
+		for_( capIt, recommends.begin(), recommends.end() ) {
+		    sat::WhatProvides possibleProviders( *capIt );
+		    for_( iter, possibleProviders.begin(), possibleProviders.end() )
+			collect( *instIter, PoolItem( *iter ), *capIt, Dep::RECOMMENDS );
 		}
 
 		//Supplements
-		for (Capabilities::const_iterator capIt = (*instIter)->dep (Dep::SUPPLEMENTS).begin(); capIt != (*instIter)->dep (Dep::SUPPLEMENTS).end(); ++capIt)
-		{
-		    sat::WhatProvides possibleProviders(*capIt);
-		    for_( iter, possibleProviders.begin(), possibleProviders.end() ) {
-			PoolItem provider = ResPool::instance().find( *iter );
-			// searching if this item will already be installed
-			bool found = false;
-			bool alreadySetForInstallation = false;
-			ItemCapKindMap::const_iterator pos = _isInstalledBy.find(*instIter);
-			while (pos != _isInstalledBy.end()
-			       && pos->first == *instIter
-			       && !found) {
-			    alreadySetForInstallation = true;
-			    ItemCapKind capKind = pos->second;
-			    if (capKind.item == provider)  found = true;
-			    pos++;
-			}
-
-			if (!found
-			    && instIter->status().isToBeInstalled()) {
-			    if (instIter->status().isBySolver()) {
-				ItemCapKind capKindisInstalledBy( provider, *capIt, Dep::SUPPLEMENTS, !alreadySetForInstallation );
-				_isInstalledBy.insert (make_pair( *instIter, capKindisInstalledBy));
-			    } else {
-				// no initial installation cause it has been set be e.g. user
-				ItemCapKind capKindisInstalledBy( provider, *capIt, Dep::SUPPLEMENTS, false );
-				_isInstalledBy.insert (make_pair( *instIter, capKindisInstalledBy));
-			    }
-			    ItemCapKind capKindisInstalledBy( *instIter, *capIt, Dep::SUPPLEMENTS, !alreadySetForInstallation );
-			    _installs.insert (make_pair( provider, capKindisInstalledBy));
-			}
-
-			if (instIter->status().staysInstalled()) { // Is already satisfied by an item which is installed
-			    ItemCapKind capKindisInstalledBy( *instIter, *capIt, Dep::SUPPLEMENTS, !alreadySetForInstallation );
-			    _satifiedByInstalled.insert (make_pair( provider, capKindisInstalledBy));
-
-			    ItemCapKind installedSatisfied( provider, *capIt, Dep::SUPPLEMENTS, false );
-			    _installedSatisfied.insert (make_pair( *instIter, installedSatisfied));
-			}
-		    }
+		Capabilities supplements( (*instIter)->dep( Dep::SUPPLEMENTS ) );
+		for_( capIt, supplements.begin(), supplements.end() ) {
+		    sat::WhatProvides possibleProviders( *capIt );
+		    for_( iter, possibleProviders.begin(), possibleProviders.end() )
+			collect( PoolItem( *iter ), *instIter, *capIt, Dep::SUPPLEMENTS );
 		}
-   	    }
+	    }
 	}
+
+	_isInstalledBy.sort();
+	_installs.sort();
+	_satifiedByInstalled.sort();
+	_installedSatisfied.sort();
+	_satResolver->addResolverInfoTime( SolverStatistics::now() - start );
+	MIL << "Collected resolver info of " << itemsToInstall.size() << " items" << endl;
     }
 }
 
 
 ItemCapKindList Resolver::isInstalledBy( const PoolItem & item )
 {
-    ItemCapKindList ret;
     collectResolverInfo();
-
-    for (ItemCapKindMap::const_iterator iter = _isInstalledBy.find(item); iter != _isInstalledBy.end();) {
-	ItemCapKind info = iter->second;
-	PoolItem iterItem = iter->first;
-	if (iterItem == item) {
-	    ret.push_back(info);
-	    iter++;
-	} else {
-	    // exit
-	    iter = _isInstalledBy.end();
-	}
-    }
-    return ret;
+    return _isInstalledBy.find( item );
 }
 
 ItemCapKindList Resolver::installs( const PoolItem & item )
 {
-    ItemCapKindList ret;
     collectResolverInfo();
-
-    for (ItemCapKindMap::const_iterator iter = _installs.find(item); iter != _installs.end();) {
-	ItemCapKind info = iter->second;
-	PoolItem iterItem = iter->first;
-	if (iterItem == item) {
-	    ret.push_back(info);
-	    iter++;
-	} else {
-	    // exit
-	    iter = _installs.end();
-	}
-    }
-    return ret;
+    return _installs.find( item );
 }
 
 ItemCapKindList Resolver::satifiedByInstalled( const PoolItem & item )
 {
-    ItemCapKindList ret;
     collectResolverInfo();
-
-    for (ItemCapKindMap::const_iterator iter = _satifiedByInstalled.find(item); iter != _satifiedByInstalled.end();) {
-	ItemCapKind info = iter->second;
-	PoolItem iterItem = iter->first;
-	if (iterItem == item) {
-	    ret.push_back(info);
-	    iter++;
-	} else {
-	    // exit
-	    iter = _satifiedByInstalled.end();
-	}
-    }
-    return ret;
+    return _satifiedByInstalled.find( item );
 }
 
 ItemCapKindList Resolver::installedSatisfied( const PoolItem & item )
 {
-    ItemCapKindList ret;
     collectResolverInfo();
+    return _installedSatisfied.find( item );
+}
 
-    for (ItemCapKindMap::const_iterator iter = _installedSatisfied.find(item); iter != _installedSatisfied.end();) {
-	ItemCapKind info = iter->second;
-	PoolItem iterItem = iter->first;
-	if (iterItem == item) {
-	    ret.push_back(info);
-	    iter++;
-	} else {
-	    // exit
-	    iter = _installedSatisfied.end();
-	}
-    }
-    return ret;
+WhatIfResultList Resolver::whatIfInstall( const PoolItemList & items, unsigned workers )
+{
+    solverInit();
+    return _satResolver->whatIfInstall( items, workers );
+}
+
+SolverStatistics Resolver::solverStatistics() const
+{ return _satResolver ? _satResolver->statistics() : SolverStatistics(); }
+
+//---------------------------------------------------------------------------
+// SolverStatistics
+
+unsigned long long SolverStatistics::now()
+{
+    struct timespec ts;
+    ::clock_gettime( CLOCK_MONOTONIC, &ts );
+    return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+std::string SolverStatistics::asJson() const
+{
+    std::ostringstream str;
+    str << "{\"date\":" << Date::now().asSeconds()
+	<< ",\"distupgrade\":" << ( distupgrade ? "true" : "false" )
+	<< ",\"solved\":" << ( solved ? "true" : "false" )
+	<< ",\"jobs\":" << jobs
+	<< ",\"rules\":{\"total\":" << rules
+	<< ",\"pkg\":" << pkgRules
+	<< ",\"update\":" << updateRules
+	<< ",\"feature\":" << featureRules
+	<< ",\"job\":" << jobRules
+	<< ",\"distupgrade\":" << distupgradeRules
+	<< ",\"infarch\":" << infarchRules
+	<< ",\"choice\":" << choiceRules
+	<< ",\"learnt\":" << learntRules
+	<< ",\"other\":" << otherRules << "}"
+	<< ",\"decisions\":" << decisions
+	<< ",\"problems\":" << problems
+	<< ",\"time_us\":{\"solve\":" << solveTime
+	<< ",\"result\":" << resultTime << "}}";
+    return str.str();
+}
+
+std::ostream & operator<<( std::ostream & str, const SolverStatistics & obj )
+{
+    if ( ! obj.valid )
+	return str << "SolverStatistics{}";
+    return str << "SolverStatistics{" << ( obj.solved ? "solved" : "unsolved" )
+	       << " jobs " << obj.jobs
+	       << ", rules " << obj.rules
+	       << " (pkg " << obj.pkgRules
+	       << ", update " << obj.updateRules
+	       << ", feature " << obj.featureRules
+	       << ", job " << obj.jobRules
+	       << ", dup " << obj.distupgradeRules
+	       << ", infarch " << obj.infarchRules
+	       << ", choice " << obj.choiceRules
+	       << ", learnt " << obj.learntRules
+	       << ", other " << obj.otherRules
+	       << "), decisions " << obj.decisions
+	       << ", problems " << obj.problems
+	       << ", solve " << obj.solveTime / 1000 << "ms"
+	       << ", result " << obj.resultTime / 1000 << "ms"
+	       << ", resolverinfo " << obj.resolverInfoTime / 1000 << "ms}";
 }
 
 
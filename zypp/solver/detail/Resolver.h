@@ -25,6 +25,7 @@
 #include <iosfwd>
 #include <list>
 #include <map>
+#include <vector>
 #include <string>
 
 #include "zypp/base/ReferenceCounted.h"
@@ -87,6 +88,120 @@ namespace zypp
     typedef std::multimap<PoolItem,ItemCapKind> ItemCapKindMap;
     typedef std::list<ItemCapKind> ItemCapKindList;
 
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : ItemCapKindIndex
+    //
+    /** Compact multimap PoolItem -> ItemCapKind.
+     * Entries are stored as plain ids in one array, which is sorted by
+     * key (keeping the order of equal keys) once all entries are \ref add ed.
+     * \ref find looks up a key by binary search and creates the
+     * \ref ItemCapKind on demand.
+     */
+    class ItemCapKindIndex
+    {
+      public:
+	void add( const PoolItem & key, const PoolItem & item, Capability cap, Dep kind, bool initial );
+	/** Prepare for \ref find after all entries were added. */
+	void sort();
+
+	ItemCapKindList find( const PoolItem & key ) const;
+
+	bool empty() const		{ return _entries.empty(); }
+	void clear()			{ _entries.clear(); }
+
+      private:
+	struct Entry
+	{
+	    Entry( sat::detail::SolvableIdType key_r, sat::detail::SolvableIdType item_r, sat::detail::IdType cap_r, Dep kind_r, bool initial_r )
+		: key( key_r ), item( item_r ), cap( cap_r ), kind( kind_r ), initial( initial_r )
+	    {}
+	    bool operator<( const Entry & rhs ) const	{ return key < rhs.key; }
+
+	    sat::detail::SolvableIdType key;
+	    sat::detail::SolvableIdType item;
+	    sat::detail::IdType cap;
+	    Dep kind;
+	    bool initial;
+	};
+	std::vector<Entry> _entries;
+    };
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : WhatIfResult
+    //
+    /** What installing \c item on top of the system would do.
+     * \see \ref Resolver::whatIfInstall
+     */
+    struct WhatIfResult
+    {
+	WhatIfResult() : solved( false ) {}
+
+	PoolItem item;				// Item asked to install
+	bool solved;				// Whether the solver found a solution
+	PoolItemList toInstall;			// Items the solution installs (incl. item)
+	PoolItemList toRemove;			// Installed items the solution removes
+	std::list<std::string> problems;	// Problem descriptions if not solved
+    };
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : SolverStatistics
+    //
+    /** Statistics of the last solver run.
+     *
+     * Rules are counted by the libsolv rule class. Times are in
+     * microseconds. \c resolverInfoTime is added lazily, when the
+     * information for \ref Resolver::isInstalledBy and friends is
+     * first collected after the run.
+     *
+     * \see \ref Resolver::solverStatistics
+     */
+    struct SolverStatistics
+    {
+	SolverStatistics()
+	: valid( false ), distupgrade( false ), solved( false )
+	, jobs( 0 ), rules( 0 ), pkgRules( 0 ), updateRules( 0 ), featureRules( 0 ), jobRules( 0 )
+	, distupgradeRules( 0 ), infarchRules( 0 ), choiceRules( 0 ), learntRules( 0 ), otherRules( 0 )
+	, decisions( 0 ), problems( 0 )
+	, solveTime( 0 ), resultTime( 0 ), resolverInfoTime( 0 )
+	{}
+
+	bool valid;				// Whether a solver run was done
+	bool distupgrade;			// Whether it was a dist upgrade
+	bool solved;				// Whether the solver found a solution
+
+	unsigned jobs;				// Jobs passed to the solver
+	unsigned rules;				// Rules of all classes:
+	unsigned pkgRules;			//   from package dependencies
+	unsigned updateRules;			//   keeping or updating installed packages
+	unsigned featureRules;			//   allowing updates ignoring the policy
+	unsigned jobRules;			//   from the jobs (installs, removes, locks)
+	unsigned distupgradeRules;		//   for dist upgrade
+	unsigned infarchRules;			//   preventing inferior architectures
+	unsigned choiceRules;			//   weakening package rules
+	unsigned learntRules;			//   learnt from conflicts
+	unsigned otherRules;			//   any other class
+	unsigned decisions;			// Decisions in the final solution
+	unsigned problems;			// Problems reported
+
+	unsigned long long solveTime;		// Time spent in solver_solve
+	unsigned long long resultTime;		// Time copying the result back to the pool
+	unsigned long long resolverInfoTime;	// Time spent in collectResolverInfo
+
+	/** The statistics as a single line JSON object.
+	 * It is written right after the run, so \c resolverInfoTime is not included.
+	 */
+	std::string asJson() const;
+
+	/** Monotonic clock in microseconds, used for the times. */
+	static unsigned long long now();
+    };
+
+    /** \relates SolverStatistics Stream output */
+    std::ostream & operator<<( std::ostream & str, const SolverStatistics & obj );
+
 
 ///////////////////////////////////////////////////////////////////
 //
@@ -136,10 +251,10 @@ class Resolver : public base::ReferenceCounted, private base::NonCopyable {
     solver::detail::SolverQueueItemList _added_queue_items;
 
     // Additional information about the solverrun
-    ItemCapKindMap _isInstalledBy;
-    ItemCapKindMap _installs;
-    ItemCapKindMap _satifiedByInstalled;
-    ItemCapKindMap _installedSatisfied;
+    ItemCapKindIndex _isInstalledBy;
+    ItemCapKindIndex _installs;
+    ItemCapKindIndex _satifiedByInstalled;
+    ItemCapKindIndex _installedSatisfied;
 
     // helpers
     void collectResolverInfo();
@@ -242,6 +357,12 @@ class Resolver : public base::ReferenceCounted, private base::NonCopyable {
     ItemCapKindList satifiedByInstalled (const PoolItem & item );
     ItemCapKindList installedSatisfied( const PoolItem & item );
 
+    // Solve installing each of items separately, without touching the pool
+    WhatIfResultList whatIfInstall( const PoolItemList & items, unsigned workers );
+
+    // Statistics of the last solver run
+    SolverStatistics solverStatistics() const;
+
 };
 
 ///////////////////////////////////////////////////////////////////
@@ -29,6 +29,13 @@ extern "C"
 #include <solv/queue.h>
 }
 
+#include <unistd.h>
+#include <sys/wait.h>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
 #include "zypp/solver/detail/Helper.h"
 #include "zypp/base/String.h"
 #include "zypp/Product.h"
@@ -39,6 +46,9 @@ extern "C"
 #include "zypp/base/String.h"
 #include "zypp/base/Gettext.h"
 #include "zypp/base/Algorithm.h"
+#include "zypp/base/Trace.h"
+#include "zypp/base/DtorReset.h"
+#include "zypp/TmpPath.h"
 #include "zypp/ResPool.h"
 #include "zypp/ResFilters.h"
 #include "zypp/ZConfig.h"
@@ -46,6 +56,7 @@ extern "C"
 #include "zypp/sat/WhatProvides.h"
 #include "zypp/sat/WhatObsoletes.h"
 #include "zypp/solver/detail/SATResolver.h"
+#include "zypp/solver/detail/Resolver.h"
 #include "zypp/solver/detail/ProblemSolutionCombi.h"
 #include "zypp/solver/detail/ProblemSolutionIgnore.h"
 #include "zypp/solver/detail/SolverQueueItemInstall.h"
@@ -417,6 +428,18 @@ class CollectPseudoInstalled : public resfilter::PoolItemFilterFunctor
     }
 };
 
+void SATResolver::setSolverFlags( Solver * solv )
+{
+    solver_set_flag(solv, SOLVER_FLAG_ADD_ALREADY_RECOMMENDED, !_ignorealreadyrecommended);
+    solver_set_flag(solv, SOLVER_FLAG_ALLOW_DOWNGRADE, _allowdowngrade);
+    solver_set_flag(solv, SOLVER_FLAG_ALLOW_UNINSTALL, _allowuninstall);
+    solver_set_flag(solv, SOLVER_FLAG_ALLOW_ARCHCHANGE, _allowarchchange);
+    solver_set_flag(solv, SOLVER_FLAG_ALLOW_VENDORCHANGE, _allowvendorchange);
+    solver_set_flag(solv, SOLVER_FLAG_SPLITPROVIDES, _dosplitprovides);
+    solver_set_flag(solv, SOLVER_FLAG_NO_UPDATEPROVIDE, _noupdateprovide);
+    solver_set_flag(solv, SOLVER_FLAG_IGNORE_RECOMMENDED, _onlyRequires);
+}
+
 bool
 SATResolver::solving(const CapabilitySet & requires_caps,
 		     const CapabilitySet & conflict_caps)
@@ -439,22 +462,24 @@ SATResolver::solving(const CapabilitySet & requires_caps,
 	queue_push( &(_jobQueue), SOLVER_DROP_ORPHANED|SOLVER_SOLVABLE_ALL);
 	queue_push( &(_jobQueue), 0 );
     }
-    solver_set_flag(_solv, SOLVER_FLAG_ADD_ALREADY_RECOMMENDED, !_ignorealreadyrecommended);
-    solver_set_flag(_solv, SOLVER_FLAG_ALLOW_DOWNGRADE, _allowdowngrade);
-    solver_set_flag(_solv, SOLVER_FLAG_ALLOW_UNINSTALL, _allowuninstall);
-    solver_set_flag(_solv, SOLVER_FLAG_ALLOW_ARCHCHANGE, _allowarchchange);
-    solver_set_flag(_solv, SOLVER_FLAG_ALLOW_VENDORCHANGE, _allowvendorchange);
-    solver_set_flag(_solv, SOLVER_FLAG_SPLITPROVIDES, _dosplitprovides);
-    solver_set_flag(_solv, SOLVER_FLAG_NO_UPDATEPROVIDE, _noupdateprovide);
-    solver_set_flag(_solv, SOLVER_FLAG_IGNORE_RECOMMENDED, _onlyRequires);
+    setSolverFlags( _solv );
 
     sat::Pool::instance().prepareForSolving();
 
     // Solve !
     MIL << "Starting solving...." << endl;
     MIL << *this;
-    solver_solve( _solv, &(_jobQueue) );
+    {
+      debug::TraceSpan span( "SATResolver::solving", "solver" );
+      span.attr( "jobs", (long long)_jobQueue.count );
+      unsigned long long start = SolverStatistics::now();
+      solver_solve( _solv, &(_jobQueue) );
+      collectStatistics( SolverStatistics::now() - start );
+      span.attr( "rules", (long long)_statistics.rules );
+      span.attr( "decisions", (long long)_statistics.decisions );
+    }
     MIL << "....Solver end" << endl;
+    unsigned long long resultStart = SolverStatistics::now();
 
     // copying solution back to zypp pool
     //-----------------------------------------
@@ -617,7 +642,9 @@ SATResolver::solving(const CapabilitySet & requires_caps,
 	}
     }
 
-    if (solver_problem_count(_solv) > 0 )
+    writeStatistics( SolverStatistics::now() - resultStart );
+
+    if ( _statistics.problems > 0 )
     {
 	ERR << "Solverrun finished with an ERROR" << endl;
 	return false;
@@ -626,6 +653,58 @@ SATResolver::solving(const CapabilitySet & requires_caps,
     return true;
 }
 
+void
+SATResolver::collectStatistics( unsigned long long solveTime )
+{
+    _statistics = SolverStatistics();
+    _statistics.valid = true;
+    _statistics.distupgrade = _distupgrade;
+    _statistics.jobs = _jobQueue.count / 2;
+    _statistics.solveTime = solveTime;
+
+    // Rules are numbered consecutively starting at 1. Some rule ranges
+    // may contain rules solver_ruleclass reports as SOLVER_RULE_UNKNOWN.
+    for ( Id rid = 1; rid < _solv->nrules; ++rid )
+    {
+	SolverRuleinfo ruleclass = solver_ruleclass( _solv, rid );
+	++_statistics.rules;
+	switch ( ruleclass )
+	{
+	    case SOLVER_RULE_RPM:		++_statistics.pkgRules;		break;
+	    case SOLVER_RULE_UPDATE:		++_statistics.updateRules;	break;
+	    case SOLVER_RULE_FEATURE:		++_statistics.featureRules;	break;
+	    case SOLVER_RULE_JOB:		++_statistics.jobRules;		break;
+	    case SOLVER_RULE_DISTUPGRADE:	++_statistics.distupgradeRules;	break;
+	    case SOLVER_RULE_INFARCH:		++_statistics.infarchRules;	break;
+	    case SOLVER_RULE_CHOICE:		++_statistics.choiceRules;	break;
+	    case SOLVER_RULE_LEARNT:		++_statistics.learntRules;	break;
+	    default:				++_statistics.otherRules;	break;
+	}
+    }
+    Queue decisionq;
+    queue_init(&decisionq);
+    solver_get_decisionqueue(_solv, &decisionq);
+    _statistics.decisions = decisionq.count;
+    queue_free(&decisionq);
+    _statistics.problems = solver_problem_count( _solv );
+    _statistics.solved = ( _statistics.problems == 0 );
+}
+
+void
+SATResolver::writeStatistics( unsigned long long resultTime )
+{
+    _statistics.resultTime = resultTime;
+    MIL << _statistics << endl;
+
+    Pathname file( ZConfig::instance().solver_statisticsFile() );
+    if ( file.empty() )
+	return;
+    std::ofstream out( file.c_str(), std::ios_base::app );
+    out << _statistics.asJson() << endl;
+    if ( ! out )
+	WAR << "Can't append solver statistics to " << file << endl;
+}
+
 
 void
 SATResolver::solverInit(const PoolItemList & weakItems)
@@ -862,22 +941,18 @@ void SATResolver::doUpdate()
 	queue_push( &(_jobQueue), SOLVER_DROP_ORPHANED|SOLVER_SOLVABLE_ALL);
 	queue_push( &(_jobQueue), 0 );
     }
-    solver_set_flag(_solv, SOLVER_FLAG_ADD_ALREADY_RECOMMENDED, !_ignorealreadyrecommended);
-    solver_set_flag(_solv, SOLVER_FLAG_ALLOW_DOWNGRADE, _allowdowngrade);
-    solver_set_flag(_solv, SOLVER_FLAG_ALLOW_UNINSTALL, _allowuninstall);
-    solver_set_flag(_solv, SOLVER_FLAG_ALLOW_ARCHCHANGE, _allowarchchange);
-    solver_set_flag(_solv, SOLVER_FLAG_ALLOW_VENDORCHANGE, _allowvendorchange);
-    solver_set_flag(_solv, SOLVER_FLAG_SPLITPROVIDES, _dosplitprovides);
-    solver_set_flag(_solv, SOLVER_FLAG_NO_UPDATEPROVIDE, _noupdateprovide);
-    solver_set_flag(_solv, SOLVER_FLAG_IGNORE_RECOMMENDED, _onlyRequires);
+    setSolverFlags( _solv );
 
     sat::Pool::instance().prepareForSolving();
 
     // Solve !
     MIL << "Starting solving for update...." << endl;
     MIL << *this;
+    unsigned long long start = SolverStatistics::now();
     solver_solve( _solv, &(_jobQueue) );
+    collectStatistics( SolverStatistics::now() - start );
     MIL << "....Solver end" << endl;
+    unsigned long long resultStart = SolverStatistics::now();
 
     // copying solution back to zypp pool
     //-----------------------------------------
@@ -928,6 +1003,7 @@ void SATResolver::doUpdate()
 	  ERR << "id " << i << " not found in ZYPP pool." << endl;
       }
     }
+    writeStatistics( SolverStatistics::now() - resultStart );
     MIL << "SATResolver::doUpdate() done" << endl;
 }
 
@@ -961,6 +1037,232 @@ struct FindPackage : public resfilter::ResObjectFilterFunctor
 };
 
 
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+// what-if solving
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+// A worker reports its results one fact per line, closed by 'end'.
+static void writeWhatIfResult( std::ostream & str, unsigned idx, const WhatIfResult & result )
+{
+    str << "item " << idx << " " << result.solved << endl;
+    for_( it, result.toInstall.begin(), result.toInstall.end() )
+	str << "install " << it->satSolvable().id() << endl;
+    for_( it, result.toRemove.begin(), result.toRemove.end() )
+	str << "remove " << it->satSolvable().id() << endl;
+    for_( it, result.problems.begin(), result.problems.end() )
+	str << "problem " << str::gsub( *it, "\n", "\\n" ) << endl;
+}
+
+// Read a workers results into results (by index); false unless complete.
+static bool readWhatIfResults( const Pathname & file, WhatIfResultList & results )
+{
+    std::ifstream infile( file.c_str() );
+    WhatIfResult * current = 0;
+    for( std::string line; std::getline( infile, line ); )
+    {
+	std::string::size_type sep( line.find( ' ' ) );
+	std::string key( line.substr( 0, sep ) );
+	std::string val( sep == std::string::npos ? std::string() : line.substr( sep+1 ) );
+	if ( key == "end" )
+	    return true;
+	if ( key == "item" )
+	{
+	    std::istringstream l( val );
+	    unsigned idx = 0;
+	    bool solved = false;
+	    if ( ! ( l >> idx >> solved ) || idx >= results.size() )
+		break;
+	    current = &results[idx];
+	    current->solved = solved;
+	}
+	else if ( ! current )
+	    break;
+	else if ( key == "install" )
+	    current->toInstall.push_back( PoolItem( sat::Solvable( str::strtonum<sat::detail::SolvableIdType>( val ) ) ) );
+	else if ( key == "remove" )
+	    current->toRemove.push_back( PoolItem( sat::Solvable( str::strtonum<sat::detail::SolvableIdType>( val ) ) ) );
+	else if ( key == "problem" )
+	    current->problems.push_back( str::gsub( val, "\\n", "\n" ) );
+	else
+	    break;
+    }
+    WAR << "Incomplete what-if results in " << file << endl;
+    return false;
+}
+
+WhatIfResult SATResolver::whatIfSolve( const Queue & basejobs, const PoolItem & item )
+{
+    WhatIfResult ret;
+    ret.item = item;
+
+    Queue job;
+    queue_init( &job );
+    for ( int i = 0; i < basejobs.count; ++i )
+	queue_push( &job, basejobs.elements[i] );
+    queue_push( &job, SOLVER_INSTALL | SOLVER_SOLVABLE );
+    queue_push( &job, item.satSolvable().id() );
+
+    Solver * solv = solver_create( _SATPool );
+    setSolverFlags( solv );
+    solver_solve( solv, &job );
+
+    if ( solver_problem_count( solv ) > 0 )
+    {
+	// SATprobleminfoString reports about _solv
+	DtorReset resetSolv( _solv );
+	_solv = solv;
+	for ( Id problem = solver_next_problem( solv, 0 ); problem != 0; problem = solver_next_problem( solv, problem ) )
+	{
+	    string detail;
+	    Id ignoreId;
+	    string what( SATprobleminfoString( problem, detail, ignoreId ) );
+	    ret.problems.push_back( detail.empty() ? what : what + "\n" + detail );
+	}
+    }
+    else
+    {
+	ret.solved = true;
+
+	Queue decisionq;
+	queue_init( &decisionq );
+	solver_get_decisionqueue( solv, &decisionq );
+	for ( int i = 0; i < decisionq.count; ++i )
+	{
+	    sat::Solvable slv( decisionq.elements[i] );
+	    if ( !slv || slv.isSystem() || slv.repository().isSystemRepo() )
+		continue;
+	    ret.toInstall.push_back( PoolItem( slv ) );
+	}
+	queue_free( &decisionq );
+
+	Repository systemRepo( sat::Pool::instance().findSystemRepo() ); // don't create if it does not exist
+	if ( systemRepo )
+	{
+	    for_( it, systemRepo.solvablesBegin(), systemRepo.solvablesEnd() )
+	    {
+		if ( solver_get_decisionlevel( solv, it->id() ) < 0 )	// 0: undecided, i.e. kept
+		    ret.toRemove.push_back( PoolItem( *it ) );
+	    }
+	}
+    }
+
+    solver_free( solv );
+    queue_free( &job );
+    return ret;
+}
+
+WhatIfResultList SATResolver::whatIfInstall( const PoolItemList & items, unsigned workers )
+{
+    WhatIfResultList ret( items.size() );
+    {
+	unsigned idx = 0;
+	for_( it, items.begin(), items.end() )
+	    ret[idx++].item = *it;
+    }
+    if ( ret.empty() )
+	return ret;
+
+    debug::TraceSpan span( "SATResolver::whatIfInstall", "solver" );
+    span.attr( "jobs", (long long)ret.size() );
+
+    ::pool_set_custom_vendorcheck( _SATPool, &vendorCheck );
+    sat::Pool::instance().prepareForSolving();
+
+    // Jobs common to all items: parallel installable names and the
+    // locks as found in the pool. Other transactions are ignored.
+    Queue basejobs;
+    queue_init( &basejobs );
+    for_( it, sat::Pool::instance().multiversionBegin(), sat::Pool::instance().multiversionEnd() )
+    {
+	queue_push( &basejobs, SOLVER_NOOBSOLETES | SOLVER_SOLVABLE_NAME );
+	queue_push( &basejobs, it->id() );
+    }
+    for_( it, _pool.begin(), _pool.end() )
+    {
+	const ResStatus & status( it->status() );
+	if ( ! status.isLocked() || status.isBySolver() || status.isByApplLow() )
+	    continue;
+	queue_push( &basejobs, status.isInstalled() ? SOLVER_INSTALL | SOLVER_SOLVABLE
+						    : SOLVER_ERASE | SOLVER_SOLVABLE | MAYBE_CLEANDEPS );
+	queue_push( &basejobs, it->satSolvable().id() );
+    }
+
+    if ( ! workers )
+    {
+	long cpus = ::sysconf( _SC_NPROCESSORS_ONLN );
+	workers = cpus > 0 ? cpus : 1;
+    }
+    if ( workers > ret.size() )
+	workers = ret.size();
+    span.attr( "workers", (long long)workers );
+    MIL << "What-if solving " << ret.size() << " jobs in " << workers << " workers" << endl;
+
+    // Solvers can't share the pool within a process (solving extends the
+    // pool's provides cache), so workers are forked processes sharing the
+    // prepared pool copy-on-write. Worker w solves every workers'th item
+    // starting at w. Whatever a worker fails to deliver is solved here.
+    std::vector<bool> done( ret.size(), false );
+    if ( workers > 1 )
+    {
+	std::vector<filesystem::TmpFile> files;
+	std::vector<pid_t> pids;
+	for ( unsigned w = 0; w < workers; ++w )
+	{
+	    filesystem::TmpFile file;
+	    pid_t pid = file ? ::fork() : -1;
+	    if ( pid == 0 )
+	    {
+		int exitcode = 1;
+		try
+		{
+		    std::ofstream out( file.path().c_str() );
+		    for ( unsigned idx = w; idx < ret.size(); idx += workers )
+			writeWhatIfResult( out, idx, whatIfSolve( basejobs, ret[idx].item ) );
+		    out << "end" << endl;
+		    if ( out )
+			exitcode = 0;
+		}
+		catch ( ... )
+		{}
+		::_exit( exitcode );
+	    }
+	    if ( pid < 0 )
+	    {
+		WAR << "Can't fork what-if worker: " << ::strerror( errno ) << endl;
+		break;
+	    }
+	    files.push_back( file );
+	    pids.push_back( pid );
+	}
+
+	for ( unsigned w = 0; w < pids.size(); ++w )
+	{
+	    int status = 0;
+	    while ( ::waitpid( pids[w], &status, 0 ) == -1 && errno == EINTR )
+		;
+	    if ( WIFEXITED( status ) && WEXITSTATUS( status ) == 0 && readWhatIfResults( files[w].path(), ret ) )
+	    {
+		for ( unsigned idx = w; idx < ret.size(); idx += workers )
+		    done[idx] = true;
+	    }
+	    else
+		WAR << "What-if worker " << pids[w] << " failed (status " << status << ")" << endl;
+	}
+    }
+
+    for ( unsigned idx = 0; idx < ret.size(); ++idx )
+    {
+	if ( ! done[idx] )
+	    ret[idx] = whatIfSolve( basejobs, ret[idx].item );
+    }
+
+    queue_free( &basejobs );
+    return ret;
+}
+
+
 //----------------------------------------------------------------------------
 // Checking if this solvable/item has a buddy which reflect the real
 // user visible description of an item
@@ -42,6 +42,7 @@ extern "C"
 #include "zypp/ProblemSolution.h"
 #include "zypp/Capability.h"
 #include "zypp/solver/detail/SolverQueueItem.h"
+#include "zypp/solver/detail/Resolver.h"
 
 /////////////////////////////////////////////////////////////////////////
 namespace zypp
@@ -104,6 +105,9 @@ class SATResolver : public base::ReferenceCounted, private base::NonCopyable {
     bool _solveSrcPackages;		// false: generate no job rule for source packages selected in the pool
     bool _cleandepsOnRemove;		// whether removing a package should also remove no longer needed requirements
 
+    // statistics of the last solver run
+    SolverStatistics _statistics;
+
     // ---------------------------------- methods
     std::string SATprobleminfoString (Id problem, std::string &detail, Id &ignoreId);
     void resetItemTransaction (PoolItem item);
@@ -119,6 +123,14 @@ class SATResolver : public base::ReferenceCounted, private base::NonCopyable {
     void setLocks();
     // set requirements for a running system
     void setSystemRequirements();
+    // apply the solver options to solv
+    void setSolverFlags( Solver * solv );
+    // what-if job: install item on top of basejobs (see whatIfInstall)
+    WhatIfResult whatIfSolve( const Queue & basejobs, const PoolItem & item );
+    // fill _statistics after solver_solve took solveTime
+    void collectStatistics( unsigned long long solveTime );
+    // log _statistics and append them to ZConfig::solver_statisticsFile
+    void writeStatistics( unsigned long long resultTime );
 
    // Checking if this solvable/item has a buddy which reflect the real
    // user visible description of an item
@@ -155,6 +167,12 @@ class SATResolver : public base::ReferenceCounted, private base::NonCopyable {
 		      );
     // searching for new packages
     void doUpdate();
+    // solve installing each of items separately; the pool is not changed
+    WhatIfResultList whatIfInstall( const PoolItemList & items, unsigned workers );
+
+    // statistics of the last solver run
+    const SolverStatistics & statistics() const { return _statistics; }
+    void addResolverInfoTime( unsigned long long time ) { _statistics.resolverInfoTime += time; }
 
     ResolverProblemList problems ();
     void applySolutions (const ProblemSolutionList &solutions);
@@ -23,6 +23,7 @@
 
 #include <iosfwd>
 #include <list>
+#include <vector>
 #include <set>
 #include <map>
 #include <string>
@@ -50,6 +51,9 @@ namespace zypp
 
 typedef std::list<PoolItem> PoolItemList;
 typedef std::set<PoolItem> PoolItemSet;
+
+struct WhatIfResult;
+typedef std::vector<WhatIfResult> WhatIfResultList;
       
 DEFINE_PTR_TYPE(Resolver);
 
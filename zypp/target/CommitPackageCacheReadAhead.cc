@@ -146,7 +146,7 @@ namespace zypp
           return;
         }
 
-      // Get all files to cache from the Source and copy them to
+      // Get all files to cache from the Source and move them to
       // the cache.
       // NOTE: All files copied to the cache directory are stored in addToCache,
       // which is a local variable. If we throw on error, addToCache will be
@@ -157,7 +157,7 @@ namespace zypp
           // let the source provide the file
           ManagedFile fromSource( sourceProvidePackage( it->first ) );
 
-          // copy it to the cachedir
+          // move it to the cachedir
           std::string destName( str::form( "S%p_%u_%s",
                                            it->first->repository().id(),
                                            it->first->mediaNr(),
@@ -166,7 +166,16 @@ namespace zypp
           ManagedFile fileInCache( _cacheDir->path() / destName,
                                    filesystem::unlink );
 
-          if ( filesystem::copy( fromSource.value(), fileInCache ) != 0 )
+          // A file the source would delete anyway is renamed, otherwise
+          // hardlinked. Only if both fail across filesystems it is copied.
+          bool moved = false;
+          if ( fromSource.getDispose()
+               && filesystem::rename( fromSource.value(), fileInCache ) == 0 )
+            {
+              fromSource.resetDispose();
+              moved = true;
+            }
+          if ( ! moved && filesystem::hardlinkCopy( fromSource.value(), fileInCache ) != 0 )
             {
               // copy to cache failed.
               ERR << "Copy to cache failed on " << fromSource.value() << endl;
@@ -0,0 +1,251 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/target/SystemSolvUpdater.cc
+ *
+*/
+extern "C"
+{
+#include <solv/pool.h>
+#include <solv/repo.h>
+#include <solv/repodata.h>
+#include <solv/repo_solv.h>
+#include <solv/repo_write.h>
+#include <solv/repo_rpmdb.h>
+}
+#include <iostream>
+#include <set>
+
+#include "zypp/base/LogTools.h"
+#include "zypp/base/String.h"
+
+#include "zypp/AutoDispose.h"
+#include "zypp/Date.h"
+#include "zypp/PathInfo.h"
+#include "zypp/TmpPath.h"
+#include "zypp/target/rpm/librpmDb.h"
+
+#include "zypp/target/SystemSolvUpdater.h"
+
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace target
+  { /////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : SystemSolvUpdater::Impl
+    //
+    /** SystemSolvUpdater implementation. */
+    class SystemSolvUpdater::Impl : private base::NonCopyable
+    {
+      public:
+        Impl( const Pathname & solvfile_r )
+        : _solvfile( solvfile_r )
+        , _pool( ::pool_create() )
+        , _repo( 0 )
+        , _oldEnd( 0 )
+        , _installed( 0 )
+        {
+          AutoDispose<FILE*> file( ::fopen( _solvfile.c_str(), "re" ), ::fclose );
+          if ( file == NULL )
+          {
+            file.resetDispose();
+            WAR << "Can't open " << _solvfile << endl;
+            return;
+          }
+          _repo = ::repo_create( _pool, "@System" );
+          if ( ::repo_add_solv( _repo, file, 0 ) != 0 )
+          {
+            WAR << "Can't read " << _solvfile << endl;
+            _repo = 0;
+            return;
+          }
+          ::pool_set_installed( _pool, _repo );
+          _oldEnd = _repo->end;
+        }
+
+        ~Impl()
+        { ::pool_free( _pool ); }
+
+      public:
+        bool valid() const
+        { return _repo; }
+
+        void invalidate()
+        {
+          if ( _repo )
+          {
+            MIL << "Giving up updating " << _solvfile << endl;
+            _repo = 0;
+          }
+        }
+
+        void installed( const Pathname & rpm_r, sat::Solvable solv_r )
+        {
+          if ( ! _repo )
+            return;
+
+          // The package files header lacks what rpm adds on install,
+          // so look up the installed one for these.
+          rpm::librpmDb::db_const_iterator it;
+          for ( it.findByName( solv_r.name() ); *it; ++it )
+          {
+            if ( it->tag_edition() == solv_r.edition() && it->tag_arch() == solv_r.arch() )
+              break;
+          }
+          if ( ! *it )
+          {
+            WAR << "Can't find installed " << solv_r << " in the rpm database" << endl;
+            invalidate();
+            return;
+          }
+
+          Id p = ::repo_add_rpm( _repo, rpm_r.c_str(), REPO_REUSE_REPODATA|REPO_NO_INTERNALIZE|REPO_NO_LOCATION );
+          if ( ! p )
+          {
+            WAR << "Can't read header of " << rpm_r << endl;
+            invalidate();
+            return;
+          }
+          // Like rpmdb2solv: install time and database index, but no download size.
+          ::repodata_unset( ::repo_last_repodata( _repo ), p, SOLVABLE_DOWNLOADSIZE );
+          ::repo_set_num( _repo, p, SOLVABLE_INSTALLTIME, Date::ValueType( it->tag_installtime() ) );
+          ::repo_set_num( _repo, p, RPM_RPMDBID, it.dbHdrNum() );
+          // rpm replaced an already installed header of the same NEVRA
+          _erased.insert( nevra( solv_r ) );
+          ++_installed;
+        }
+
+        void removed( sat::Solvable solv_r )
+        {
+          if ( ! _repo )
+            return;
+          _erased.insert( nevra( solv_r ) );
+        }
+
+        bool write()
+        {
+          if ( ! _repo )
+            return false;
+
+          unsigned erased = 0;
+          for ( Id p = _repo->start; p < _oldEnd; ++p )
+          {
+            ::Solvable * s( _pool->solvables + p );
+            if ( s->repo != _repo )
+              continue;
+            if ( _erased.find( nevra( s ) ) != _erased.end() )
+            {
+              ::repo_free_solvable_block( _repo, p, 1, /*reuseids*/false );
+              ++erased;
+            }
+          }
+          ::repo_internalize( _repo );
+
+          filesystem::TmpFile tmp( filesystem::TmpFile::makeSibling( _solvfile ) );
+          if ( ! tmp )
+            return false;
+          {
+            AutoDispose<FILE*> file( ::fopen( tmp.path().c_str(), "we" ), ::fclose );
+            if ( file == NULL )
+            {
+              file.resetDispose();
+              return false;
+            }
+            if ( ::repo_write( _repo, file ) != 0 )
+              return false;
+            file.resetDispose();
+            if ( ::fclose( file ) != 0 )
+              return false;
+          }
+          if ( filesystem::rename( tmp.path(), _solvfile ) != 0 )
+            return false;
+          filesystem::chmod( _solvfile, 0644 );
+
+          MIL << "Updated " << _solvfile << ": " << _installed << " installed, " << erased << " removed" << endl;
+          return true;
+        }
+
+      private:
+        /** \c name-edition.arch in the sat pool. */
+        static std::string nevra( sat::Solvable solv_r )
+        { return str::form( "%s-%s.%s", solv_r.name().c_str(), solv_r.edition().c_str(), solv_r.arch().c_str() ); }
+
+        /** \c name-edition.arch in our pool. */
+        std::string nevra( ::Solvable * s ) const
+        {
+          return str::form( "%s-%s.%s", ::pool_id2str( _pool, s->name ), ::pool_id2str( _pool, s->evr ),
+                            s->arch ? ::pool_id2str( _pool, s->arch ) : "" );
+        }
+
+      public:
+        Pathname              _solvfile;
+        ::Pool *              _pool;
+        ::Repo *              _repo;
+        Id                    _oldEnd;	//!< solvables below were read from _solvfile
+        std::set<std::string> _erased;
+        unsigned              _installed;
+        RepoStatus            _rpmdbStatus;
+    };
+    ///////////////////////////////////////////////////////////////////
+
+    /** \relates SystemSolvUpdater::Impl Stream output */
+    inline std::ostream & operator<<( std::ostream & str, const SystemSolvUpdater::Impl & obj )
+    {
+      return str << "SystemSolvUpdater(" << obj._solvfile << ")" << ( obj.valid() ? "" : "[invalid]" )
+                 << " +" << obj._installed << " -" << obj._erased.size();
+    }
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : SystemSolvUpdater
+    //
+    ///////////////////////////////////////////////////////////////////
+
+    SystemSolvUpdater::SystemSolvUpdater( const Pathname & solvfile_r )
+    : _pimpl( new Impl( solvfile_r ) )
+    {}
+
+    SystemSolvUpdater::~SystemSolvUpdater()
+    {}
+
+    bool SystemSolvUpdater::valid() const
+    { return _pimpl->valid(); }
+
+    void SystemSolvUpdater::invalidate()
+    { _pimpl->invalidate(); }
+
+    void SystemSolvUpdater::installed( const Pathname & rpm_r, sat::Solvable solv_r )
+    { _pimpl->installed( rpm_r, solv_r ); }
+
+    void SystemSolvUpdater::removed( sat::Solvable solv_r )
+    { _pimpl->removed( solv_r ); }
+
+    void SystemSolvUpdater::transactionDone( const RepoStatus & rpmdbStatus_r )
+    { _pimpl->_rpmdbStatus = rpmdbStatus_r; }
+
+    const RepoStatus & SystemSolvUpdater::rpmdbStatus() const
+    { return _pimpl->_rpmdbStatus; }
+
+    bool SystemSolvUpdater::write()
+    { return _pimpl->write(); }
+
+    std::ostream & operator<<( std::ostream & str, const SystemSolvUpdater & obj )
+    { return str << *obj._pimpl; }
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace target
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,108 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/target/SystemSolvUpdater.h
+ *
+*/
+#ifndef ZYPP_TARGET_SYSTEMSOLVUPDATER_H
+#define ZYPP_TARGET_SYSTEMSOLVUPDATER_H
+
+#include <iosfwd>
+
+#include "zypp/base/PtrTypes.h"
+#include "zypp/base/NonCopyable.h"
+
+#include "zypp/Pathname.h"
+#include "zypp/RepoStatus.h"
+#include "zypp/sat/Solvable.h"
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace target
+  { /////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : SystemSolvUpdater
+    //
+    /** Update the \c @System solv file by the packages installed and
+     * removed during commit, instead of rerunning \c rpmdb2solv.
+     *
+     * The solv file is loaded into a private libsolv pool, so the
+     * \ref sat::Pool is not affected. Installed packages are added by
+     * reading the headers of their rpm files, completed by the install time
+     * and database index of the installed header (like \c rpmdb2solv does).
+     * Removed ones are looked up by name, edition and architecture.
+     *
+     * If something is reported which can not be tracked, the updater
+     * is \ref invalidate d, and the caller should rebuild the solv file
+     * from the rpm database.
+     */
+    class SystemSolvUpdater : private base::NonCopyable
+    {
+      friend std::ostream & operator<<( std::ostream & str, const SystemSolvUpdater & obj );
+
+      public:
+        /** Ctor loading the current \a solvfile_r. */
+        SystemSolvUpdater( const Pathname & solvfile_r );
+
+        /** Dtor */
+        ~SystemSolvUpdater();
+
+      public:
+        /** Whether the solv file can still be updated. */
+        bool valid() const;
+
+        /** Give up updating (e.g. on an error during commit). */
+        void invalidate();
+
+        /** Package \a solv_r was installed from \a rpm_r.
+         * The installed header must be in the rpm database already.
+         */
+        void installed( const Pathname & rpm_r, sat::Solvable solv_r );
+
+        /** Installed package \a solv_r was removed (or replaced by an install). */
+        void removed( sat::Solvable solv_r );
+
+        /** Remember the rpm database status right after the transaction.
+         * This is what the updated solv file matches. Later changes (e.g.
+         * by update scripts) must make the cookie outdated.
+         */
+        void transactionDone( const RepoStatus & rpmdbStatus_r );
+
+        /** The rpm database status remembered by \ref transactionDone
+         * (empty if not yet done).
+         */
+        const RepoStatus & rpmdbStatus() const;
+
+        /** Write the updated solv file.
+         * \return Whether the file was written. If not, the
+         * original file is left untouched.
+         */
+        bool write();
+
+      public:
+        class Impl;
+      private:
+        /** Pointer to implementation */
+        scoped_ptr<Impl> _pimpl;
+    };
+    ///////////////////////////////////////////////////////////////////
+
+    /** \relates SystemSolvUpdater Stream output */
+    std::ostream & operator<<( std::ostream & str, const SystemSolvUpdater & obj );
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace target
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_TARGET_SYSTEMSOLVUPDATER_H
@@ -15,9 +15,18 @@
 #include <string>
 #include <list>
 #include <set>
+#include <tr1/unordered_map>
 
 #include <sys/types.h>
 #include <dirent.h>
+#include <cstring>
+
+extern "C"
+{
+#include <solv/pool.h>
+#include <solv/repo.h>
+#include <solv/repo_solv.h>
+}
 
 #include "zypp/base/LogTools.h"
 #include "zypp/base/Exception.h"
@@ -26,6 +35,7 @@
 #include "zypp/base/IOStream.h"
 #include "zypp/base/Functional.h"
 #include "zypp/base/UserRequestException.h"
+#include "zypp/base/Trace.h"
 
 #include "zypp/ZConfig.h"
 #include "zypp/ZYppFactory.h"
@@ -34,6 +44,7 @@
 #include "zypp/ResObjects.h"
 #include "zypp/Url.h"
 #include "zypp/TmpPath.h"
+#include "zypp/AutoDispose.h"
 #include "zypp/RepoStatus.h"
 #include "zypp/ExternalProgram.h"
 #include "zypp/Repository.h"
@@ -603,6 +614,31 @@ namespace zypp
         sendNotification( root_r, result_r.updateMessages() );
       }
 
+      /** Notify plugins about a changed package set.
+       * \note quick hack looking for spacewalk plugin only
+       */
+      void sendPackageSetChanged( const Pathname & root_r )
+      {
+        Pathname script( Pathname::assertprefix( root_r, ZConfig::instance().pluginsPath()/"system/spacewalk" ) );
+        if ( PathInfo( script ).isX() )
+          try {
+            PluginScript spacewalk( script );
+            spacewalk.open();
+
+            PluginFrame notify( "PACKAGESETCHANGED" );
+            spacewalk.send( notify );
+
+            PluginFrame ret( spacewalk.receive() );
+            MIL << ret << endl;
+            if ( ret.command() == "ERROR" )
+              ret.writeTo( WAR ) << endl;
+          }
+          catch ( const Exception & excpt )
+          {
+            WAR << excpt.asUserHistory() << endl;
+          }
+      }
+
       /////////////////////////////////////////////////////////////////
     } // namespace
     ///////////////////////////////////////////////////////////////////
@@ -833,6 +869,11 @@ namespace zypp
       filesystem::recursive_rmdir( base );
     }
 
+    RepoStatus TargetImpl::rpmdbStatus() const
+    {
+      return RepoStatus( _root/"/var/lib/rpm/Name" ) && (_root/"/etc/products.d");
+    }
+
     bool TargetImpl::buildCache()
     {
       Pathname base = solvfilesPath();
@@ -842,8 +883,7 @@ namespace zypp
       bool build_rpm_solv = true;
       // lets see if the rpm solv cache exists
 
-      RepoStatus rpmstatus( RepoStatus( _root/"/var/lib/rpm/Name" )
-                            && (_root/"/etc/products.d") );
+      RepoStatus rpmstatus( rpmdbStatus() );
 
       bool solvexisted = PathInfo(rpmsolv).isExist();
       if ( solvexisted )
@@ -951,29 +991,34 @@ namespace zypp
         guard.resetDispose();
 
 	// Finally send notification to plugins
-	// NOTE: quick hack looking for spacewalk plugin only
-	{
-	  Pathname script( Pathname::assertprefix( _root, ZConfig::instance().pluginsPath()/"system/spacewalk" ) );
-	  if ( PathInfo( script ).isX() )
-	    try {
-	      PluginScript spacewalk( script );
-	      spacewalk.open();
+	sendPackageSetChanged( _root );
+      }
+      return build_rpm_solv;
+    }
 
-	      PluginFrame notify( "PACKAGESETCHANGED" );
-	      spacewalk.send( notify );
+    bool TargetImpl::updateCache( SystemSolvUpdater & updater_r, const std::string & productsStatus_r )
+    {
+      if ( ! updater_r.valid() || updater_r.rpmdbStatus().empty() )
+        return false;
 
-	      PluginFrame ret( spacewalk.receive() );
-	      MIL << ret << endl;
-	      if ( ret.command() == "ERROR" )
-		ret.writeTo( WAR ) << endl;
-	    }
-	    catch ( const Exception & excpt )
-	    {
-	      WAR << excpt.asUserHistory() << endl;
-	    }
-	}
+      if ( RepoStatus( _root/"/etc/products.d" ).checksum() != productsStatus_r )
+      {
+        MIL << "products.d changed; rebuilding the solv file." << endl;
+        return false;
       }
-      return build_rpm_solv;
+
+      debug::TraceSpan span( "TargetImpl::updateCache", "target" );
+      Pathname base = solvfilesPath();
+      if ( ! updater_r.write() )
+        return false;
+      // The status right after the transaction, not the current one: if
+      // update scripts changed the rpmdb meanwhile, the solv file is rebuilt
+      // on the next load.
+      updater_r.rpmdbStatus().saveToCookieFile( base/"cookie" );
+      MIL << updater_r << endl;
+
+      sendPackageSetChanged( _root );
+      return true;
     }
 
     void TargetImpl::reload()
@@ -1082,6 +1127,7 @@ namespace zypp
     {
       // ----------------------------------------------------------------- //
       ZYppCommitPolicy policy_r( policy_rX );
+      debug::TraceSpan span( "TargetImpl::commit", "target" );
 
       // Fake outstanding YCP fix: Honour restriction to media 1
       // at installation, but install all remaining packages if post-boot.
@@ -1157,6 +1203,8 @@ namespace zypp
       // Compute transaction:
       ///////////////////////////////////////////////////////////////////
       ZYppCommitResult result( root() );
+      scoped_ptr<SystemSolvUpdater> solvUpdater;
+      std::string productsStatus;
       result.rTransaction() = pool_r.resolver().getTransaction();
       result.rTransaction().order();
       // steps: this is our todo-list
@@ -1305,7 +1353,16 @@ namespace zypp
         }
         else if ( ! policy_r.dryRun() )
         {
-          commit( policy_r, packageCache, result );
+          // If the solv file is up to date, we update it by the changes
+          // done. Otherwise it's rebuilt from the rpmdb afterwards.
+          Pathname base = solvfilesPath();
+          if ( PathInfo( base/"solv" ).isFile()
+               && RepoStatus::fromCookieFile( base/"cookie" ).checksum() == rpmdbStatus().checksum() )
+          {
+            solvUpdater.reset( new SystemSolvUpdater( base/"solv" ) );
+            productsStatus = RepoStatus( _root/"/etc/products.d" ).checksum();
+          }
+          commit( policy_r, packageCache, result, solvUpdater.get() );
         }
         else
         {
@@ -1318,11 +1375,12 @@ namespace zypp
       }
 
       ///////////////////////////////////////////////////////////////////
-      // Try to rebuild solv file while rpm database is still in cache
+      // Try to update or rebuild solv file while rpm database is still in cache
       ///////////////////////////////////////////////////////////////////
       if ( ! policy_r.dryRun() )
       {
-        buildCache();
+        if ( ! ( solvUpdater && updateCache( *solvUpdater, productsStatus ) ) )
+          buildCache();
       }
 
       // for DEPRECATED old ZyppCommitResult results:
@@ -1378,7 +1436,8 @@ namespace zypp
     ///////////////////////////////////////////////////////////////////
     void TargetImpl::commit( const ZYppCommitPolicy & policy_r,
 			     CommitPackageCache & packageCache_r,
-			     ZYppCommitResult & result_r )
+			     ZYppCommitResult & result_r,
+			     SystemSolvUpdater * solvUpdater_r )
     {
       // steps: this is our todo-list
       ZYppCommitResult::TransactionStepList & steps( result_r.rTransactionStepList() );
@@ -1398,6 +1457,8 @@ namespace zypp
 	    // for packages this means being obsoleted (by rpm)
 	    // thius no additional action is needed.
 	    step->stepStage( sat::Transaction::STEP_DONE );
+	    if ( solvUpdater_r && citem.satSolvable().isSystem() )
+	      solvUpdater_r->removed( citem.satSolvable() );
 	    continue;
 	  }
 	}
@@ -1508,6 +1569,8 @@ namespace zypp
               citem.status().resetTransact( ResStatus::USER );
               successfullyInstalledPackages.push_back( citem.satSolvable() );
 	      step->stepStage( sat::Transaction::STEP_DONE );
+              if ( solvUpdater_r )
+                solvUpdater_r->installed( localfile, citem.satSolvable() );
             }
           }
           else
@@ -1555,6 +1618,8 @@ namespace zypp
             {
               citem.status().resetTransact( ResStatus::USER );
 	      step->stepStage( sat::Transaction::STEP_DONE );
+              if ( solvUpdater_r )
+                solvUpdater_r->removed( citem.satSolvable() );
             }
           }
         }
@@ -1605,6 +1670,22 @@ namespace zypp
 
       } // for
 
+      // The solv file can be updated only if all steps were done.
+      if ( solvUpdater_r )
+      {
+        for_( step, steps.begin(), steps.end() )
+        {
+          if ( step->stepStage() == sat::Transaction::STEP_ERROR
+               || ( step->stepStage() == sat::Transaction::STEP_TODO && step->satSolvable().isKind<Package>() ) )
+          {
+            solvUpdater_r->invalidate();
+            break;
+          }
+        }
+        if ( solvUpdater_r->valid() )
+          solvUpdater_r->transactionDone( rpmdbStatus() );
+      }
+
       // Check presence of update scripts/messages. If aborting,
       // at least log omitted scripts.
       if ( ! successfullyInstalledPackages.empty() )
@@ -1635,9 +1716,192 @@ namespace zypp
       return _rpm;
     }
 
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : TargetImpl::FileOwnerIndex
+    //
+    /** Installed files and the names of the packages owning them.
+     * Built from the filelist in the targets \c @System solv cache, which
+     * is read into a private pool. Files are stored as (dirname,basename)
+     * ids of this pool, so the strings are shared.
+    */
+    class TargetImpl::FileOwnerIndex : private base::NonCopyable
+    {
+      public:
+        FileOwnerIndex( const Pathname & solvfile_r )
+        : _pool( ::pool_create() )
+        , _valid( false )
+        {
+          debug::TraceSpan span( "TargetImpl::FileOwnerIndex", "target" );
+          AutoDispose<FILE*> file( ::fopen( solvfile_r.c_str(), "re" ), ::fclose );
+          if ( file == NULL )
+          {
+            file.resetDispose();
+            WAR << "Can't open " << solvfile_r << endl;
+            return;
+          }
+          ::_Repo * repo = ::repo_create( _pool, "@System" );
+          if ( ::repo_add_solv( repo, file, 0 ) != 0 )
+          {
+            WAR << "Can't read " << solvfile_r << endl;
+            return;
+          }
+
+          ::Dataiterator di;
+          ::dataiterator_init( &di, _pool, repo, 0, SOLVABLE_FILELIST, 0, SEARCH_FILES );
+          while ( ::dataiterator_step( &di ) )
+          {
+            Key key( makeKey( di.kv.str, /*create*/true ) );
+            ::Id name = _pool->solvables[di.solvid].name;
+            std::pair<Index::iterator,bool> res( _index.insert( std::make_pair( key, name ) ) );
+            if ( ! res.second && res.first->second != name )
+            {
+              // more than one owner
+              std::vector< ::Id> & owners( _moreOwners[key] );
+              if ( owners.empty() )
+                owners.push_back( res.first->second );
+              if ( owners.back() != name )
+                owners.push_back( name );
+            }
+          }
+          ::dataiterator_free( &di );
+          _valid = true;
+
+          span.attr( "files", (long long)_index.size() );
+          MIL << "FileOwnerIndex for " << solvfile_r << ": " << _index.size() << " files, "
+              << _moreOwners.size() << " with more than one owner" << endl;
+        }
+
+        ~FileOwnerIndex()
+        { ::pool_free( _pool ); }
+
+        /** Whether the solv file was read. */
+        bool valid() const
+        { return _valid; }
+
+        /** Names of the owners of \a path_r (empty if not owned). */
+        std::vector<std::string> owners( const std::string & path_r ) const
+        {
+          std::vector<std::string> ret;
+          Key key( makeKey( path_r.c_str(), /*create*/false ) );
+          if ( ! key )
+            return ret;
+          Index::const_iterator it( _index.find( key ) );
+          if ( it == _index.end() )
+            return ret;
+          MoreOwners::const_iterator mit( _moreOwners.find( key ) );
+          if ( mit == _moreOwners.end() )
+            ret.push_back( ::pool_id2str( _pool, it->second ) );
+          else
+            for_( oit, mit->second.begin(), mit->second.end() )
+              ret.push_back( ::pool_id2str( _pool, *oit ) );
+          return ret;
+        }
+
+      private:
+        /** (dirname,basename) ids, \c 0 if not in the pool. */
+        typedef unsigned long long Key;
+
+        Key makeKey( const char * path_r, bool create_r ) const
+        {
+          const char * base = ::strrchr( path_r, '/' );
+          if ( ! base )
+            return 0;
+          ::Id dir = ::pool_strn2id( _pool, path_r, base - path_r, create_r );
+          ::Id name = ::pool_str2id( _pool, base + 1, create_r );
+          if ( ! dir || ! name )
+            return 0;
+          return ( Key(dir) << 32 ) | Key(name);
+        }
+
+      private:
+        typedef std::tr1::unordered_map<Key, ::Id> Index;
+        typedef std::tr1::unordered_map<Key, std::vector< ::Id> > MoreOwners;
+        ::_Pool *  _pool;
+        bool       _valid;
+        Index      _index;		//!< file and (first) owner
+        MoreOwners _moreOwners;	//!< all owners of files owned by more than one package
+    };
+    ///////////////////////////////////////////////////////////////////
+
+    const TargetImpl::FileOwnerIndex * TargetImpl::fileOwnerIndex() const
+    {
+      Pathname base( solvfilesPath() );
+      PathInfo solv( base/"solv" );
+      if ( ! solv.isFile() )
+      {
+        _fileOwnerIndexStamp.clear();
+        _fileOwnerIndex.reset();
+        return 0;
+      }
+
+      // Cheap check first: neither the rpmdb nor the solv cache were touched
+      // since we last looked. Otherwise compare the cookie (checksums the rpmdb).
+      PathInfo rpmdb( _root/"/var/lib/rpm/Name" );
+      std::string stamp( str::form( "%s %ld %lld %ld %lld", base.c_str(),
+                                    (long)rpmdb.mtime(), (long long)rpmdb.size(),
+                                    (long)solv.mtime(), (long long)solv.size() ) );
+      if ( stamp == _fileOwnerIndexStamp )
+        return _fileOwnerIndex.get();	// NULL if known to be outdated
+
+      _fileOwnerIndexStamp = stamp;
+      _fileOwnerIndex.reset();
+      if ( RepoStatus::fromCookieFile( base/"cookie" ).checksum() != rpmdbStatus().checksum() )
+      {
+        MIL << "rpmdb changed since " << solv.path() << " was written; not using the file owner index." << endl;
+        return 0;
+      }
+
+      _fileOwnerIndex.reset( new FileOwnerIndex( solv.path() ) );
+      if ( ! _fileOwnerIndex->valid() )
+        _fileOwnerIndex.reset();
+      return _fileOwnerIndex.get();
+    }
+
     bool TargetImpl::providesFile (const std::string & path_str, const std::string & name_str) const
     {
-      return _rpm.hasFile(path_str, name_str);
+      const FileOwnerIndex * index( fileOwnerIndex() );
+      if ( ! index )
+        return _rpm.hasFile(path_str, name_str);
+
+      std::vector<std::string> owners( index->owners( path_str ) );
+      if ( owners.empty() )
+        return false;
+      if ( name_str.empty() )
+        return true;
+      // like RpmDb::hasFile: all owners must be name_str
+      for_( it, owners.begin(), owners.end() )
+      {
+        if ( *it != name_str )
+          return false;
+      }
+      return true;
+    }
+
+    std::string TargetImpl::whoOwnsFile (const std::string & path_str) const
+    {
+      const FileOwnerIndex * index( fileOwnerIndex() );
+      if ( ! index )
+        return _rpm.whoOwnsFile (path_str);
+
+      std::vector<std::string> owners( index->owners( path_str ) );
+      return( owners.empty() ? std::string() : owners.front() );
+    }
+
+    std::vector<std::string> TargetImpl::whoOwnsFiles( const std::vector<std::string> & paths_r ) const
+    {
+      const FileOwnerIndex * index( fileOwnerIndex() );
+      if ( ! index )
+        return _rpm.whoOwnsFiles( paths_r );
+
+      std::vector<std::string> ret;
+      ret.reserve( paths_r.size() );
+      for_( it, paths_r.begin(), paths_r.end() )
+      {
+        std::vector<std::string> owners( index->owners( *it ) );
+        ret.push_back( owners.empty() ? std::string() : owners.front() );
+      }
+      return ret;
     }
 
 
@@ -14,6 +14,7 @@
 
 #include <iosfwd>
 #include <set>
+#include <vector>
 
 #include "zypp/base/ReferenceCounted.h"
 #include "zypp/base/NonCopyable.h"
@@ -22,6 +23,7 @@
 #include "zypp/ZYppCommit.h"
 
 #include "zypp/Pathname.h"
+#include "zypp/RepoStatus.h"
 #include "zypp/media/MediaAccess.h"
 #include "zypp/Target.h"
 #include "zypp/target/rpm/RpmDb.h"
@@ -29,6 +31,7 @@
 #include "zypp/target/RequestedLocalesFile.h"
 #include "zypp/target/SoftLocksFile.h"
 #include "zypp/target/HardLocksFile.h"
+#include "zypp/target/SystemSolvUpdater.h"
 #include "zypp/ManagedFile.h"
 
 ///////////////////////////////////////////////////////////////////
@@ -101,6 +104,11 @@ namespace zypp
 
       Pathname _tmpSolvfilesPath;
 
+      /** The rpmdb status the \c @System solv file is built for.
+       * This is what's stored in the solv files cookie.
+       */
+      RepoStatus rpmdbStatus() const;
+
     public:
       void load( bool force = true );
 
@@ -113,6 +121,24 @@ namespace zypp
       bool buildCache();
       //@}
 
+    private:
+      /** \name Index of installed files and their owners.
+       * Built from the filelist in the targets \c @System solv cache
+       * (\ref solvfilesPath), not from whatever \c @System repo is loaded.
+       * It's used as long as the cookie written with the solv file matches
+       * the rpmdb. Otherwise queries are passed to the rpmdb.
+       */
+      //@{
+      class FileOwnerIndex;
+
+      /** The index for the current solv cache or \c NULL if not available or outdated. */
+      const FileOwnerIndex * fileOwnerIndex() const;
+
+      /** Solv cache path, rpmdb and solv file (mtime,size) when the index was last checked. */
+      mutable std::string _fileOwnerIndexStamp;
+      mutable shared_ptr<FileOwnerIndex> _fileOwnerIndex;
+      //@}
+
     public:
 
       /** The root set for this target */
@@ -150,8 +176,10 @@ namespace zypp
 
       /** Return name of package owning \a path_str
        * or empty string if no installed package owns \a path_str. */
-      std::string whoOwnsFile (const std::string & path_str) const
-      { return _rpm.whoOwnsFile (path_str); }
+      std::string whoOwnsFile (const std::string & path_str) const;
+
+      /** \copydoc Target::whoOwnsFiles() */
+      std::vector<std::string> whoOwnsFiles( const std::vector<std::string> & paths_r ) const;
 
       /** return the last modification date of the target */
       Date timestamp() const;
@@ -199,7 +227,13 @@ namespace zypp
       /** Commit ordered changes (internal helper) */
       void commit( const ZYppCommitPolicy & policy_r,
 		   CommitPackageCache & packageCache_r,
-		   ZYppCommitResult & result_r );
+		   ZYppCommitResult & result_r,
+		   SystemSolvUpdater * solvUpdater_r );
+
+      /** Update the solv file by the changes done in commit (instead of \ref buildCache).
+       * \return Whether the solv file was updated. If not, it must be rebuilt.
+       */
+      bool updateCache( SystemSolvUpdater & updater_r, const std::string & productsStatus_r );
 
     protected:
       /** Path to the target */
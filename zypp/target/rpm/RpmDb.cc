@@ -30,6 +30,7 @@
 #include "zypp/base/Logger.h"
 #include "zypp/base/String.h"
 #include "zypp/base/Gettext.h"
+#include "zypp/base/Trace.h"
 
 #include "zypp/Date.h"
 #include "zypp/Pathname.h"
@@ -770,6 +771,7 @@ void RpmDb::doRebuildDatabase(callback::SendReport<RebuildDBReport> & report)
   FAILIFNOTINITIALIZED;
 
   MIL << "RpmDb::rebuildDatabase" << *this << endl;
+  debug::TraceSpan span( "RpmDb::rebuildDatabase", "rpm" );
   // FIXME  Timecount _t( "RpmDb::rebuildDatabase" );
 
   PathInfo dbMaster( root() + dbPath() + "Packages" );
@@ -1195,6 +1197,26 @@ string RpmDb::whoOwnsFile( const string & file_r) const
   return "";
 }
 
+///////////////////////////////////////////////////////////////////
+//
+//
+//	METHOD NAME : RpmDb::whoOwnsFiles
+//	METHOD TYPE : std::vector<std::string>
+//
+//	DESCRIPTION :
+//
+std::vector<std::string> RpmDb::whoOwnsFiles( const std::vector<std::string> & files_r ) const
+{
+  std::vector<std::string> ret;
+  ret.reserve( files_r.size() );
+  librpmDb::db_const_iterator it;
+  for_( file, files_r.begin(), files_r.end() )
+  {
+    ret.push_back( it.findByFile( *file ) ? it->tag_name() : std::string() );
+  }
+  return ret;
+}
+
 ///////////////////////////////////////////////////////////////////
 //
 //
@@ -1706,6 +1728,8 @@ void RpmDb::doInstallPackage( const Pathname & filename, RpmInstFlags flags, cal
   HistoryLog historylog;
 
   MIL << "RpmDb::installPackage(" << filename << "," << flags << ")" << endl;
+  debug::TraceSpan span( "RpmDb::installPackage", "rpm" );
+  span.attr( "file", filename.basename() );
 
 
   // backup
@@ -1893,6 +1917,8 @@ void RpmDb::doRemovePackage( const string & name_r, RpmInstFlags flags, callback
   HistoryLog historylog;
 
   MIL << "RpmDb::doRemovePackage(" << name_r << "," << flags << ")" << endl;
+  debug::TraceSpan span( "RpmDb::removePackage", "rpm" );
+  span.attr( "package", name_r );
 
   // backup
   if ( _packagebackups )
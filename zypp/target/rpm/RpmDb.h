@@ -268,6 +268,14 @@ public:
    **/
   std::string whoOwnsFile( const std::string & file_r ) const;
 
+  /**
+   * Return names of the packages owning \a files_r (in order)
+   * or empty strings for files not owned by an installed package.
+   * Same as calling \ref whoOwnsFile for each file, but using just
+   * one database iterator.
+   **/
+  std::vector<std::string> whoOwnsFiles( const std::vector<std::string> & files_r ) const;
+
   /**
    * Return true if at least one package provides a certain tag.
    **/
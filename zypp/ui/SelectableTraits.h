@@ -18,6 +18,7 @@
 #include "zypp/base/Iterator.h"
 #include "zypp/PoolItem.h"
 #include "zypp/pool/ByIdent.h"
+#include "zypp/sat/Pool.h"
 
 ///////////////////////////////////////////////////////////////////
 namespace zypp
@@ -61,7 +62,8 @@ namespace zypp
               return res > 0;
           }
 
-          int res = lhs->edition().compare( rhs->edition() );
+          // ranked edition compare (avoids parsing the strings)
+          int res = sat::Pool::instance().compareEdition( lhs->edition(), rhs->edition() );
           if ( res )
             return res > 0;
 
@@ -92,7 +94,7 @@ namespace zypp
           int res = lhs->arch().compare( rhs->arch() );
           if ( res )
             return res > 0;
-          res = lhs->edition().compare( rhs->edition() );
+          res = sat::Pool::instance().compareEdition( lhs->edition(), rhs->edition() );
           if ( res )
             return res > 0;
           Date ldate = lhs->installtime();
@@ -13,9 +13,13 @@
 #include "zypp/base/String.h"
 #include "zypp/base/Gettext.h"
 #include "zypp/base/Regex.h"
+#include "zypp/thread/Mutex.h"
+#include "zypp/thread/MutexLock.h"
 
 #include <stdexcept>
 #include <climits>
+#include <cstring>
+#include <map>
 #include <errno.h>
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -33,17 +37,25 @@
 **
 ** host      = hostname | IPv4 | "[" IPv6-IP "]" | "[v...]"
 */
-#define RX_VALID_SCHEME    "^[" a_zA_Z "][" a_zA_Z "0-9\\.+-]*$"
-
-#define RX_VALID_PORT      "^[0-9]{1,5}$"
-
 #define RX_VALID_HOSTNAME  "^[[:alnum:]]+([\\.-][[:alnum:]]+)*$"
 
-#define RX_VALID_HOSTIPV4  \
-        "^([0-9]{1,3})\\.([0-9]{1,3})\\.([0-9]{1,3})\\.([0-9]{1,3})$"
+/*
+** Default component patterns: characters of a set or %-encoded.
+** The RX_* patterns are checked without regex by the chars in
+** the corresponding CHARS_* set (see matchesRx).
+*/
+#define RX_ENCODED(chars)  "^([" a_zA_Z "0-9" chars "]|%[a-fA-F0-9]{2})+$"
 
-#define RX_VALID_HOSTIPV6  \
-        "^\\[[:a-fA-F0-9]+(:[0-9]{1,3}(\\.[0-9]{1,3}){3})?\\]$"
+#define RX_USERNAME        RX_ENCODED("!$&'\\(\\)*+=,;~\\._-")
+#define CHARS_USERNAME     "!$&'()*+=,;~._-"
+#define RX_PASSWORD        RX_ENCODED("!$&'\\(\\)*+=,:;~\\._-")
+#define CHARS_PASSWORD     "!$&'()*+=,:;~._-"
+#define RX_PATHNAME        RX_ENCODED("!$&'\\(\\)*+=,:@/~\\._-")
+#define CHARS_PATHNAME     "!$&'()*+=,:@/~._-"
+#define RX_PATHPARAMS      RX_ENCODED("!$&'\\(\\)*+=,:;@/~\\._-")
+#define CHARS_PATHPARAMS   "!$&'()*+=,:;@/~._-"
+#define RX_QUERYSTR        RX_ENCODED("!$&'\\(\\)*+=,:;@/?~\\._-")
+#define CHARS_QUERYSTR     "!$&'()*+=,:;@/?~._-"
 
 
 //////////////////////////////////////////////////////////////////////
@@ -141,6 +153,74 @@ namespace zypp
     namespace // anonymous
     {
 
+      // -------------------------------------------------------------
+      // Character classes; explicit ASCII, independent of the locale.
+      inline bool isAsciiAlpha(char c)
+      { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+
+      inline bool isAsciiDigit(char c)
+      { return c >= '0' && c <= '9'; }
+
+      inline bool isAsciiAlnum(char c)
+      { return isAsciiAlpha(c) || isAsciiDigit(c); }
+
+      inline bool isHexDigit(char c)
+      { return isAsciiDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'); }
+
+      // -------------------------------------------------------------
+      // Whether data matches RX_ENCODED(chars).
+      bool matchesEncoded(const std::string &data, const char *chars)
+      {
+        if( data.empty())
+          return false;
+        for( std::string::size_type i = 0; i < data.size(); ++i)
+        {
+          char c = data[i];
+          if( isAsciiAlnum(c) || (c && ::strchr(chars, c)))
+            continue;
+          if( c == '%' && i+2 < data.size() && isHexDigit(data[i+1]) && isHexDigit(data[i+2]))
+          {
+            i += 2;
+            continue;
+          }
+          return false;
+        }
+        return true;
+      }
+
+      // -------------------------------------------------------------
+      // Whether data matches the regex regx. The default patterns are
+      // checked by hand, others are compiled once and remembered.
+      bool matchesRx(const std::string &data, const std::string &regx)
+      {
+        static const struct { const char *rx; const char *chars; } encoded[] = {
+          { RX_USERNAME,   CHARS_USERNAME },
+          { RX_PASSWORD,   CHARS_PASSWORD },
+          { RX_PATHNAME,   CHARS_PATHNAME },
+          { RX_PATHPARAMS, CHARS_PATHPARAMS },
+          { RX_QUERYSTR,   CHARS_QUERYSTR },
+        };
+        for( unsigned i = 0; i < sizeof(encoded)/sizeof(*encoded); ++i)
+        {
+          if( regx == encoded[i].rx)
+            return matchesEncoded(data, encoded[i].chars);
+        }
+
+        // Urls may be checked by concurrent threads; matching a
+        // compiled regex is thread safe, the cache is not.
+        static thread::Mutex compiledMutex;
+        static std::map<std::string, shared_ptr<str::regex> > compiled;
+        shared_ptr<str::regex> rex;
+        {
+          thread::MutexLock lock(compiledMutex);
+          shared_ptr<str::regex> & cached( compiled[regx]);
+          if( !cached)
+            cached.reset(new str::regex(regx));
+          rex = cached;
+        }
+        return str::regex_match(data, *rex);
+      }
+
 			// -------------------------------------------------------------
       inline void
       checkUrlData(const std::string &data,
@@ -159,8 +239,7 @@ namespace zypp
           bool valid = false;
           try
           {
-            str::regex rex(regx);
-            valid = str::regex_match(data, rex);
+            valid = matchesRx(data, regx);
           }
           catch( ... )
           {}
@@ -273,14 +352,14 @@ namespace zypp
       // n=no  (don't encode 2. slash if authority present)
       config("path_encode_slash2", "n");
 
-      config("rx_username",     "^([" a_zA_Z "0-9!$&'\\(\\)*+=,;~\\._-]|%[a-fA-F0-9]{2})+$");
-      config("rx_password",     "^([" a_zA_Z "0-9!$&'\\(\\)*+=,:;~\\._-]|%[a-fA-F0-9]{2})+$");
+      config("rx_username",     RX_USERNAME);
+      config("rx_password",     RX_PASSWORD);
 
-      config("rx_pathname",     "^([" a_zA_Z "0-9!$&'\\(\\)*+=,:@/~\\._-]|%[a-fA-F0-9]{2})+$");
-      config("rx_pathparams",   "^([" a_zA_Z "0-9!$&'\\(\\)*+=,:;@/~\\._-]|%[a-fA-F0-9]{2})+$");
+      config("rx_pathname",     RX_PATHNAME);
+      config("rx_pathparams",   RX_PATHPARAMS);
 
-      config("rx_querystr",     "^([" a_zA_Z "0-9!$&'\\(\\)*+=,:;@/?~\\._-]|%[a-fA-F0-9]{2})+$");
-      config("rx_fragment",     "^([" a_zA_Z "0-9!$&'\\(\\)*+=,:;@/?~\\._-]|%[a-fA-F0-9]{2})+$");
+      config("rx_querystr",     RX_QUERYSTR);
+      config("rx_fragment",     RX_QUERYSTR);
     }
 
 
@@ -369,14 +448,13 @@ namespace zypp
     bool
     UrlBase::isValidScheme(const std::string &scheme) const
     {
-      bool valid = false;
-      try
+      // [a-zA-Z][a-zA-Z0-9.+-]*
+      bool valid = !scheme.empty() && isAsciiAlpha(scheme[0]);
+      for( std::string::size_type i = 1; valid && i < scheme.size(); ++i)
       {
-        str::regex rex(RX_VALID_SCHEME);
-        valid = str::regex_match(scheme, rex);
+        char c = scheme[i];
+        valid = isAsciiAlnum(c) || c == '.' || c == '+' || c == '-';
       }
-      catch( ... )
-      {}
 
       if(valid)
       {
@@ -1320,27 +1398,41 @@ namespace zypp
     bool
     UrlBase::isValidHost(const std::string &host) const
     {
+      if( host.size() >= 2 && host[0] == '[' && host[host.size()-1] == ']')
+      {
+        // "[" IPv6-IP "]"; "[v...]" is not supported
+        struct in6_addr ip;
+        std::string temp( host.substr(1, host.size()-2));
+
+        return inet_pton(AF_INET6, temp.c_str(), &ip) > 0;
+      }
+
       try
       {
-        str::regex regx(RX_VALID_HOSTIPV6);
-        if( str::regex_match(host, regx))
-        {
-          struct in6_addr ip;
-          std::string temp( host.substr(1, host.size()-2));
+        // matches also IPv4 dotted-decimal adresses...
+        std::string temp( zypp::url::decode(host));
 
-          return inet_pton(AF_INET6, temp.c_str(), &ip) > 0;
+        for( std::string::size_type i = 0; i < temp.size(); ++i)
+        {
+          // [[:alnum:]] of the locale may include non-ASCII letters
+          if( temp[i] & 0x80)
+            return matchesRx(temp, RX_VALID_HOSTNAME);
         }
-        else
+
+        // [[:alnum:]]+([.-][[:alnum:]]+)*
+        bool valid = !temp.empty();
+        for( std::string::size_type i = 0; valid && i < temp.size(); ++i)
         {
-          // matches also IPv4 dotted-decimal adresses...
-          std::string temp( zypp::url::decode(host));
-          str::regex  regx(RX_VALID_HOSTNAME);
-          return str::regex_match(temp, regx);
+          char c = temp[i];
+          if( c == '.' || c == '-')
+            valid = i > 0 && i+1 < temp.size() && isAsciiAlnum(temp[i-1]) && isAsciiAlnum(temp[i+1]);
+          else
+            valid = isAsciiAlnum(c);
         }
+        return valid;
       }
       catch( ... )
       {}
-
       return false;
     }
 
@@ -1349,18 +1441,16 @@ namespace zypp
     bool
     UrlBase::isValidPort(const std::string &port) const
     {
-      try
+      // [0-9]{1,5}
+      if( port.empty() || port.size() > 5)
+        return false;
+      for( std::string::size_type i = 0; i < port.size(); ++i)
       {
-        str::regex regx(RX_VALID_PORT);
-        if( str::regex_match(port, regx))
-        {
-          long pnum = str::strtonum<long>(port);
-          return ( pnum >= 1 && pnum <= USHRT_MAX);
-        }
+        if( !isAsciiDigit(port[i]))
+          return false;
       }
-      catch( ... )
-      {}
-      return false;
+      long pnum = str::strtonum<long>(port);
+      return ( pnum >= 1 && pnum <= USHRT_MAX);
     }
 
 